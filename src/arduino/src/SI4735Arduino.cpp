@@ -136,7 +136,10 @@ bool SI4735Arduino::downloadPatch(const uint8_t *ssb_patch_content, const uint16
  */
 bool SI4735Arduino::downloadCompressedPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_patch_content_size, const uint16_t *cmd_0x15, const int16_t cmd_0x15_size)
 {
-    uint8_t cmd, content;
+    SI4735_TRACE_SCOPE("downloadCompressedPatch");
+    BulkBusPhase bulk(*this);
+
+    uint8_t cmd, frame[8];
     uint16_t command_line = 0;
     // Send patch to the SI4735 device
     for (uint16_t offset = 0; offset < ssb_patch_content_size; offset += 7)
@@ -151,36 +154,40 @@ bool SI4735Arduino::downloadCompressedPatch(const uint8_t *ssb_patch_content, co
                 break;
             }
         }
-        i2c.beginTransmission(deviceAddress);
-        i2c.write(cmd);
+        frame[0] = cmd;
         for (uint16_t i = 0; i < 7; i++)
-        {
-            content = pgm_read_byte_near(ssb_patch_content + (i + offset));
-            i2c.write(content);
-        }
+            frame[i + 1] = pgm_read_byte_near(ssb_patch_content + (i + offset));
+        i2c.beginTransmission(deviceAddress);
+        i2c.write(frame, 8);
         i2c.endTransmission();
-        delayMicroseconds(MIN_DELAY_WAIT_SEND_LOOP); // Need check the minimum value
+        pendingCommand = cmd; // waitToSend sleeps the predicted (calibrated) time of this patch line before polling CTS
+        waitToSend();
         command_line++;
     }
     delayMicroseconds(250);
     return true;
 }
 {
-    uint8_t content;
+    SI4735_TRACE_SCOPE("downloadPatch");
+    BulkBusPhase bulk(*this);
+
+    uint8_t frame[8];
     // Send patch to the SI4735 device
     for (uint16_t offset = 0; offset < ssb_patch_content_size; offset += 8)
     {
-        i2c.beginTransmission(deviceAddress);
         for (uint16_t i = 0; i < 8; i++)
-        {
-            content = pgm_read_byte_near(ssb_patch_content + (i + offset));
-            i2c.write(content);
-        }
+            frame[i] = pgm_read_byte_near(ssb_patch_content + (i + offset));
+        i2c.beginTransmission(deviceAddress);
+        i2c.write(frame, 8);
         i2c.endTransmission();
+        pendingCommand = frame[0]; // PATCH_ARGS or PATCH_DATA
 
         // Testing download performance
         // approach 1 - Faster - less secure (it might crash in some architectures)
-        delayMicroseconds(MIN_DELAY_WAIT_SEND_LOOP); // Need check the minimum value
+        // delayMicroseconds(MIN_DELAY_WAIT_SEND_LOOP); // Need check the minimum value
+
+        // approach 5 - sleeps the predicted (calibrated) time of this patch line, then polls CTS
+        waitToSend();
 
         // approach 2 - More control. A little more secure than approach 1
         /*
@@ -253,28 +260,22 @@ void SI4735Arduino::radioPowerUp(void)
  */
 void SI4735Arduino::powerDown(void)
 {
+    SI4735_TRACE_SCOPE("powerDown");
+
     // Turns the external mute circuit on
     if (audioMuteMcuPin >= 0)
         setHardwareAudioMute(true);
 
+    sendCommand(POWER_DOWN, 0, NULL);
     waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_DOWN);
-    i2c.endTransmission();
-    clock.waitMicroseconds(2500);
 }
 {
     // clock.waitMicroseconds(1000);
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_UP);
-    i2c.write(powerUp.raw[0]); // Content of ARG1
-    i2c.write(powerUp.raw[1]); // COntent of ARG2
-    i2c.endTransmission();
+    sendCommand(POWER_UP, 2, powerUp.raw); // Content of ARG1 and ARG2
     // Delay at least 500 ms between powerup command and first tune command to wait for
     // the oscillator to stabilize if XOSCEN is set and crystal is used as the RCLK.
     waitToSend();
-    clock.wait(maxDelayAfterPowerUp);
+    fixedWait(POWER_UP, maxDelayAfterPowerUp);
 
     // Turns the external mute circuit off
     if (audioMuteMcuPin >= 0)
@@ -7,6 +7,77 @@
 
 #include <si4735-cpp.h>
 
+/**
+ * @ingroup group05
+ *
+ * @brief GPO2/INT line connected to an Arduino digital pin.
+ *
+ * @details The line is asserted when the pin reads LOW. If the pin supports external interrupts,
+ * @details you can also call trigger() from your ISR (FALLING edge) so short pulses are not missed.
+ * @code
+ *   SI4735ArduinoInterruptLine ctsLine(INT_PIN);
+ *   void ctsIsr() { ctsLine.trigger(); }
+ *   .
+ *   attachInterrupt(digitalPinToInterrupt(INT_PIN), ctsIsr, FALLING);
+ *   rx.setup(RESET_PIN, 1, POWER_UP_FM, SI473X_ANALOG_AUDIO, XOSCEN_CRYSTAL, 1); // CTSIEN = 1 and GPO2OEN = 1
+ *   rx.setInterruptLine(&ctsLine);
+ * @endcode
+ * @see SI4735Base::setInterruptLine
+ */
+class SI4735ArduinoInterruptLine : public SI4735InterruptLine
+{
+  public:
+    SI4735ArduinoInterruptLine(uint8_t pin) : pin(pin)
+    {
+      pinMode(pin, INPUT_PULLUP);
+    }
+
+    inline void trigger() { triggered = true; }
+
+    bool wait(uint16_t timeout_us)
+    {
+      unsigned long start = micros();
+      while (!triggered && digitalRead(pin) != LOW)
+      {
+        if ((micros() - start) >= timeout_us)
+          return false;
+      }
+      triggered = false;
+      return true;
+    }
+
+  private:
+    uint8_t pin;
+    volatile bool triggered = false;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2C clock control of an Arduino TwoWire bus (Wire.setClock).
+ *
+ * @code
+ *   SI4735ArduinoBusSpeed<TwoWire> busSpeed(Wire);
+ *   rx.setBusSpeedControl(&busSpeed); // 100 kHz; patch download and RDS FIFO drain at 400 kHz
+ * @endcode
+ * @see SI4735Base::setBusSpeedControl
+ */
+template <typename Wire>
+class SI4735ArduinoBusSpeed : public SI4735BusSpeed
+{
+  public:
+    SI4735ArduinoBusSpeed(Wire &wire) : wire(wire) {}
+
+    bool setSpeed(uint32_t hz)
+    {
+      wire.setClock(hz);
+      return true;
+    }
+
+  private:
+    Wire &wire;
+};
+
 class SI4735Arduino : public SI4735Base
 {
   public:
@@ -66,6 +137,7 @@ class SI4735Arduino : public SI4735Base
       clock.wait(10);
       digitalWrite(resetPin, HIGH);
       clock.wait(10);
+      invalidatePropertyCache(); // The device is back to its default properties
     }
 
     void radioPowerUp(void);
@@ -0,0 +1,213 @@
+//
+// si4735-bench: host CPU cost of the driver hot paths, measured against SI4735Simulator.
+//
+// Usage: si4735-bench [scale]
+//
+// For each operation, prints the rate (ops/s of wall time) and the host CPU time per operation. It also prints the time the
+// operation would take on a real radio (modeled by the simulator), split into bus transfers and the rest (waits for CTS,
+// STC and fixed delays), plus the commands written per operation.
+// The host CPU time includes the simulator; compare runs of the same build machine only.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <si4735.h>
+#include <SI4735Simulator.h>
+
+#define PROGMEM
+typedef uint8_t byte;
+
+namespace full
+{
+#include <patch_init.h>
+}
+
+namespace compressed
+{
+#include <patch_ssb_compressed.h>
+}
+
+#define BENCH_FM_FROM 8750
+#define BENCH_FM_TO 10800
+#define BENCH_AM_FROM 520
+#define BENCH_AM_TO 1710
+#define BENCH_RDS_GAP 90000 // uS between two RDS reads (about one group)
+#define BENCH_FM_CHANNELS ((BENCH_FM_TO - BENCH_FM_FROM) / 10 + 1)
+
+/**
+ * @brief Operation measured by the bench.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t iterations;                                     //!< Operations for scale = 1
+    uint32_t gap;                                            //!< Virtual time (uS) before each operation; not counted
+    void (*setup)(SI4735 &rx, SI4735Simulator &device);      //!< Called once before the first operation
+    void (*operation)(SI4735 &rx, uint32_t i);
+} BenchCase;
+
+static volatile uint32_t sink; // Keeps the decoded values alive
+
+static void setupFm(SI4735 &rx, SI4735Simulator &)
+{
+    rx.setFM(BENCH_FM_FROM, BENCH_FM_TO, 10390, 10);
+}
+
+static void setupRds(SI4735 &rx, SI4735Simulator &)
+{
+    rx.setFM(BENCH_FM_FROM, BENCH_FM_TO, 10390, 10);
+    rx.setRdsConfig(1, 2, 2, 2, 2);
+}
+
+static void setupPatch(SI4735 &rx, SI4735Simulator &)
+{
+    rx.setAM(BENCH_AM_FROM, BENCH_AM_TO, 810, 10);
+}
+
+static void setupSsb(SI4735 &rx, SI4735Simulator &)
+{
+    rx.loadPatch(full::ssb_patch_content, sizeof full::ssb_patch_content, 2);
+}
+
+static void setFrequency(SI4735 &rx, uint32_t i)
+{
+    rx.setFrequency((i & 1) ? 10390 : 9810);
+}
+
+static void seekStationProgress(SI4735 &rx, uint32_t i)
+{
+    rx.seekStationProgress(NULL, (i & 1) ? SEEK_DOWN : SEEK_UP);
+}
+
+static void getCurrentReceivedSignalQuality(SI4735 &rx, uint32_t)
+{
+    rx.getCurrentReceivedSignalQuality();
+    sink = sink + rx.getCurrentRSSI() + rx.getCurrentSNR();
+}
+
+static void scanBand(SI4735 &rx, uint32_t)
+{
+    static si47x_scan_record band[BENCH_FM_CHANNELS];
+
+    sink = sink + rx.scanBand(BENCH_FM_FROM, BENCH_FM_TO, 10, band, BENCH_FM_CHANNELS);
+}
+
+static void getRdsStatus(SI4735 &rx, uint32_t)
+{
+    char *text;
+
+    rx.getRdsStatus();
+    if ((text = rx.getRdsText0A()) != NULL)
+        sink = sink + (uint8_t)text[0];
+    if ((text = rx.getRdsText2A()) != NULL)
+        sink = sink + (uint8_t)text[0];
+    if ((text = rx.getRdsText2B()) != NULL)
+        sink = sink + (uint8_t)text[0];
+}
+
+static void downloadPatch(SI4735 &rx, uint32_t)
+{
+    rx.powerDown();
+    rx.patchPowerUp();
+    sink = sink + rx.downloadPatch(full::ssb_patch_content, sizeof full::ssb_patch_content);
+}
+
+static void downloadCompressedPatch(SI4735 &rx, uint32_t)
+{
+    rx.powerDown();
+    rx.patchPowerUp();
+    sink = sink + rx.downloadCompressedPatch(compressed::ssb_patch_content, sizeof compressed::ssb_patch_content,
+                                             compressed::cmd_0x15, sizeof compressed::cmd_0x15 / sizeof(uint16_t));
+}
+
+static void setAMsetFM(SI4735 &rx, uint32_t i)
+{
+    if (i & 1)
+        rx.setFM(BENCH_FM_FROM, BENCH_FM_TO, 10390, 10);
+    else
+        rx.setAM(BENCH_AM_FROM, BENCH_AM_TO, 810, 10);
+}
+
+static void setSSB(SI4735 &rx, uint32_t i)
+{
+    rx.setSSB(7000, 7300, 7100, 1, (i & 1) ? USB_MODE : LSB_MODE);
+}
+
+static const BenchCase benchCases[] = {
+    {"setFrequency", 50000, 0, setupFm, setFrequency},
+    {"seekStationProgress", 5000, 0, setupFm, seekStationProgress},
+    {"getCurrentReceivedSignalQuality", 200000, 0, setupFm, getCurrentReceivedSignalQuality},
+    {"scanBand (FM band)", 200, 0, setupFm, scanBand},
+    {"getRdsStatus + getRdsText*", 200000, BENCH_RDS_GAP, setupRds, getRdsStatus},
+    {"downloadPatch", 500, 0, setupPatch, downloadPatch},
+    {"downloadCompressedPatch", 500, 0, setupPatch, downloadCompressedPatch},
+    {"setAM / setFM", 10000, 0, setupFm, setAMsetFM},
+    {"setSSB", 10000, 0, setupSsb, setSSB},
+};
+
+/**
+ * @brief Band plan of the bench: a few FM stations (one with RDS) and a few AM stations.
+ */
+static void addStations(SI4735Simulator &device)
+{
+    device.addStation({9810, SIM_BAND_FM, 38, 18, 0, 0, NULL, NULL});
+    device.addStation({10390, SIM_BAND_FM, 45, 25, 0x1234, 10, "SI4735", "Driver benchmark radio text for the 2A group decoder"});
+    device.addStation({10650, SIM_BAND_FM, 30, 15, 0, 0, NULL, NULL});
+    device.addStation({810, SIM_BAND_AM, 50, 20, 0, 0, NULL, NULL});
+    device.addStation({1200, SIM_BAND_AM, 40, 18, 0, 0, NULL, NULL});
+    device.addStation({7100, SIM_BAND_AM, 35, 12, 0, 0, NULL, NULL});
+}
+
+static void run(const BenchCase &bench, uint32_t scale)
+{
+    SI4735VirtualClock clock;
+    SI4735Simulator device(clock);
+    SI4735 rx(device, clock);
+    uint32_t iterations = bench.iterations * scale;
+
+    addStations(device);
+    rx.setup(0, POWER_UP_FM);
+    bench.setup(rx, device);
+
+    uint64_t virtualStart = clock.micros();
+    uint64_t busStart = device.getBusTime();
+    uint32_t commandStart = device.getCommandCount();
+    uint64_t gaps = 0;
+    std::clock_t cpuStart = std::clock();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        if (bench.gap)
+        {
+            clock.advance(bench.gap);
+            gaps += bench.gap;
+        }
+        bench.operation(rx, i);
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double cpu = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    double modeled = (double)(clock.micros() - virtualStart - gaps) / iterations;
+    double bus = (double)(device.getBusTime() - busStart) / iterations;
+    double commands = (double)(device.getCommandCount() - commandStart) / iterations;
+
+    printf("%-34s %8u %12.0f %10.2f %12.1f %12.1f %12.1f %8.1f%s\n", bench.name, iterations, wall > 0 ? iterations / wall : 0,
+           cpu * 1e6 / iterations, modeled, bus, modeled - bus, commands, device.getProtocolErrors() ? "  (protocol errors)" : "");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t scale = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1;
+
+    if (scale == 0)
+        scale = 1;
+    printf("%-34s %8s %12s %10s %12s %12s %12s %8s\n", "operation", "ops", "ops/s", "cpu us/op", "modeled us", "bus us",
+           "wait us", "cmds/op");
+    for (size_t i = 0; i < sizeof benchCases / sizeof benchCases[0]; i++)
+        run(benchCases[i], scale);
+    return 0;
+}
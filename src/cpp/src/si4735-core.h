@@ -0,0 +1,375 @@
+/**
+ * @file si4735-core.h
+ *
+ * @brief Devirtualized, policy-templated variant of the driver core.
+ *
+ * @details SI4735Base talks to the device through the I2C and Clock interfaces: every byte written or read in a hot path
+ * @details (CTS polling, tune, status reads) goes through a virtual call. SI4735Core takes the transport and the clock as
+ * @details template parameters instead, so the compiler sees the concrete types and can inline the whole bus access.
+ * @details It covers the hot-path subset of SI4735Base: power up / down, properties, tune, seek, tune status, RSQ and
+ * @details RDS status, with the same si47x_* response types. The protocol itself (framing, CTS and STCINT polling,
+ * @details latency calibration, command arguments) is SI4735Protocol, the engine SI4735Base runs too; SI4735Core only
+ * @details instantiates it with the concrete types and keeps the state. Use SI4735 (SI4735Base) for everything else;
+ * @details both can be built side by side to compare them.
+ *
+ * @code
+ * SI4735VirtualClock clock;
+ * SI4735Simulator device(clock);
+ * SI4735Core<SI4735Simulator, SI4735VirtualClock> rx(device, clock);
+ *
+ * rx.radioPowerUp(POWER_UP_FM);
+ * rx.setFrequency(10390);
+ * rx.getCurrentReceivedSignalQuality();
+ * printf("%u dBuV\n", rx.getCurrentRSSI());
+ * @endcode
+ *
+ * @details Transport must provide the I2C methods used by the driver (beginTransmission, write(const uint8_t *, size_t),
+ * @details endTransmission, requestFrom and read) and ClockT the Clock methods (wait and waitMicroseconds).
+ * @details Declare the concrete classes final (as SI4735Simulator and SI4735VirtualClock are) so calls through them are not virtual.
+ */
+
+#ifndef _SI4735_CORE_H
+#define _SI4735_CORE_H
+
+#include "si4735-cpp.h"
+
+/** @defgroup group22 Devirtualized core */
+
+/**
+ * @ingroup group22
+ *
+ * @brief Hot-path subset of SI4735Base with the transport and the clock as template parameters.
+ *
+ * @tparam Transport I2C transport (concrete type, e.g. SI4735Simulator or an I2C implementation declared final).
+ * @tparam ClockT clock (concrete type, e.g. SI4735VirtualClock).
+ */
+template <typename Transport, typename ClockT>
+class SI4735Core
+{
+    typedef SI4735Protocol<Transport, ClockT> Protocol;
+
+public:
+    SI4735Core(Transport &bus, ClockT &clock, int16_t address = SI473X_ADDR_SEN_LOW) : bus(bus), clock(clock), deviceAddress(address)
+    {
+        currentStatus.raw[0] = 0;
+        resetCommandLatency();
+    }
+
+    /**
+     * @brief Sets the I2C bus address of the device (SI473X_ADDR_SEN_LOW or SI473X_ADDR_SEN_HIGH).
+     */
+    inline void setDeviceI2CAddress(int16_t address) { this->deviceAddress = address; }
+
+    /**
+     * @brief Sets the CTS polling backoff (uS). Same as SI4735Base::setCtsPolling.
+     */
+    inline void setCtsPolling(uint16_t minDelay, uint16_t maxDelay)
+    {
+        this->ctsPollMinDelay = (minDelay > 0) ? minDelay : 1;
+        this->ctsPollMaxDelay = (maxDelay > this->ctsPollMinDelay) ? maxDelay : this->ctsPollMinDelay;
+    }
+
+    /**
+     * @brief Sets the maximum time (ms) waiting for CTS.
+     */
+    inline void setCtsTimeout(uint16_t timeout_ms) { this->ctsTimeout = timeout_ms; }
+
+    /**
+     * @brief Sets the maximum time (ms) waiting for STCINT after a tune command.
+     */
+    inline void setMaxDelaySetFrequency(uint16_t ms) { this->maxDelaySetFrequency = ms; }
+
+    /**
+     * @brief Sets the maximum time (ms) of a seek.
+     */
+    inline void setMaxSeekTime(uint32_t ms) { this->maxSeekTime = ms; }
+
+    /**
+     * @brief Result of the last command: SI4735_OK, SI4735_ERR_DEVICE or SI4735_ERR_TIMEOUT.
+     */
+    inline uint8_t getLastError() { return this->lastError; }
+
+    inline void setCommandLatency(uint8_t cmd, uint16_t us) { this->commandLatency[getCommandSlot(cmd)] = us; }
+    inline uint16_t getCommandLatency(uint8_t cmd) { return this->commandLatency[getCommandSlot(cmd)]; }
+
+    /**
+     * @brief Restores the initial command and tune latency predictions (same values as SI4735Base).
+     */
+    void resetCommandLatency() { Protocol::resetLatency(commandLatency, tuneLatency); }
+
+    /**
+     * @brief Waits for CTS. Sleeps the predicted latency of the last command sent, then polls with a backoff.
+     * @see SI4735Base::waitToSend
+     * @return false if the device did not get ready within the CTS timeout.
+     */
+    bool waitToSend()
+    {
+        uint16_t *predicted = NULL;
+        uint32_t waited;
+        uint16_t reads;
+
+        if (pendingCommand != 0)
+        {
+            predicted = &commandLatency[getCommandSlot(pendingCommand)];
+            if (*predicted > 0)
+                clock.waitMicroseconds(*predicted);
+            pendingCommand = 0;
+        }
+
+        if (!Protocol::pollCts(bus, clock, deviceAddress, &statusByte, 1, ctsPollMinDelay, ctsPollMaxDelay, (uint32_t)ctsTimeout * 1000,
+                               true, &waited, &reads))
+        {
+            lastError = SI4735_ERR_TIMEOUT;
+            return false;
+        }
+        if (predicted != NULL)
+            Protocol::updateLatency(predicted, waited);
+        lastError = SI4735_OK;
+        return true;
+    }
+
+    /**
+     * @brief Sends a command (waits for CTS first). The command and its arguments go in one write.
+     * @param cmd command opcode
+     * @param argc number of arguments (up to 7)
+     * @param args command arguments
+     */
+    void sendCommand(uint8_t cmd, uint8_t argc, const uint8_t *args)
+    {
+        waitToSend();
+        Protocol::writeFrame(bus, deviceAddress, cmd, argc, args);
+        pendingCommand = cmd;
+    }
+
+    /**
+     * @brief Sends a command and reads its response (resp[0] is the status byte).
+     * @see SI4735Base::transact
+     * @return false if the device reported an error (ERR bit) or did not get ready in time.
+     */
+    bool transact(uint8_t cmd, const uint8_t *args, uint8_t argc, uint8_t *resp, uint8_t respc)
+    {
+        uint16_t *predicted = &commandLatency[getCommandSlot(cmd)];
+        uint32_t waited;
+        uint16_t reads;
+
+        if (!waitToSend()) // The previous command must be done
+            return false;
+        Protocol::writeFrame(bus, deviceAddress, cmd, argc, args);
+        if (*predicted > 0)
+            clock.waitMicroseconds(*predicted);
+
+        if (!Protocol::pollCts(bus, clock, deviceAddress, resp, respc, ctsPollMinDelay, ctsPollMaxDelay, (uint32_t)ctsTimeout * 1000,
+                               true, &waited, &reads))
+        {
+            lastError = SI4735_ERR_TIMEOUT;
+            return false;
+        }
+        statusByte = resp[0];
+        Protocol::updateLatency(predicted, waited);
+
+        lastError = (resp[0] & 0B01000000) ? SI4735_ERR_DEVICE : SI4735_OK;
+        return lastError == SI4735_OK;
+    }
+
+    /**
+     * @brief Powers the device up (CTS interrupts and GPO2 output disabled).
+     * @param func POWER_UP_FM or POWER_UP_AM
+     * @param opmode SI473X_ANALOG_AUDIO, SI473X_DIGITAL_AUDIO1...
+     * @param xoscen XOSCEN_CRYSTAL or XOSCEN_RCLK
+     */
+    void radioPowerUp(uint8_t func, uint8_t opmode = SI473X_ANALOG_AUDIO, uint8_t xoscen = XOSCEN_CRYSTAL)
+    {
+        uint8_t args[2] = {(uint8_t)((xoscen << 4) | (func & 0x0F)), opmode};
+
+        sendCommand(POWER_UP, 2, args);
+        waitToSend();
+        clock.wait(MAX_DELAY_AFTER_POWERUP);
+        currentTune = (func == POWER_UP_FM) ? FM_TUNE_FREQ : AM_TUNE_FREQ;
+    }
+
+    /**
+     * @brief Moves the device from powerup to powerdown mode.
+     */
+    void powerDown()
+    {
+        sendCommand(POWER_DOWN, 0, NULL);
+        waitToSend();
+    }
+
+    /**
+     * @brief Sets a property (SET_PROPERTY). There is no shadow cache: every call goes to the bus.
+     */
+    void setProperty(uint16_t property, uint16_t value)
+    {
+        uint8_t args[5];
+
+        Protocol::propertyArgs(property, value, args);
+        sendCommand(SET_PROPERTY, 5, args);
+    }
+
+    /**
+     * @brief Reads a property (GET_PROPERTY).
+     * @return false if the device reported an error.
+     */
+    bool getProperty(uint16_t property, uint16_t *value)
+    {
+        uint8_t args[3];
+        uint8_t resp[4];
+
+        Protocol::propertyArgs(property, args);
+        if (!transact(GET_PROPERTY, args, 3, resp, 4))
+            return false;
+        *value = Protocol::propertyValue(resp);
+        return true;
+    }
+
+    /**
+     * @brief Tunes a frequency of the current mode and waits for STCINT.
+     * @param freq FM => 10390 = 103.9 MHz; AM => 810 = 810 kHz.
+     */
+    void setFrequency(uint16_t freq)
+    {
+        uint8_t args[5] = {0, (uint8_t)(freq >> 8), (uint8_t)freq, 0, 0};
+
+        // AM sends one more byte (ANTCAPL)
+        sendCommand(currentTune, (currentTune == AM_TUNE_FREQ) ? 5 : 4, args);
+        waitToSend();
+        currentFrequency = freq;
+        waitTuneComplete(&tuneLatency[(currentTune == FM_TUNE_FREQ) ? 0 : 1], (uint32_t)maxDelaySetFrequency * 1000);
+    }
+
+    /**
+     * @brief Seeks the next station and waits for the end of the seek (STCINT or maxSeekTime).
+     * @details The frequency found is read with the tune status (see getFrequency); a seek longer than maxSeekTime is
+     * cancelled.
+     * @param up SEEK_UP or SEEK_DOWN
+     * @param wrap 1 = wrap at the band limits
+     */
+    void seekStation(uint8_t up, uint8_t wrap = 1)
+    {
+        uint8_t args[5];
+        uint16_t predicted = (currentTune == FM_TUNE_FREQ) ? tuneLatency[0] : tuneLatency[1];
+
+        sendCommand((currentTune == FM_TUNE_FREQ) ? FM_SEEK_START : AM_SEEK_START, Protocol::seekArgs(currentTune, currentFrequency, up, wrap, args), args);
+        waitToSend();
+        if (!waitTuneComplete(&predicted, maxSeekTime * 1000))
+            getStatus(1, 1); // INTACK; CANCEL the seek still running
+    }
+
+    /**
+     * @brief Reads the tune status (FM_TUNE_STATUS or AM_TUNE_STATUS) into currentStatus.
+     * @param INTACK 1 = clears STCINT
+     * @param CANCEL 1 = aborts a seek in progress
+     */
+    si47x_response_status &getStatus(uint8_t INTACK = 0, uint8_t CANCEL = 0)
+    {
+        uint8_t arg = (uint8_t)((CANCEL << 1) | INTACK);
+
+        if (transact((currentTune == FM_TUNE_FREQ) ? FM_TUNE_STATUS : AM_TUNE_STATUS, &arg, 1, currentStatus.raw, 8))
+            currentFrequency = si47x_tune_status_view(currentStatus.raw).frequency();
+        return currentStatus;
+    }
+
+    /**
+     * @brief Reads the Received Signal Quality (FM_RSQ_STATUS or AM_RSQ_STATUS) into currentRqsStatus.
+     */
+    si47x_rqs_status &getCurrentReceivedSignalQuality(uint8_t INTACK = 0)
+    {
+        uint8_t arg = INTACK;
+
+        transact((currentTune == FM_TUNE_FREQ) ? FM_RSQ_STATUS : AM_RSQ_STATUS, &arg, 1, currentRqsStatus.raw, 8);
+        return currentRqsStatus;
+    }
+
+    /**
+     * @brief Reads the RDS status and one group (FM_RDS_STATUS) into currentRdsStatus.
+     */
+    si47x_rds_status &getRdsStatus(uint8_t INTACK = 0, uint8_t MTFIFO = 0, uint8_t STATUSONLY = 0)
+    {
+        uint8_t arg = (uint8_t)((STATUSONLY << 2) | (MTFIFO << 1) | INTACK);
+
+        transact(FM_RDS_STATUS, &arg, 1, currentRdsStatus.raw, 13);
+        return currentRdsStatus;
+    }
+
+    /**
+     * @brief Frequency of the last tune, or read by the last getStatus.
+     */
+    inline uint16_t getFrequency() { return this->currentFrequency; }
+
+    inline si47x_tune_status_view getStatusView() const { return si47x_tune_status_view(currentStatus.raw); }
+    inline si47x_rsq_view getRsqView() const { return si47x_rsq_view(currentRqsStatus.raw); }
+    inline si47x_rds_view getRdsView() const { return si47x_rds_view(currentRdsStatus.raw); }
+
+    inline uint8_t getStatusRSSI() { return getStatusView().rssi(); }
+    inline uint8_t getStatusSNR() { return getStatusView().snr(); }
+    inline bool getStatusValid() { return getStatusView().valid(); }
+    inline uint8_t getCurrentRSSI() { return getRsqView().rssi(); }
+    inline uint8_t getCurrentSNR() { return getRsqView().snr(); }
+
+    si47x_response_status currentStatus;
+    si47x_rqs_status currentRqsStatus;
+    si47x_rds_status currentRdsStatus;
+
+protected:
+    Transport &bus;
+    ClockT &clock;
+    int16_t deviceAddress;
+    uint8_t currentTune = FM_TUNE_FREQ;
+    uint16_t currentFrequency = 0;
+    uint8_t pendingCommand = 0;
+    uint8_t statusByte = 0; //!< Status byte read by the last waitToSend
+    uint8_t lastError = SI4735_OK;
+
+    uint16_t ctsPollMinDelay = MIN_DELAY_CTS_POLL;
+    uint16_t ctsPollMaxDelay = MIN_DELAY_WAIT_SEND_LOOP;
+    uint16_t ctsTimeout = MAX_DELAY_CTS_TIMEOUT;
+    uint16_t maxDelaySetFrequency = MAX_DELAY_AFTER_SET_FREQUENCY;
+    uint32_t maxSeekTime = MAX_SEEK_TIME;
+
+    uint16_t commandLatency[LATENCY_SLOTS]; //!< Predicted time (uS) from each command to CTS. See getCommandSlot.
+    uint16_t tuneLatency[3];                //!< Predicted time (uS) from a tune command to STCINT (FM, AM/SSB, NBFM).
+
+    /**
+     * @brief Slot of a command in commandLatency, as in SI4735Base. Resolved at compile time when cmd is a constant.
+     */
+    static constexpr uint8_t getCommandSlot(uint8_t cmd) { return si4735CommandIndex(cmd); }
+
+    /**
+     * @brief Sleeps the predicted tune time, then polls STCINT (GET_INT_STATUS) until it is set or limit (uS) is reached.
+     * @details Ends with the tune status read with INTACK (clears STCINT). If STCINT is not set in time, getLastError
+     * returns SI4735_ERR_TIMEOUT.
+     * @return true if the tune completed and STCINT was acknowledged.
+     */
+    bool waitTuneComplete(uint16_t *predicted, uint32_t limit)
+    {
+        bool polled;
+        bool ready = true;
+        bool stc = false;
+        uint32_t waited = Protocol::waitStc(
+            clock, *predicted, limit, ctsPollMaxDelay, &polled,
+            [this, &ready, &stc]() -> bool {
+                sendCommand(GET_INT_STATUS, 0, NULL);
+                ready = waitToSend();
+                stc = ready && (statusByte & 0B00000001); // STCINT
+                return !ready || stc;                     // Gives up if the device does not answer
+            },
+            [this](uint16_t delay) -> uint32_t {
+                clock.waitMicroseconds(delay);
+                return delay;
+            });
+
+        if (!ready)
+            return false;
+        if (!stc)
+        {
+            lastError = SI4735_ERR_TIMEOUT;
+            return false;
+        }
+        Protocol::updateTuneLatency(predicted, waited, polled);
+        getStatus(1, 0); // INTACK
+        return lastError == SI4735_OK;
+    }
+};
+
+#endif // _SI4735_CORE_H
@@ -0,0 +1,368 @@
+/**
+ * @file si4735-coro.h
+ *
+ * @brief Optional C++20 coroutine facade over the non-blocking (async) commands of SI4735Base.
+ *
+ * @details This header is not included by si4735.h. Include it (C++20 only) to write sequential-looking receiver logic
+ * @details that still interleaves many devices on one core. Each awaitable starts an async command (beginTune, beginSeek,
+ * @details beginRsqRead, beginRdsRead or beginPatch) and suspends the coroutine until poll() reports the end of it;
+ * @details nothing blocks in clock.wait. SI4735Scheduler is a minimal single-threaded scheduler driven by the Clock interface.
+ *
+ * @code
+ * SI4735Task scan(SI4735Scheduler &sched, SI4735 &rx)
+ * {
+ *     for (uint16_t f = 8750; f <= 10800; f += 10)
+ *     {
+ *         if (co_await sched.tune(rx, f) != ASYNC_DONE)
+ *             continue;
+ *         co_await sched.readRsq(rx);
+ *         printf("%u %u\n", rx.getCurrentFrequency(), rx.getCurrentRSSI());
+ *     }
+ * }
+ *
+ * SI4735Scheduler sched(clock);
+ * sched.spawn(scan(sched, rx1));
+ * sched.spawn(scan(sched, rx2));
+ * sched.run();
+ * @endcode
+ *
+ * @see group21 Non-blocking (async) commands
+ */
+
+#ifndef _SI4735_CORO_H
+#define _SI4735_CORO_H
+
+#if __cplusplus < 202002L
+#error "si4735-coro.h requires C++20 (coroutines)"
+#endif
+
+#include <coroutine>
+#include <exception>
+
+#include "si4735-cpp.h"
+
+#define SI4735_CORO_MAX_WAITERS 32 // Maximum number of suspended coroutines per scheduler
+#define SI4735_CORO_IDLE 100       // In uS - scheduler idle time when no coroutine is ready
+
+/**
+ * @ingroup group21
+ *
+ * @brief Coroutine type used by receiver logic run by SI4735Scheduler.
+ *
+ * @details A task starts suspended. Pass it to SI4735Scheduler::spawn to run it as a top-level task,
+ * @details or co_await it from another task to run it as a subroutine.
+ * @details An exception that leaves a subroutine is rethrown by co_await in the caller; one that leaves a top-level
+ * @details task is rethrown by SI4735Scheduler::step (and run). Without exception support, it calls std::terminate.
+ */
+class SI4735Task
+{
+public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation; //!< Coroutine awaiting this task (none for top-level tasks).
+#if defined(__cpp_exceptions)
+        std::exception_ptr exception; //!< Exception that ended the task (rethrown by rethrowIfFailed).
+#endif
+
+        SI4735Task get_return_object() { return SI4735Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+#if defined(__cpp_exceptions)
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        void rethrowIfFailed()
+        {
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+#else
+        void unhandled_exception() { std::terminate(); }
+        void rethrowIfFailed() {}
+#endif
+    };
+
+    explicit SI4735Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    SI4735Task(SI4735Task &&other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    SI4735Task(const SI4735Task &) = delete;
+    SI4735Task &operator=(const SI4735Task &) = delete;
+    ~SI4735Task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    /**
+     * @brief Releases the coroutine handle (used by SI4735Scheduler::spawn).
+     */
+    std::coroutine_handle<promise_type> release()
+    {
+        std::coroutine_handle<promise_type> h = handle;
+        handle = nullptr;
+        return h;
+    }
+
+    // Awaiting a task runs it as a subroutine and resumes the caller when it finishes.
+    bool await_ready() { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller)
+    {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+    void await_resume()
+    {
+        if (handle)
+            handle.promise().rethrowIfFailed();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @ingroup group21
+ *
+ * @brief Minimal single-threaded scheduler for SI4735Task coroutines.
+ *
+ * @details run() checks the suspended coroutines in turn and resumes the ones whose condition is ready
+ * @details (async command complete, time elapsed). Checking an async command calls poll(), which never sleeps.
+ * @details When no coroutine is ready, the scheduler waits SI4735_CORO_IDLE uS using the Clock interface.
+ */
+class SI4735Scheduler
+{
+public:
+    /**
+     * @brief Suspended coroutine and the condition that resumes it.
+     */
+    struct Waiter
+    {
+        bool (*ready)(void *context); //!< Returns true when the coroutine can be resumed.
+        void *context;                //!< Argument of ready (the awaiter).
+        std::coroutine_handle<> handle;
+        bool owned; //!< true for top-level tasks: destroyed by the scheduler when done.
+    };
+
+    explicit SI4735Scheduler(Clock &clock) : clock(clock) {}
+
+    /**
+     * @brief Adds a top-level task. It starts on the next run() round.
+     * @return false if the scheduler is full.
+     */
+    bool spawn(SI4735Task &&task)
+    {
+        std::coroutine_handle<> h = task.release();
+        if (count + rootCount >= SI4735_CORO_MAX_WAITERS || !park(always, NULL, h, true))
+        {
+            h.destroy();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Runs the tasks until all of them are finished.
+     */
+    void run()
+    {
+        while (count > 0)
+        {
+            if (!step())
+                clock.waitMicroseconds(SI4735_CORO_IDLE);
+        }
+    }
+
+    /**
+     * @brief Checks every suspended coroutine once and resumes the ready ones (call it from your own loop instead of run).
+     * @details An exception that ends a top-level task is rethrown here, after the task is destroyed; the other
+     * @details tasks stay suspended and the next step() goes on with them.
+     * @return true if at least one coroutine was resumed.
+     */
+    bool step()
+    {
+        bool progress = false;
+        uint8_t i = 0;
+        while (i < count)
+        {
+            if (!waiters[i].ready(waiters[i].context))
+            {
+                i++;
+                continue;
+            }
+            Waiter w = waiters[i];
+            waiters[i] = waiters[--count]; // The coroutine may park again while it runs
+            resumeTop(w);
+            progress = true;
+        }
+        return progress;
+    }
+
+    /**
+     * @brief Number of suspended coroutines.
+     */
+    uint8_t pending() { return count; }
+
+    /**
+     * @brief Awaitable for an async command of SI4735Base.
+     * @details Starts the command as soon as the device has no other async command in flight, then polls it.
+     * @details co_await returns ASYNC_DONE or ASYNC_ERROR.
+     */
+    template <typename Begin>
+    struct Operation
+    {
+        SI4735Scheduler &scheduler;
+        SI4735Base &rx;
+        Begin begin;
+        bool started = false;
+        uint8_t result = ASYNC_BUSY;
+
+        static bool ready(void *context)
+        {
+            Operation *op = static_cast<Operation *>(context);
+            if (!op->started && !(op->started = op->begin(op->rx)))
+                return false;
+            op->result = op->rx.poll();
+            return op->result != ASYNC_BUSY;
+        }
+
+        bool await_ready() { return false; }
+        bool await_suspend(std::coroutine_handle<> h) { return scheduler.park(ready, this, h, false); }
+        uint8_t await_resume() { return (result == ASYNC_BUSY) ? ASYNC_ERROR : result; } // ASYNC_BUSY: the scheduler was full
+    };
+
+    template <typename Begin>
+    Operation<Begin> operation(SI4735Base &rx, Begin begin) { return Operation<Begin>{*this, rx, begin}; }
+
+    /**
+     * @brief Tunes a frequency (see beginTune). The result is read with getCurrentFrequency, getStatusSNR etc.
+     */
+    auto tune(SI4735Base &rx, uint16_t freq)
+    {
+        return operation(rx, [freq](SI4735Base &r) { return r.beginTune(freq); });
+    }
+
+    /**
+     * @brief Seeks the next station (see beginSeek). The station found is read with getCurrentFrequency.
+     */
+    auto seek(SI4735Base &rx, uint8_t up, uint8_t wrap = 1)
+    {
+        return operation(rx, [up, wrap](SI4735Base &r) { return r.beginSeek(up, wrap); });
+    }
+
+    /**
+     * @brief Reads the Received Signal Quality (see beginRsqRead). The result is read with getCurrentRSSI, getCurrentSNR etc.
+     */
+    auto readRsq(SI4735Base &rx, uint8_t INTACK = 0)
+    {
+        return operation(rx, [INTACK](SI4735Base &r) { return r.beginRsqRead(INTACK); });
+    }
+
+    /**
+     * @brief Reads the RDS status (see beginRdsRead). The result is in currentRdsStatus (getRdsReceived, getRdsText etc).
+     */
+    auto readRds(SI4735Base &rx, uint8_t INTACK = 0, uint8_t MTFIFO = 0, uint8_t STATUSONLY = 0)
+    {
+        return operation(rx, [INTACK, MTFIFO, STATUSONLY](SI4735Base &r) { return r.beginRdsRead(INTACK, MTFIFO, STATUSONLY); });
+    }
+
+    /**
+     * @brief Downloads a patch (see beginPatch). Call setSSBConfig or setNBFM after it, as you would after loadPatch.
+     */
+    auto loadPatch(SI4735Base &rx, const uint8_t *patch_content, const uint16_t patch_content_size)
+    {
+        return operation(rx, [patch_content, patch_content_size](SI4735Base &r) { return r.beginPatch(patch_content, patch_content_size); });
+    }
+
+    /**
+     * @brief Awaitable that suspends the coroutine for a given time (ms) without blocking the other ones.
+     */
+    struct Sleep
+    {
+        SI4735Scheduler &scheduler;
+        unsigned long start;
+        unsigned long ms;
+
+        static bool ready(void *context)
+        {
+            Sleep *s = static_cast<Sleep *>(context);
+            return s->scheduler.clock.now() - s->start >= s->ms;
+        }
+
+        bool await_ready() { return ms == 0; }
+        bool await_suspend(std::coroutine_handle<> h) { return scheduler.park(ready, this, h, false); }
+        void await_resume() {}
+    };
+
+    Sleep sleep(unsigned long ms) { return Sleep{*this, clock.now(), ms}; }
+
+    /**
+     * @brief Suspends a coroutine until ready(context) returns true.
+     * @return false if the scheduler is full (the coroutine is not suspended).
+     */
+    bool park(bool (*ready)(void *), void *context, std::coroutine_handle<> h, bool owned)
+    {
+        if (count >= SI4735_CORO_MAX_WAITERS)
+            return false;
+        waiters[count++] = Waiter{ready, context, h, owned};
+        return true;
+    }
+
+protected:
+    Clock &clock;
+    Waiter waiters[SI4735_CORO_MAX_WAITERS];
+    uint8_t count = 0;
+    std::coroutine_handle<SI4735Task::promise_type> roots[SI4735_CORO_MAX_WAITERS]; //!< Top-level tasks started and not finished yet.
+    uint8_t rootCount = 0;
+
+    static bool always(void *) { return true; }
+
+    /**
+     * @brief Resumes a coroutine and destroys the top-level tasks that finished.
+     * @details Rethrows the exception of a top-level task that failed (see SI4735Task).
+     */
+    void resumeTop(const Waiter &w)
+    {
+        if (w.owned) // Only spawn parks owned coroutines, and they are SI4735Task
+            roots[rootCount++] = std::coroutine_handle<SI4735Task::promise_type>::from_address(w.handle.address());
+        w.handle.resume();
+        for (uint8_t i = 0; i < rootCount;)
+        {
+            if (roots[i].done())
+            {
+                std::coroutine_handle<SI4735Task::promise_type> done = roots[i];
+                roots[i] = roots[--rootCount];
+                finish(done);
+            }
+            else
+                i++;
+        }
+    }
+
+    /**
+     * @brief Destroys a finished top-level task and rethrows its exception, if any.
+     */
+    static void finish(std::coroutine_handle<SI4735Task::promise_type> h)
+    {
+#if defined(__cpp_exceptions)
+        std::exception_ptr exception = h.promise().exception;
+        h.destroy();
+        if (exception)
+            std::rethrow_exception(exception);
+#else
+        h.destroy();
+#endif
+    }
+};
+
+#endif // _SI4735_CORO_H
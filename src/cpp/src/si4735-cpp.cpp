@@ -44,6 +44,10 @@
 
 typedef uint8_t byte; // For Arduino compatibility
 
+#if __cplusplus < 201703L
+constexpr si4735_command_info SI4735CommandTable::commands[LATENCY_SLOTS - 1]; // Inline from C++17
+#endif
+
 /**
  * @brief Construct a new SI4735Base::SI4735
  *
@@ -63,6 +67,12 @@ SI4735Base::SI4735Base(I2C& i2c, Clock& clock) : i2c(i2c), clock(clock)
 {
     // 1 = LSB and 2 = USB; 0 = AM, FM or WB
     currentSsbStatus = 0;
+    currentStatusByte.raw = 0;
+    resetCommandLatency();
+    resetCommandErrors();
+#ifdef SI4735_INSTRUMENTATION
+    resetBusStats();
+#endif
 }
 
 /** @defgroup group05 Deal with Interrupt and I2C bus */
@@ -84,17 +94,10 @@ SI4735Base::SI4735Base(I2C& i2c, Clock& clock) : i2c(i2c), clock(clock)
  */
 si47x_status SI4735Base::getInterruptStatus()
 {
-    si47x_status status;
-
+    sendCommand<GET_INT_STATUS>();
     waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(GET_INT_STATUS);
-    i2c.endTransmission();
 
-    i2c.requestFrom(deviceAddress, 1);
-    status.raw = i2c.read();
-
-    return status;
+    return currentStatusByte;
 }
 
 /**
@@ -128,12 +131,7 @@ void SI4735Base::setGpioCtl(uint8_t GPO1OEN, uint8_t GPO2OEN, uint8_t GPO3OEN)
     gpio.arg.DUMMY1 = 0;
     gpio.arg.DUMMY2 = 0;
 
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(GPIO_CTL);
-    i2c.write(gpio.raw);
-    i2c.endTransmission();
+    sendCommand(GPIO_CTL, 1, &gpio.raw);
 }
 
 /**
@@ -167,12 +165,7 @@ void SI4735Base::setGpio(uint8_t GPO1LEVEL, uint8_t GPO2LEVEL, uint8_t GPO3LEVEL
     gpio.arg.DUMMY1 = 0;
     gpio.arg.DUMMY2 = 0;
 
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(GPIO_SET);
-    i2c.write(gpio.raw);
-    i2c.endTransmission();
+    sendCommand(GPIO_SET, 1, &gpio.raw);
 }
 
 /**
@@ -299,16 +292,389 @@ void SI4735Base::setDeviceOtherI2CAddress(uint8_t i2cAddr)
  * @brief  Wait for the si473x is ready (Clear to Send (CTS) status bit have to be 1).
  *
  * @details This function should be used before sending any command to a SI47XX device.
- *
+ * @details When a command is pending and an interrupt line was set (setInterruptLine), it blocks on the GPO2/INT line first
+ * @details and confirms CTS with one status read; the time blocked (Clock::now resolution) goes to the CTS statistics.
+ * @details Without a pending command (the device is already known to be ready, or was never sent anything) it reads the
+ * @details status right away. Otherwise it first sleeps the predicted completion time of the last command sent (see setCommandLatency) and
+ * @details then polls the CTS bit with an adaptive backoff: the delay between reads doubles from ctsPollMinDelay up to
+ * @details ctsPollMaxDelay (MIN_DELAY_WAIT_SEND_LOOP by default).
+ * @details The prediction is calibrated on each call: it shrinks by 1/8 when the device is ready at the first read and
+ * @details grows by 1/4 of the extra time spent polling otherwise.
+ * @details The polling gives up after ctsTimeout ms (see setRetryPolicy): the error is counted for the pending command
+ * @details and getLastError returns SI4735_ERR_TIMEOUT. When CTS is seen, getLastError returns SI4735_OK again.
+ *
+ * @see setInterruptLine, setCtsPolling, setCommandLatency, setRetryPolicy
  * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 63, 128
+ *
+ * @return false if the device did not get ready (CTS) within ctsTimeout.
  */
-void SI4735Base::waitToSend()
+bool SI4735Base::waitToSend()
 {
-    do
+    uint16_t *predicted = NULL;
+    uint32_t waited;
+    uint16_t reads;
+    uint8_t cmd = pendingCommand;
+
+    SI4735_TRACE_BEGIN("cts", TRACE_CTS, cmd);
+    if (pendingCommand != 0 && interruptLine != NULL)
     {
-        clock.waitMicroseconds(MIN_DELAY_WAIT_SEND_LOOP); // Need check the minimum value.
-        i2c.requestFrom(deviceAddress, 1);
-    } while (!(i2c.read() & 0B10000000));
+#ifdef SI4735_INSTRUMENTATION
+        unsigned long start = clock.now();
+#endif
+        interruptLine->wait(ctsInterruptTimeout); // On timeout, the polling below takes over.
+#ifdef SI4735_INSTRUMENTATION
+        SI4735_STATS_ADD(cmd, ctsWaitTime, (uint32_t)(clock.now() - start) * 1000);
+        SI4735_STATS_LATENCY(cmd, (uint32_t)(clock.now() - start) * 1000);
+#endif
+    }
+    else if (pendingCommand != 0)
+    {
+        predicted = &commandLatency[getCommandSlot(pendingCommand)];
+        if (*predicted > 0)
+            clock.waitMicroseconds(*predicted);
+        SI4735_STATS_ADD(cmd, ctsWaitTime, *predicted);
+    }
+    pendingCommand = 0;
+
+    bool ready = Protocol::pollCts(i2c, clock, deviceAddress, &currentStatusByte.raw, 1, ctsPollMinDelay, ctsPollMaxDelay,
+                                   (uint32_t)ctsTimeout * 1000, true, &waited, &reads);
+    SI4735_STATS_ADD(cmd, ctsPolls, reads);
+    SI4735_STATS_ADD(cmd, bytesRead, reads);
+    if (!ready)
+    {
+        SI4735_TRACE_END();
+        setCommandError(cmd, SI4735_ERR_TIMEOUT);
+        return false;
+    }
+    SI4735_STATS_ADD(cmd, ctsWaitTime, waited);
+    SI4735_TRACE_END();
+
+    if (predicted != NULL)
+    {
+        SI4735_STATS_LATENCY(cmd, *predicted + waited);
+        Protocol::updateLatency(predicted, waited);
+    }
+    lastError = SI4735_OK;
+    return true;
+}
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Records a command error.
+ *
+ * @details Stores the error (see getLastError) and counts it for the command (see getCommandErrors).
+ *
+ * @param cmd command opcode (0 if unknown)
+ * @param error SI4735_ERR_DEVICE or SI4735_ERR_TIMEOUT
+ */
+void SI4735Base::setCommandError(uint8_t cmd, uint8_t error)
+{
+    uint8_t slot = getCommandSlot(cmd);
+
+    lastError = error;
+    if (commandErrors[slot] < 0xFFFF)
+        commandErrors[slot]++;
+}
+
+/**
+ * @ingroup group05
+ *
+ * @brief Sets the I2C clock through the speed control.
+ * @return false if there is no speed control or the transport refused the speed.
+ */
+bool SI4735Base::applyBusSpeed(uint32_t hz)
+{
+    if (busSpeedControl == NULL || hz == 0)
+        return false;
+    if (hz == busSpeed)
+        return true;
+    if (!busSpeedControl->setSpeed(hz))
+        return false;
+    busSpeed = hz;
+    return true;
+}
+
+/**
+ * @ingroup group05
+ *
+ * @brief Lets the driver change the I2C clock.
+ *
+ * @details The bulk transfers (downloadPatch, downloadCompressedPatch, downloadPatchFromEeprom and drainRdsFifo) run at the
+ * @details bulk speed; every other command, including the tune, seek and status polls, runs at the normal speed.
+ * @details Keep the normal speed low when the bus is shared with slower devices or has long wires; the bulk speed is used
+ * @details only for the duration of the transfer. probeBusSpeed finds the highest bulk speed the bus can take.
+ * @code
+ *   SI4735ArduinoBusSpeed<TwoWire> busSpeed(Wire);
+ *   rx.setBusSpeedControl(&busSpeed);                        // 100 kHz, patches at 400 kHz
+ *   rx.setBusSpeedControl(&busSpeed, I2C_SPEED_LOW, I2C_SPEED_STANDARD); // shared bus with long wires
+ * @endcode
+ *
+ * @see SI4735BusSpeed, setBusSpeeds, probeBusSpeed
+ *
+ * @param control the speed control; NULL leaves the bus speed alone.
+ * @param normal speed outside the bulk transfers (Hz).
+ * @param bulk speed of the bulk transfers (Hz).
+ */
+void SI4735Base::setBusSpeedControl(SI4735BusSpeed *control, uint32_t normal, uint32_t bulk)
+{
+    busSpeedControl = control;
+    busSpeed = 0;
+    setBusSpeeds(normal, bulk);
+}
+
+/**
+ * @ingroup group05
+ *
+ * @brief Changes the normal and bulk I2C speeds and applies the normal speed.
+ * @see setBusSpeedControl
+ */
+void SI4735Base::setBusSpeeds(uint32_t normal, uint32_t bulk)
+{
+    busSpeedNormal = normal;
+    busSpeedBulk = bulk;
+    applyBusSpeed(normal);
+}
+
+/**
+ * @ingroup group05
+ *
+ * @brief Finds the highest I2C speed the bus and the device handle reliably and uses it for the bulk transfers.
+ *
+ * @details Tries the speeds in the order given (fastest first). At each speed it runs reads GET_INT_STATUS commands;
+ * @details the speed passes if every command is acknowledged with CTS and without ERR. The first speed that passes becomes
+ * @details the bulk speed. The normal speed is restored at the end. CTS waits are limited to 10 ms during the test so a
+ * @details speed that does not work fails fast.
+ * @code
+ *   static const uint32_t speeds[] = {1000000, 800000, 400000, 100000};
+ *   rx.setBusSpeedControl(&busSpeed);
+ *   rx.probeBusSpeed(speeds, 4);
+ * @endcode
+ *
+ * @see setBusSpeedControl
+ *
+ * @param speeds candidate speeds in Hz, fastest first.
+ * @param count number of speeds.
+ * @param reads commands sent at each speed.
+ * @return the speed selected (0 if no speed passed or there is no speed control; the bulk speed is then unchanged).
+ */
+uint32_t SI4735Base::probeBusSpeed(const uint32_t *speeds, uint8_t count, uint8_t reads)
+{
+    uint16_t timeout = ctsTimeout;
+    uint32_t selected = 0;
+    uint8_t resp[1];
+
+    if (busSpeedControl == NULL)
+        return 0;
+    ctsTimeout = 10;
+    for (uint8_t i = 0; i < count && selected == 0; i++)
+    {
+        bool ok = applyBusSpeed(speeds[i]);
+
+        for (uint8_t r = 0; ok && r < reads; r++)
+            ok = transact(GET_INT_STATUS, NULL, 0, resp, 1);
+        if (ok)
+            selected = speeds[i];
+    }
+    if (!waitToSend()) // Let the device settle after a failed speed
+        lastError = SI4735_OK;
+    ctsTimeout = timeout;
+    if (selected)
+        busSpeedBulk = selected;
+    applyBusSpeed(busSpeedNormal);
+    return selected;
+}
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Clears the per-command error and retry counters.
+ *
+ * @see getCommandErrors, getCommandRetries
+ */
+void SI4735Base::resetCommandErrors()
+{
+    for (uint8_t i = 0; i < LATENCY_SLOTS; i++)
+        commandErrors[i] = commandRetries[i] = 0;
+    lastError = SI4735_OK;
+}
+
+#ifdef SI4735_INSTRUMENTATION
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Clears the bus counters.
+ *
+ * @see getBusStats
+ */
+void SI4735Base::resetBusStats()
+{
+    memset(&busStats, 0, sizeof(busStats));
+    memset(tuneStats, 0, sizeof(tuneStats));
+    for (uint8_t i = 0; i < LATENCY_SLOTS - 1; i++)
+        busStats.command[i].opcode = SI4735_COMMANDS[i].opcode;
+}
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Copies the bus counters.
+ *
+ * @details Available when the library is built with SI4735_INSTRUMENTATION. For each command opcode the snapshot has
+ * @details the bytes written and read, the CTS polls, the time spent in waitToSend, in STCINT polling and in fixed waits,
+ * @details and a log2 histogram of the time from command to CTS. The counters run until resetBusStats is called.
+ *
+ * @code
+ * si4735_bus_stats stats;
+ * rx.getBusStats(&stats);
+ * for (int i = 0; i < LATENCY_SLOTS; i++)
+ *     if (stats.command[i].commands)
+ *         printf("0x%02X %u polls %u us\n", stats.command[i].opcode, stats.command[i].ctsPolls, stats.command[i].ctsWaitTime);
+ * @endcode
+ *
+ * @see resetBusStats, getCommandStats, si4735_command_stats
+ *
+ * @param stats where the counters are copied to.
+ */
+void SI4735Base::getBusStats(si4735_bus_stats *stats)
+{
+    memcpy(stats, &busStats, sizeof(busStats));
+}
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Adds a command to CTS time to the latency histogram of a command.
+ */
+void SI4735Base::addLatencySample(uint8_t cmd, uint32_t us)
+{
+    uint8_t bucket = 0;
+
+    while ((us >>= 1) != 0 && bucket < SI4735_STATS_BUCKETS - 1)
+        bucket++;
+    busStats.command[getCommandSlot(cmd)].latency[bucket]++;
+}
+#endif
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Restores the initial command and tune latency predictions.
+ *
+ * @details Use it after changing the reference clock or the I2C bus speed, since the calibrated values no longer apply.
+ *
+ * @see setCommandLatency, LATENCY_POWER, LATENCY_PROPERTY, LATENCY_COMMAND, LATENCY_TUNE_FM
+ */
+void SI4735Base::resetCommandLatency()
+{
+    Protocol::resetLatency(commandLatency, tuneLatency);
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Waits for the end of the current tune command (STCINT).
+ *
+ * @details Depending on setTuneWait: sleeps the predicted tune time of the current mode and then polls STCINT
+ * @details (TUNE_WAIT_PREDICTED); polls STCINT right away (TUNE_WAIT_STC); or sleeps maxDelaySetFrequency (TUNE_WAIT_FIXED).
+ * @details The whole wait is bounded by maxDelaySetFrequency (see setMaxDelaySetFrequency). It ends with the tune status
+ * @details read with INTACK, which clears STCINT; if STCINT was not set in time, getLastError returns SI4735_ERR_TIMEOUT.
+ * @details The prediction is calibrated like the command latencies (see waitToSend), from the tunes that complete. The time until STCINT is kept in
+ * @details tuneSettleTime and, with SI4735_INSTRUMENTATION, in the statistics of the band (getTuneStats).
+ *
+ * @see setFrequency, setMaxDelaySetFrequency, setTuneWait
+ */
+void SI4735Base::waitTuneComplete()
+{
+    uint16_t *predicted = &tuneLatency[(currentTune == FM_TUNE_FREQ) ? 0 : (currentTune == AM_TUNE_FREQ) ? 1 : 2];
+    uint32_t limit = (uint32_t)maxDelaySetFrequency * 1000;
+    bool polled;
+
+    if (tuneWait == TUNE_WAIT_FIXED)
+    {
+        fixedWait(currentTune, maxDelaySetFrequency);
+        tuneSettleTime = limit;
+        getStatus(1, 0); // INTACK
+    }
+    else
+    {
+        if (waitStc((tuneWait == TUNE_WAIT_STC) ? 0 : *predicted, limit, &tuneSettleTime, &polled))
+            Protocol::updateTuneLatency(predicted, tuneSettleTime, polled);
+    }
+
+#ifdef SI4735_INSTRUMENTATION
+    uint8_t band = (currentTune == FM_TUNE_FREQ) ? FM_CURRENT_MODE : (currentTune == NBFM_TUNE_FREQ) ? NBFM_CURRENT_MODE : (currentSsbStatus != 0) ? SSB_CURRENT_MODE : AM_CURRENT_MODE;
+    si4735_tune_stats &stats = tuneStats[band];
+
+    if (stats.tunes == 0 || tuneSettleTime < stats.min)
+        stats.min = tuneSettleTime;
+    if (tuneSettleTime > stats.max)
+        stats.max = tuneSettleTime;
+    stats.last = tuneSettleTime;
+    stats.total += tuneSettleTime;
+    stats.tunes++;
+#endif
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Sleeps predicted uS, then polls STCINT (GET_INT_STATUS) with a backoff up to MAX_DELAY_STC_POLL.
+ *
+ * @details The device must be clear to send (waitToSend after the tune command): each poll is one GET_INT_STATUS write
+ * @details and one status read. With an interrupt line (setInterruptLine), the backoff steps block on the line.
+ * @details When STCINT is set, the tune status is read with INTACK (see getStatus), which clears STCINT for the next
+ * @details tune. If STCINT is not set within limit, getLastError returns SI4735_ERR_TIMEOUT.
+ *
+ * @param predicted time to sleep before the first poll (uS).
+ * @param limit maximum wait (uS).
+ * @param waited time waited (uS).
+ * @param polled set to true if STCINT was not set at the first poll.
+ * @return true if the tune completed and STCINT was acknowledged.
+ */
+bool SI4735Base::waitStc(uint32_t predicted, uint32_t limit, uint32_t *waited, bool *polled)
+{
+    bool ready = true;
+    bool stc = false;
+
+    SI4735_TRACE_BEGIN("stc", TRACE_STC, currentTune);
+    *waited = Protocol::waitStc(
+        clock, predicted, limit, ctsPollMaxDelay, polled,
+        [this, &ready, &stc]() -> bool {
+            writeCommand(GET_INT_STATUS, 0, NULL);
+            pendingCommand = GET_INT_STATUS;
+            ready = waitToSend();
+            stc = ready && (currentStatusByte.raw & 0B00000001); // STCINT
+            return !ready || stc;
+        },
+        [this](uint16_t delay) -> uint32_t {
+            unsigned long start;
+            uint32_t spent;
+
+            if (interruptLine == NULL)
+            {
+                clock.waitMicroseconds(delay);
+                return delay;
+            }
+            start = clock.now();
+            if (!interruptLine->wait(delay))
+                return delay;
+            // Signaled early. The clock counts ms: a step counts at least ctsPollMinDelay, so a line that keeps
+            // signaling still reaches the limit.
+            spent = (uint32_t)(clock.now() - start) * 1000;
+            return (spent > delay) ? delay : (spent < ctsPollMinDelay) ? ctsPollMinDelay : spent;
+        });
+    SI4735_STATS_ADD(currentTune, stcWaitTime, *waited);
+    SI4735_TRACE_END();
+    if (!ready)
+        return false; // waitToSend reported the error
+    if (!stc)
+    {
+        setCommandError(currentTune, SI4735_ERR_TIMEOUT);
+        return false;
+    }
+    getStatus(1, 0); // INTACK
+    return lastError == SI4735_OK;
 }
 
 /** @defgroup group07 Device Setup and Start up */
@@ -377,6 +743,50 @@ void SI4735Base::analogPowerUp(void)
     radioPowerUp();
 }
 
+/**
+ * @ingroup group07 Device Power Up
+ *
+ * @brief Powerup the Si47XX
+ *
+ * @details Before call this function call the setPowerUp to set up the parameters.
+ * @details Portable version of SI4735Arduino::radioPowerUp (no external mute circuit).
+ *
+ * @see  SI4735Base::setPowerUp()
+ * @see  Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 64, 129
+ */
+void SI4735Base::radioPowerUp(void)
+{
+    SI4735_TRACE_SCOPE("radioPowerUp");
+
+    sendCommand<POWER_UP>(powerUp.raw); // Content of ARG1 and ARG2
+    waitToSend();
+    fixedWait(POWER_UP, maxDelayAfterPowerUp);
+
+    if (this->currentClockType == XOSCEN_RCLK)
+    {
+        setRefClock(this->refClock);
+        setRefClockPrescaler(this->refClockPrescale, this->refClockSourcePin);
+    }
+}
+
+/**
+ * @ingroup group07 Device Power Down
+ *
+ * @brief Moves the device from powerup to powerdown mode.
+ *
+ * @details After Power Down command, only the Power Up command is accepted.
+ *
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 67, 132
+ * @see radioPowerUp()
+ */
+void SI4735Base::powerDown(void)
+{
+    SI4735_TRACE_SCOPE("powerDown");
+
+    sendCommand<POWER_DOWN>();
+    waitToSend();
+}
+
 /**
  * @ingroup group07 Firmware Information
  *
@@ -388,20 +798,8 @@ void SI4735Base::analogPowerUp(void)
  */
 void SI4735Base::getFirmware(void)
 {
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(GET_REV);
-    i2c.endTransmission();
-
-    do
-    {
-        waitToSend();
-        // Request for 9 bytes response
-        i2c.requestFrom(deviceAddress, 9);
-        for (int i = 0; i < 9; i++)
-            firmwareInfo.raw[i] = i2c.read();
-    } while (firmwareInfo.resp.ERR);
+    // Request for 9 bytes response. If error, try it again (see setRetryPolicy).
+    transactRetry<GET_REV>(firmwareInfo.raw);
 }
 
 /**
@@ -480,7 +878,51 @@ void SI4735Base::setRefClockPrescaler(uint16_t prescale, uint8_t rclk_sel)
 void SI4735Base::setup(uint8_t resetPin, uint8_t defaultFunction)
 {
     setup(resetPin, 0, defaultFunction, SI473X_ANALOG_AUDIO, XOSCEN_CRYSTAL, 0);
-    clock.wait(250);
+    fixedWait(POWER_UP, 250);
+}
+
+/**
+ * @ingroup   group07 Device start up
+ *
+ * @brief Starts the Si473X device.
+ *
+ * @details Portable version: no reset pin and no external mute circuit (see SI4735Arduino::setup for those).
+ * @details It is used by host builds, where the device is reached only through the I2C and Clock interfaces.
+ *
+ * @param resetPin not used (kept for compatibility).
+ * @param ctsIntEnable CTS Interrupt Enable.
+ * @param defaultFunction is the mode you want the receiver starts.
+ * @param audioMode default SI473X_ANALOG_AUDIO (Analog Audio). Use SI473X_ANALOG_AUDIO or SI473X_DIGITAL_AUDIO.
+ * @param clockType 0 = Use external RCLK (crystal oscillator disabled); 1 = Use crystal oscillator
+ * @param gpo2Enable GPO2OE (GPO2 Output) 1 = Enable; 0 Disable (defult)
+ */
+void SI4735Base::setup(uint8_t resetPin, uint8_t ctsIntEnable, uint8_t defaultFunction, uint8_t audioMode, uint8_t clockType, uint8_t gpo2Enable)
+{
+    this->resetPin = resetPin;
+    this->ctsIntEnable = (ctsIntEnable != 0) ? 1 : 0;
+    this->gpo2Enable = gpo2Enable;
+    this->currentAudioMode = audioMode;
+
+    setPowerUp(ctsIntEnable, gpo2Enable, 0, clockType, defaultFunction, audioMode);
+
+    reset();
+
+    radioPowerUp();
+    setVolume(30); // Default volume level.
+    getFirmware();
+}
+
+/**
+ * @ingroup group06 RESET
+ *
+ * @brief Reset the SI473X
+ *
+ * @details Portable version: there is no reset pin, so only the library state that depends on the device is cleared.
+ * @details The device itself gets back to its defaults with the POWER_DOWN / POWER_UP sequence.
+ */
+void SI4735Base::reset()
+{
+    invalidatePropertyCache();
 }
 
 /** @defgroup group08 Tune, Device Mode and Filter setup */
@@ -505,8 +947,27 @@ void SI4735Base::setup(uint8_t resetPin, uint8_t defaultFunction)
  *                       ANTCAP manual range is 1–6143;
  *                  FM - the valid range is 0 to 191.
  *                  According to Silicon Labs, automatic capacitor tuning is recommended (value 0).
+ *                  With a calibration table attached to the current mode (setAntennaCapacitorTable), it is used only
+ *                  outside the calibrated segments.
  */
 void SI4735Base::setTuneFrequencyAntennaCapacitor(uint16_t capacitor)
+{
+    uint8_t slot = antCapSlot();
+
+    if (slot < 2 && antCapTable[slot] != NULL)
+        antCapFallback[slot] = capacitor;
+    setAntennaCapacitorArgs(capacitor);
+    // Tune the device again with the current frequency.
+    this->setFrequency(this->currentWorkFrequency);
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Sets the antenna capacitor arguments of the tune command (currentFrequencyParams) without tuning.
+ * @see setTuneFrequencyAntennaCapacitor
+ */
+void SI4735Base::setAntennaCapacitorArgs(uint16_t capacitor)
 {
     si47x_antenna_capacitor cap;
 
@@ -521,60 +982,296 @@ void SI4735Base::setTuneFrequencyAntennaCapacitor(uint16_t capacitor)
     }
     else
     {
-        if (capacitor <= 6143)
+        if (capacitor <= 6143)
+        {
+            currentFrequencyParams.arg.FREEZE = 0; // This parameter is not used for AM
+            currentFrequencyParams.arg.ANTCAPH = cap.raw.ANTCAPH;
+            currentFrequencyParams.arg.ANTCAPL = cap.raw.ANTCAPL;
+        }
+    }
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Returns the antenna capacitor argument of the tune command (FM: ARG4; AM: ARG4 and ARG5).
+ */
+uint16_t SI4735Base::getAntennaCapacitorArgs()
+{
+    if (currentTune != AM_TUNE_FREQ)
+        return currentFrequencyParams.arg.ANTCAPH;
+    return ((uint16_t)currentFrequencyParams.arg.ANTCAPH << 8) | currentFrequencyParams.arg.ANTCAPL;
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Finds the antenna capacitor of each frequency segment of a band and attaches the table to the current mode.
+ *
+ * @details The automatic capacitor search of the chip runs on every tune and adds latency; on a known antenna a table
+ * @details of fixed values skips it. For each segment, the varactor is swept from capFrom to capTo on the channel in the
+ * @details middle of the segment (FAST tune, STCINT, RSQ read, like scanBand) and the value with the highest RSSI (then SNR)
+ * @details is kept. With capStep above 1, a second sweep around the best value refines it in steps of capStep / 8.
+ * @details Adjacent segments with the same capacitor share one entry, and an entry of capacitor 0 closes the table after
+ * @details "to", so the table is sorted and compact. The table is attached (setAntennaCapacitorTable), given to the store
+ * @details function (setAntennaCapacitorStore) and the receiver tunes back to the frequency it was on.
+ * @details The sweep needs a signal: a strong station or a signal generator near each segment, or at least band noise.
+ * @details FM uses the capacitor only with the antenna on the TXO/LPI pin; AM only on MW and LW (SW needs 1).
+ * @details Each step is one tune (about 20 ms on FM): the FM band (21 segments of 1 MHz, capStep 8) takes about 20 s.
+ * @code
+ *   si4735_antcap_entry fmTable[22];
+ *
+ *   rx.setFM(8750, 10800, 10390, 10);
+ *   rx.calibrateAntennaCapacitor(8750, 10800, 100, fmTable, 22, 8); // 1 MHz segments
+ * @endcode
+ *
+ * @see setAntennaCapacitorTable, setAntennaCapacitorStore, lookupAntennaCapacitor, si4735_antcap_entry
+ *
+ * @param from first frequency of the band.
+ * @param to last frequency of the band.
+ * @param segment width of the segments.
+ * @param table entries; (to - from) / segment + 2 always suffice.
+ * @param size number of entries table can take.
+ * @param capStep capacitor step of the first sweep.
+ * @param capFrom smallest capacitor tried (at least 1).
+ * @param capTo largest capacitor tried; 0 is the limit of the mode (FM 191; AM 6143).
+ * @return uint16_t entries written (0 on NBFM or with invalid arguments).
+ */
+uint16_t SI4735Base::calibrateAntennaCapacitor(uint16_t from, uint16_t to, uint16_t segment, si4735_antcap_entry *table,
+                                               uint16_t size, uint16_t capStep, uint16_t capFrom, uint16_t capTo)
+{
+    SI4735_TRACE_SCOPE("calibrateAntennaCapacitor");
+
+    uint8_t slot = antCapSlot();
+    uint8_t fast = currentFrequencyParams.arg.FAST;
+    uint16_t listening = currentWorkFrequency;
+    uint16_t limit = (slot == 0) ? 191 : 6143;
+    uint16_t fine, best, low, high, capacitor;
+    uint16_t n = 0;
+    uint32_t center, settle = 0;
+    si47x_scan_record peak;
+
+    if (capFrom == 0)
+        capFrom = 1;
+    if (capTo == 0 || capTo > limit)
+        capTo = limit;
+    if (slot > 1 || segment == 0 || size == 0 || from > to || capFrom > capTo)
+        return 0;
+    if (capStep == 0)
+        capStep = 1;
+    fine = (capStep >= 8) ? capStep / 8 : 1;
+
+    setAntennaCapacitorTable(NULL, 0); // Back to the capacitor in use before any table
+    capacitor = getAntennaCapacitorArgs();
+    currentFrequencyParams.arg.FAST = 1;
+    for (uint32_t start = from; start <= to && n < size; start += segment)
+    {
+        center = start + ((currentStep != 0) ? (segment / 2) / currentStep * currentStep : segment / 2);
+        if (center > to)
+            center = to;
+
+        peak.rssi = peak.snr = 0;
+        best = sweepAntennaCapacitor((uint16_t)center, capFrom, capTo, capStep, capFrom, &settle, &peak);
+        if (capStep > 1)
+        {
+            low = (best > capFrom + capStep) ? best - capStep + fine : capFrom;
+            high = (best + capStep < capTo) ? best + capStep - fine : capTo;
+            best = sweepAntennaCapacitor((uint16_t)center, low, high, fine, best, &settle, &peak);
+        }
+
+        if (n > 0 && table[n - 1].capacitor == best)
+        {
+            // Same capacitor as the previous segment: extend its entry
+            if (peak.rssi > table[n - 1].rssi)
+            {
+                table[n - 1].rssi = peak.rssi;
+                table[n - 1].snr = peak.snr;
+            }
+            continue;
+        }
+        table[n].frequency = (uint16_t)start;
+        table[n].capacitor = best;
+        table[n].rssi = peak.rssi;
+        table[n].snr = peak.snr;
+        n++;
+    }
+    if (n < size && to < 0xFFFF)
+    {
+        table[n].frequency = to + 1;
+        table[n].capacitor = table[n].rssi = table[n].snr = 0;
+        n++;
+    }
+    currentFrequencyParams.arg.FAST = fast;
+    setAntennaCapacitorArgs(capacitor);
+
+    setAntennaCapacitorTable(table, n);
+    if (antCapStore != NULL)
+        antCapStore(currentTune, table, n);
+    setFrequency(listening);
+    return n;
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Tunes freq with each capacitor from "from" to "to" and returns the one with the highest RSSI (then SNR).
+ * @details peak is the measure of best; a capacitor replaces best only if it measures better than peak.
+ * @see calibrateAntennaCapacitor
+ */
+uint16_t SI4735Base::sweepAntennaCapacitor(uint16_t freq, uint16_t from, uint16_t to, uint16_t step, uint16_t best,
+                                           uint32_t *settle, si47x_scan_record *peak)
+{
+    si47x_scan_record record;
+
+    for (uint32_t capacitor = from; capacitor <= to; capacitor += step)
+    {
+        setAntennaCapacitorArgs((uint16_t)capacitor);
+        if (!measureChannel(freq, settle, 0, 1, &record))
+            continue;
+        if (record.rssi > peak->rssi || (record.rssi == peak->rssi && record.snr > peak->snr))
+        {
+            *peak = record;
+            best = (uint16_t)capacitor;
+        }
+    }
+    return best;
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Attaches an antenna capacitor table to the current mode (FM, or AM and SSB).
+ *
+ * @details From the next tune, setFrequency (and beginTune, frequencyUp, scanBand...) sends the capacitor of the segment of
+ * @details the frequency instead of letting the chip search it. Outside the segments, and on entries of capacitor 0, the
+ * @details capacitor in use when the table was attached is sent (see setTuneFrequencyAntennaCapacitor).
+ * @details Each mode keeps its table across setFM/setAM. The table is not copied: it must outlive its use.
+ * @code
+ *   static si4735_antcap_entry fmTable[22];
+ *   uint16_t count = loadTable(fmTable, 22); // Saved by the store function of setAntennaCapacitorStore
+ *
+ *   rx.setFM(8750, 10800, 10390, 10);
+ *   rx.setAntennaCapacitorTable(fmTable, count);
+ * @endcode
+ *
+ * @see calibrateAntennaCapacitor, lookupAntennaCapacitor, si4735_antcap_entry
+ *
+ * @param table entries sorted by frequency; NULL detaches the table of the current mode.
+ * @param count number of entries.
+ */
+void SI4735Base::setAntennaCapacitorTable(const si4735_antcap_entry *table, uint16_t count)
+{
+    uint8_t slot = antCapSlot();
+
+    if (slot > 1)
+        return;
+    if (antCapTable[slot] == NULL)
+        antCapFallback[slot] = getAntennaCapacitorArgs();
+    else if (table == NULL || count == 0)
+        setAntennaCapacitorArgs(antCapFallback[slot]);
+    antCapTable[slot] = (count != 0) ? table : NULL;
+    antCapCount[slot] = (table != NULL) ? count : 0;
+    antCapCached[slot] = 0;
+}
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Returns the antenna capacitor the table of the current mode gives to a frequency.
+ *
+ * @details The entry of the last lookup is checked first, so tunes inside the same segment (frequencyUp, frequencyDown)
+ * @details do not search; otherwise it is a binary search, O(log n).
+ *
+ * @see setAntennaCapacitorTable
+ *
+ * @param freq frequency (same unit as setFrequency).
+ * @return uint16_t capacitor; without a table, the capacitor that the next tune sends.
+ */
+uint16_t SI4735Base::lookupAntennaCapacitor(uint16_t freq)
+{
+    uint8_t slot = antCapSlot();
+    const si4735_antcap_entry *table;
+    uint16_t count, i, low, high, middle;
+
+    if (slot > 1 || antCapTable[slot] == NULL)
+        return getAntennaCapacitorArgs();
+    table = antCapTable[slot];
+    count = antCapCount[slot];
+    if (freq < table[0].frequency)
+        return antCapFallback[slot];
+
+    i = antCapCached[slot];
+    if (i >= count || freq < table[i].frequency || (i + 1 < count && freq >= table[i + 1].frequency))
+    {
+        // table[low].frequency <= freq < table[high].frequency (high == count is the end of the band)
+        low = 0;
+        high = count;
+        while (high - low > 1)
         {
-            currentFrequencyParams.arg.FREEZE = 0; // This parameter is not used for AM
-            currentFrequencyParams.arg.ANTCAPH = cap.raw.ANTCAPH;
-            currentFrequencyParams.arg.ANTCAPL = cap.raw.ANTCAPL;
+            middle = low + (high - low) / 2;
+            if (table[middle].frequency <= freq)
+                low = middle;
+            else
+                high = middle;
         }
+        i = antCapCached[slot] = low;
     }
-    // Tune the device again with the current frequency.
-    this->setFrequency(this->currentWorkFrequency);
+    return (table[i].capacitor != 0) ? table[i].capacitor : antCapFallback[slot];
 }
 
 /**
  * @ingroup   group08 Tune Frequency
  *
- * @brief Set the frequency to the corrent function of the Si4735 (FM, AM or SSB)
+ * @brief Prepares the arguments (currentFrequencyParams) of the tune command for a given frequency.
  *
- * @details You have to call setup or setPowerUp before call setFrequency.
+ * @details ARG1 has the FAST and FREEZE information (if not FM must be 0). ARG2 to ARG4 (ARG5 if AM or SSB) frequency and antenna capacitor.
  *
- * @see maxDelaySetFrequency()
- * @see MAX_DELAY_AFTER_SET_FREQUENCY
- * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 70, 135
- * @see AN332 REV 0.8 UNIVERSAL PROGRAMMING GUIDE; page 13
+ * @see setFrequency, beginTune
  *
- * @param uint16_t  freq is the frequency to change. For example, FM => 10390 = 103.9 MHz; AM => 810 = 810 kHz.
+ * @param freq frequency to tune.
+ * @return uint8_t number of arguments of the tune command (currentTune).
  */
-void SI4735Base::setFrequency(uint16_t freq)
+uint8_t SI4735Base::prepareTune(uint16_t freq)
 {
-    waitToSend(); // Wait for the si473x is ready.
     currentFrequency.value = freq;
     currentFrequencyParams.arg.FREQH = currentFrequency.raw.FREQH;
     currentFrequencyParams.arg.FREQL = currentFrequency.raw.FREQL;
+    currentFrequencyParams.arg.USBLSB = currentSsbStatus; // LSB or USB; 0 (reserved bits) on AM and FM
 
     if (currentSsbStatus != 0)
     {
         currentFrequencyParams.arg.DUMMY1 = 0;
-        currentFrequencyParams.arg.USBLSB = currentSsbStatus; // Set to LSB or USB
         currentFrequencyParams.arg.FAST = 1;                  // Used just on AM and FM
         currentFrequencyParams.arg.FREEZE = 0;                // Used just on FM
     }
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(currentTune);
-    i2c.write(currentFrequencyParams.raw[0]); // Send a byte with FAST and  FREEZE information; if not FM must be 0;
-    i2c.write(currentFrequencyParams.arg.FREQH);
-    i2c.write(currentFrequencyParams.arg.FREQL);
-    i2c.write(currentFrequencyParams.arg.ANTCAPH);
     // If current tune is not FM sent one more byte
-    if (currentTune == AM_TUNE_FREQ) // if AM or SSB
-        i2c.write(currentFrequencyParams.arg.ANTCAPL);
+    return (currentTune == AM_TUNE_FREQ) ? 5 : 4;
+}
 
-    i2c.endTransmission();
+/**
+ * @ingroup   group08 Tune Frequency
+ *
+ * @brief Set the frequency to the corrent function of the Si4735 (FM, AM or SSB)
+ *
+ * @details You have to call setup or setPowerUp before call setFrequency.
+ *
+ * @see maxDelaySetFrequency()
+ * @see MAX_DELAY_AFTER_SET_FREQUENCY
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 70, 135
+ * @see AN332 REV 0.8 UNIVERSAL PROGRAMMING GUIDE; page 13
+ *
+ * @param uint16_t  freq is the frequency to change. For example, FM => 10390 = 103.9 MHz; AM => 810 = 810 kHz.
+ */
+void SI4735Base::setFrequency(uint16_t freq)
+{
+    SI4735_TRACE_SCOPE("setFrequency");
+
+    applyAntennaCapacitor(freq); // Calibration table (see setAntennaCapacitorTable), if any
+    sendCommand(currentTune, prepareTune(freq), currentFrequencyParams.raw);
     waitToSend();                // Wait for the si473x is ready.
     currentWorkFrequency = freq; // check it
-    clock.wait(maxDelaySetFrequency); // For some reason I need to delay here.
+    waitTuneComplete();          // Waits for STCINT (see setTuneWait); at most maxDelaySetFrequency.
 }
 
 /**
@@ -625,6 +1322,8 @@ void SI4735Base::frequencyDown()
  */
 void SI4735Base::setAM()
 {
+    SI4735_TRACE_SCOPE("setAM");
+
     // If you’re already using AM mode, it is not necessary to call powerDown and radioPowerUp.
     // The other properties also should have the same value as the previous status.
     if (lastMode != AM_CURRENT_MODE)
@@ -650,12 +1349,14 @@ void SI4735Base::setAM()
  */
 void SI4735Base::setFM()
 {
+    SI4735_TRACE_SCOPE("setFM");
+
     powerDown();
     setPowerUp(this->ctsIntEnable, this->gpo2Enable, 0, this->currentClockType, FM_CURRENT_MODE, this->currentAudioMode);
     radioPowerUp();
     setVolume(volume); // Set to previus configured volume
-    currentSsbStatus = 0;
     disableFmDebug();
+    currentSsbStatus = 0;
     lastMode = FM_CURRENT_MODE;
 }
 
@@ -755,7 +1456,6 @@ void SI4735Base::setFM(uint16_t fromFreq, uint16_t toFreq, uint16_t initialFreq,
 void SI4735Base::setBandwidth(uint8_t AMCHFLT, uint8_t AMPLFLT)
 {
     si47x_bandwidth_config filter;
-    si47x_property property;
 
     if (currentTune != AM_TUNE_FREQ) // Only for AM/SSB mode
         return;
@@ -765,21 +1465,10 @@ void SI4735Base::setBandwidth(uint8_t AMCHFLT, uint8_t AMPLFLT)
 
     filter.raw[0] = filter.raw[1] = 0;
 
-    property.value = AM_CHANNEL_FILTER;
-
     filter.param.AMCHFLT = AMCHFLT;
     filter.param.AMPLFLT = AMPLFLT;
 
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);                  // Always 0x00
-    i2c.write(property.raw.byteHigh); // High byte first
-    i2c.write(property.raw.byteLow);  // Low byte after
-    i2c.write(filter.raw[1]);         // Raw data for AMCHFLT and
-    i2c.write(filter.raw[0]);         // AMPLFLT
-    i2c.endTransmission();
-    waitToSend();
+    sendProperty(AM_CHANNEL_FILTER, (filter.raw[1] << 8) | filter.raw[0]); // Raw data for AMPLFLT (high byte) and AMCHFLT (low byte)
 }
 
 /**
@@ -796,8 +1485,7 @@ uint16_t SI4735Base::getFrequency()
     si47x_frequency freq;
     getStatus(0, 1);
 
-    freq.raw.FREQL = currentStatus.resp.READFREQL;
-    freq.raw.FREQH = currentStatus.resp.READFREQH;
+    freq.value = getStatusView().frequency();
 
     currentWorkFrequency = freq.value;
     return freq.value;
@@ -829,26 +1517,12 @@ void SI4735Base::getStatus(uint8_t INTACK, uint8_t CANCEL)
         limitResp = 6;
     }
 
-    waitToSend();
-
     status.arg.INTACK = INTACK;
     status.arg.CANCEL = CANCEL;
     status.arg.RESERVED2 = 0;
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(cmd);
-    i2c.write(status.raw);
-    i2c.endTransmission();
-    // Reads the current status (including current frequency).
-    do
-    {
-        waitToSend();
-        i2c.requestFrom(deviceAddress, limitResp); // Check it
-        // Gets response information
-        for (uint8_t i = 0; i < limitResp; i++)
-            currentStatus.raw[i] = i2c.read();
-    } while (currentStatus.resp.ERR); // If error, try it again
-    waitToSend();
+    // Reads the current status (including current frequency). If error, try it again (see setRetryPolicy).
+    transactRetry(cmd, &status.raw, 1, currentStatus.raw, limitResp);
 }
 
 /**
@@ -879,19 +1553,8 @@ void SI4735Base::getAutomaticGainControl()
         cmd = AM_AGC_STATUS;
     }
 
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(cmd);
-    i2c.endTransmission();
-
-    do
-    {
-        waitToSend();
-        i2c.requestFrom(deviceAddress, 3);
-        currentAgcStatus.raw[0] = i2c.read(); // STATUS response
-        currentAgcStatus.raw[1] = i2c.read(); // RESP 1
-        currentAgcStatus.raw[2] = i2c.read(); // RESP 2
-    } while (currentAgcStatus.refined.ERR);    // If error, try get AGC status again.
+    // STATUS response, RESP 1 and RESP 2. If error, try get AGC status again (see setRetryPolicy).
+    transactRetry(cmd, NULL, 0, currentAgcStatus.raw, 3);
 }
 
 /**
@@ -929,13 +1592,7 @@ void SI4735Base::setAutomaticGainControl(uint8_t AGCDIS, uint8_t AGCIDX)
     agc.arg.AGCDIS = AGCDIS;
     agc.arg.AGCIDX = AGCIDX;
 
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(cmd);
-    i2c.write(agc.raw[0]);
-    i2c.write(agc.raw[1]);
-    i2c.endTransmission();
+    sendCommand(cmd, 2, agc.raw);
 
     waitToSend();
 }
@@ -994,23 +1651,8 @@ void SI4735Base::getCurrentReceivedSignalQuality(uint8_t INTACK)
         sizeResponse = 6; // Check it
     }
 
-    waitToSend();
-
     arg = INTACK;
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(cmd);
-    i2c.write(arg); // send B00000001
-    i2c.endTransmission();
-
-    // Check it
-    // do
-    //{
-    waitToSend();
-    i2c.requestFrom(deviceAddress, sizeResponse);
-    // Gets response information
-    for (uint8_t i = 0; i < sizeResponse; i++)
-        currentRqsStatus.raw[i] = i2c.read();
-    //} while (currentRqsStatus.resp.ERR); // Try again if error found
+    transact(cmd, &arg, 1, currentRqsStatus.raw, sizeResponse); // send B00000001
 }
 
 /**
@@ -1029,49 +1671,239 @@ void SI4735Base::getCurrentReceivedSignalQuality(void)
     getCurrentReceivedSignalQuality(0);
 }
 
+/**
+ * @ingroup group08 Received Signal Quality
+ *
+ * @brief Measures the signal quality of a range of channels.
+ *
+ * @details Tunes each channel from "from" to "to" with the FAST bit set (no accurate tune status is needed to read the RSQ)
+ * @details and the capacitor of the antenna capacitor table, if one is attached (see setAntennaCapacitorTable), waits for
+ * @details STCINT and reads FM_RSQ_STATUS or AM_RSQ_STATUS into out. There is no fixed delay per channel: the
+ * @details wait before the first STCINT poll is the settle time of the previous channel (the first channel is polled
+ * @details right away), so a survey costs about one fast tune, one STCINT poll and one RSQ read per channel.
+ * @details Optionally each channel can be observed longer: dwell uS after STCINT before the first read, and averaging
+ * @details RSQ reads whose values are averaged into the record.
+ * @details The FAST bit of setTuneFrequencyFast is restored at the end. The receiver stays on the last channel scanned;
+ * @details call setFrequency to go back to the listening frequency.
+ * @code
+ *   si47x_scan_record band[206];
+ *   uint16_t n = rx.scanBand(8750, 10800, 10, band, 206);
+ *   for (uint16_t i = 0; i < n; i++)
+ *       if (band[i].rssi > 30)
+ *           addStation(band[i].frequency);
+ *   rx.setFrequency(listening);
+ * @endcode
+ *
+ * @see getCurrentReceivedSignalQuality, setTuneFrequencyFast, si47x_scan_record
+ *
+ * @param from first channel (same unit as setFrequency).
+ * @param to last channel.
+ * @param step channel spacing.
+ * @param out records, one per channel.
+ * @param size number of records out can take.
+ * @param dwell time (uS) on each channel after STCINT, before the first RSQ read.
+ * @param averaging RSQ reads per channel (1 to 255).
+ * @return uint16_t number of records written. A channel whose RSQ could not be read (CTS timeout or ERR) is left out.
+ */
+uint16_t SI4735Base::scanBand(uint16_t from, uint16_t to, uint16_t step, si47x_scan_record *out, uint16_t size, uint16_t dwell,
+                              uint8_t averaging)
+{
+    SI4735_TRACE_SCOPE("scanBand");
+
+    uint8_t fast = currentFrequencyParams.arg.FAST;
+    uint32_t settle = 0; // Settle time of the previous channel (uS)
+    uint16_t n = 0;
+
+    if (step == 0)
+        return 0;
+    if (averaging == 0)
+        averaging = 1;
+
+    currentFrequencyParams.arg.FAST = 1;
+    for (uint32_t freq = from; freq <= to && n < size; freq += step)
+        if (measureChannel((uint16_t)freq, &settle, dwell, averaging, &out[n]))
+            n++;
+    currentFrequencyParams.arg.FAST = fast;
+    return n;
+}
+
+/**
+ * @ingroup group08 Received Signal Quality
+ *
+ * @brief Tunes one channel with the current tune arguments, waits for STCINT and reads the RSQ into record.
+ *
+ * @details settle is the wait before the first STCINT poll; it is updated with the settle time of this channel, so a run
+ * @details of channels polls about once per channel. Only the RSQ reads that succeed are averaged.
+ *
+ * @see scanBand, calibrateAntennaCapacitor
+ *
+ * @return false if the tune did not complete or no RSQ read succeeded (see getLastError); record is not written then.
+ */
+bool SI4735Base::measureChannel(uint16_t freq, uint32_t *settle, uint16_t dwell, uint8_t averaging, si47x_scan_record *record)
+{
+    uint8_t cmd = (currentTune == FM_TUNE_FREQ) ? FM_RSQ_STATUS : (currentTune == NBFM_TUNE_FREQ) ? NBFM_RSQ_STATUS : AM_RSQ_STATUS;
+    uint8_t sizeResponse = (cmd == AM_RSQ_STATUS) ? 6 : 8;
+    uint32_t limit = (uint32_t)maxDelaySetFrequency * 1000;
+    uint32_t waited;
+    uint8_t arg = 0;
+    uint16_t rssi = 0, snr = 0, multipath = 0;
+    int16_t offset = 0;
+    uint8_t reads = 0;
+    bool polled;
+
+    applyAntennaCapacitor(freq); // Calibration table, if any (calibrateAntennaCapacitor detaches it while it sweeps)
+    sendCommand(currentTune, prepareTune(freq), currentFrequencyParams.raw);
+    waitToSend();
+    if (!waitStc(*settle, limit, &waited, &polled))
+        return false; // Not settled: no measure
+    // Got STCINT at the first poll: the channel may settle faster, so try 1/16 less next time.
+    *settle = polled ? waited : waited - (waited >> 4);
+    if (dwell)
+        clock.waitMicroseconds(dwell);
+
+    currentWorkFrequency = freq;
+    for (uint8_t i = 0; i < averaging; i++)
+    {
+        if (!transact(cmd, &arg, 1, currentRqsStatus.raw, sizeResponse))
+            continue; // The response holds no measure
+        reads++;
+        si47x_rsq_view rsq = getRsqView();
+        rssi += rsq.rssi();
+        snr += rsq.snr();
+        if (sizeResponse == 8)
+        {
+            multipath += rsq.mult();
+            offset += rsq.freqoff();
+        }
+    }
+    if (reads == 0)
+        return false;
+    record->frequency = freq;
+    record->rssi = (uint8_t)(rssi / reads);
+    record->snr = (uint8_t)(snr / reads);
+    record->multipath = (uint8_t)(multipath / reads);
+    record->offset = (int8_t)(offset / reads);
+    return true;
+}
+
 /**
  * @ingroup group08 Seek
  *
  * @brief Look for a station (Automatic tune)
  * @details Starts a seek process for a channel that meets the RSSI and SNR criteria for AM.
+ * @details Returns when the device completes the seek (STCINT) or after maxSeekTime; getCurrentFrequency returns the
+ * @details station found.
  * @details __This function does not work on SSB mode__.
  * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 55, 72, 125 and 137
+ * @see waitSeekComplete, setMaxSeekTime
  *
  * @param SEEKUP Seek Up/Down. Determines the direction of the search, either UP = 1, or DOWN = 0.
  * @param Wrap/Halt. Determines whether the seek should Wrap = 1, or Halt = 0 when it hits the band limit.
  */
 void SI4735Base::seekStation(uint8_t SEEKUP, uint8_t WRAP)
 {
-    si47x_seek seek;
-    si47x_seek_am_complement seek_am_complement;
+    SI4735_TRACE_SCOPE("seekStation");
 
-    // Check which FUNCTION (AM or FM) is working now
-    uint8_t seek_start_cmd = (currentTune == FM_TUNE_FREQ) ? FM_SEEK_START : AM_SEEK_START;
-
-    waitToSend();
+    startSeek(SEEKUP, WRAP);
+    waitSeekComplete(NULL, NULL);
+}
 
-    seek.arg.SEEKUP = SEEKUP;
-    seek.arg.WRAP = WRAP;
-    seek.arg.RESERVED1 = 0;
-    seek.arg.RESERVED2 = 0;
+/**
+ * @ingroup group08 Seek
+ *
+ * @brief Sends FM_SEEK_START or AM_SEEK_START (depending on currentTune) without waiting for the end of the seek.
+ * @see seekStation, waitSeekComplete
+ */
+void SI4735Base::startSeek(uint8_t SEEKUP, uint8_t WRAP)
+{
+    uint8_t arg[5];
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(seek_start_cmd);
-    i2c.write(seek.raw); // ARG1
+    sendCommand((currentTune == FM_TUNE_FREQ) ? FM_SEEK_START : AM_SEEK_START, prepareSeek(SEEKUP, WRAP, arg), arg);
+}
 
-    if (seek_start_cmd == AM_SEEK_START) // Sets additional configuration for AM mode
+/**
+ * @ingroup group08 Seek
+ *
+ * @brief Waits for the end of the seek in progress (STCINT) and reads the station found.
+ *
+ * @details Polls STCINT with GET_INT_STATUS (one write and one status read) and a backoff that doubles up to
+ * @details MAX_DELAY_SEEK_POLL, so the seek ends at most MAX_DELAY_SEEK_POLL after the device completes it; there is no
+ * @details fixed delay. With an interrupt line
+ * @details (setInterruptLine, which also serves the CTS waits), each backoff step blocks on the line instead of sleeping:
+ * @details enable the STC interrupt (STCIEN in setGpioIen) and the seek ends as soon as the line signals.
+ * @details Every seekProgressInterval ms (see setSeekProgressInterval) the frequency being checked is read (tune status
+ * @details without INTACK) and passed to showFunc, then stopSeeking is asked whether to stop. A stopped seek, or one
+ * @details longer than maxSeekTime, is cancelled: the device stays on the frequency it was checking.
+ * @details At the end, the tune status is read with INTACK, currentWorkFrequency is updated and showFunc gets the final
+ * @details frequency.
+ *
+ * @see seekStation, seekStationProgress, setMaxSeekTime, setSeekProgressInterval
+ *
+ * @param showFunc function that shows the frequency; NULL for no progress report.
+ * @param stopSeeking function that returns true to stop the seek; NULL if the seek cannot be stopped.
+ * @return true if the device completed the seek; false if it was stopped or timed out.
+ */
+bool SI4735Base::waitSeekComplete(void (*showFunc)(uint16_t f), bool (*stopSeeking)())
+{
+    uint8_t cmd = (currentTune == FM_TUNE_FREQ) ? FM_SEEK_START : AM_SEEK_START;
+    unsigned long start = clock.now();
+    unsigned long report = start;
+    uint16_t delay = ctsPollMaxDelay;
+    bool progress = (showFunc != NULL || stopSeeking != NULL) && seekProgressInterval != 0;
+    bool done;
+
+    SI4735_TRACE_BEGIN("stc", TRACE_STC, cmd);
+    waitToSend(); // The seek command was accepted: every poll below leaves the device clear to send
+    for (;;)
     {
-        seek_am_complement.ARG2 = seek_am_complement.ARG3 = 0;
-        seek_am_complement.ANTCAPH = 0;
-        seek_am_complement.ANTCAPL = (currentWorkFrequency > 1800) ? 1 : 0; // if SW = 1
-        i2c.write(seek_am_complement.ARG2);                                // ARG2 - Always 0
-        i2c.write(seek_am_complement.ARG3);                                // ARG3 - Always 0
-        i2c.write(seek_am_complement.ANTCAPH);                             // ARG4 - Tuning Capacitor: The tuning capacitor value
-        i2c.write(seek_am_complement.ANTCAPL);                             // ARG5 - will be selected automatically.
+        writeCommand(GET_INT_STATUS, 0, NULL);
+        pendingCommand = GET_INT_STATUS;
+        waitToSend();
+        if ((done = currentStatusByte.raw & 0B00000001)) // STCINT
+            break;
+        if ((clock.now() - start) >= maxSeekTime)
+            break;
+        if (progress && (clock.now() - report) >= seekProgressInterval)
+        {
+            report = clock.now();
+            getStatus(0, 0);
+            currentWorkFrequency = getStatusView().frequency();
+            if (showFunc != NULL)
+                showFunc(currentWorkFrequency);
+            if (stopSeeking != NULL && stopSeeking())
+                break;
+        }
+        if (interruptLine != NULL)
+            interruptLine->wait(delay); // Returns early when the STC interrupt signals
+        else
+            clock.waitMicroseconds(delay);
+        SI4735_STATS_ADD(cmd, stcWaitTime, delay);
+        delay = Protocol::nextDelay(delay, MAX_DELAY_SEEK_POLL);
     }
+    SI4735_TRACE_END();
 
-    i2c.endTransmission();
-    clock.wait(MAX_DELAY_AFTER_SET_FREQUENCY << 2);
+    getStatus(1, done ? 0 : 1); // INTACK; CANCEL if the seek is still running
+    currentWorkFrequency = getStatusView().frequency();
+    if (showFunc != NULL)
+        showFunc(currentWorkFrequency);
+    return done;
+}
+
+/**
+ * @ingroup group08 Seek
+ *
+ * @brief Prepares the arguments of the seek command (FM_SEEK_START or AM_SEEK_START, depending on currentTune).
+ *
+ * @see seekStation, beginSeek
+ *
+ * @param SEEKUP Seek Up/Down. Determines the direction of the search, either UP = 1, or DOWN = 0.
+ * @param WRAP Wrap/Halt. Determines whether the seek should Wrap = 1, or Halt = 0 when it hits the band limit.
+ * @param arg buffer (5 bytes) that receives the arguments.
+ * @return uint8_t number of arguments.
+ */
+uint8_t SI4735Base::prepareSeek(uint8_t SEEKUP, uint8_t WRAP, uint8_t *arg)
+{
+    return Protocol::seekArgs(currentTune, currentWorkFrequency, SEEKUP, WRAP, arg);
 }
 
 /**
@@ -1086,8 +1918,6 @@ void SI4735Base::seekStation(uint8_t SEEKUP, uint8_t WRAP)
 void SI4735Base::seekNextStation()
 {
     seekStation(1, 1);
-    clock.wait(maxDelaySetFrequency);
-    getFrequency();
 }
 
 /**
@@ -1101,8 +1931,6 @@ void SI4735Base::seekNextStation()
 void SI4735Base::seekPreviousStation()
 {
     seekStation(0, 1);
-    clock.wait(maxDelaySetFrequency);
-    getFrequency();
 }
 
 /**
@@ -1137,24 +1965,13 @@ void SI4735Base::seekPreviousStation()
  */
 void SI4735Base::seekStationProgress(void (*showFunc)(uint16_t f), uint8_t up_down)
 {
-    si47x_frequency freq;
-    long elapsed_seek = clock.now();
+    SI4735_TRACE_SCOPE("seekStationProgress");
 
     // seek command does not work for SSB
     if (lastMode == SSB_CURRENT_MODE)
         return;
-    do
-    {
-        seekStation(up_down, 0);
-        clock.wait(maxDelaySetFrequency);
-        getStatus(0, 0);
-        clock.wait(maxDelaySetFrequency);
-        freq.raw.FREQH = currentStatus.resp.READFREQH;
-        freq.raw.FREQL = currentStatus.resp.READFREQL;
-        currentWorkFrequency = freq.value;
-        if (showFunc != NULL)
-            showFunc(freq.value);
-    } while (!currentStatus.resp.VALID && !currentStatus.resp.BLTF && (clock.now() - elapsed_seek) < maxSeekTime);
+    startSeek(up_down, 0);
+    waitSeekComplete(showFunc, NULL);
 }
 
 /**
@@ -1192,28 +2009,13 @@ void SI4735Base::seekStationProgress(void (*showFunc)(uint16_t f), uint8_t up_do
  */
 void SI4735Base::seekStationProgress(void (*showFunc)(uint16_t f), bool (*stopSeking)(), uint8_t up_down)
 {
-    si47x_frequency freq;
-    long elapsed_seek = clock.now();
+    SI4735_TRACE_SCOPE("seekStationProgress");
 
     // seek command does not work for SSB
     if (lastMode == SSB_CURRENT_MODE)
         return;
-    do
-    {
-        seekStation(up_down, 0);
-        clock.wait(maxDelaySetFrequency);
-        getStatus(0, 0);
-        clock.wait(maxDelaySetFrequency);
-        freq.raw.FREQH = currentStatus.resp.READFREQH;
-        freq.raw.FREQL = currentStatus.resp.READFREQL;
-        currentWorkFrequency = freq.value;
-        if (showFunc != NULL)
-            showFunc(freq.value);
-        if (stopSeking != NULL)
-            if (stopSeking())
-                return;
-
-    } while (!currentStatus.resp.VALID && !currentStatus.resp.BLTF && (clock.now() - elapsed_seek) < maxSeekTime);
+    startSeek(up_down, 0);
+    waitSeekComplete(showFunc, stopSeking);
 }
 
 /**
@@ -1314,6 +2116,9 @@ void SI4735Base::setSeekFmRssiThreshold(uint16_t value)
  * @brief Sends (sets) property to the SI47XX
  *
  * @details This method is used for others to send generic properties and params to SI47XX
+ * @details Writes of a value the device already has (see the property shadow cache) are skipped.
+ * @details The command is confirmed (CTS and ERR) before the value is cached: a value the device rejected is not cached,
+ * @details and the cache entry of the property is dropped (see getLastError).
  *
  * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 68, 124 and  133.
  * @see setProperty, sendCommand, getProperty, getCommandResponse
@@ -1323,21 +2128,113 @@ void SI4735Base::setSeekFmRssiThreshold(uint16_t value)
  */
 void SI4735Base::sendProperty(uint16_t propertyNumber, uint16_t parameter)
 {
-    si47x_property property;
-    si47x_property param;
+    SI4735_TRACE_SCOPE("setProperty");
 
-    property.value = propertyNumber;
-    param.value = parameter;
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);
-    i2c.write(property.raw.byteHigh); // Send property - High byte - most significant first
-    i2c.write(property.raw.byteLow);  // Send property - Low byte - less significant after
-    i2c.write(param.raw.byteHigh);    // Send the argments. High Byte - Most significant first
-    i2c.write(param.raw.byteLow);     // Send the argments. Low Byte - Less significant after
-    i2c.endTransmission();
-    clock.waitMicroseconds(550);
+    uint8_t arg[5];
+    uint8_t status[1];
+    int16_t idx = findProperty(propertyNumber);
+
+    // The device already has this value: skip the write.
+    if (idx >= 0 && shadowValue[idx] == parameter)
+    {
+        propertyCacheHits++;
+        return;
+    }
+    propertyCacheMisses++;
+
+    Protocol::propertyArgs(propertyNumber, parameter, arg);
+    // No fixed delay here: transact sleeps the predicted SET_PROPERTY time, then polls CTS and checks ERR.
+    if (transact<SET_PROPERTY>(arg, status))
+        storeProperty(propertyNumber, parameter);
+    else
+        forgetProperty(propertyNumber);
+}
+
+/**
+ * @ingroup group10 Generic set and get property
+ *
+ * @brief Looks for a property in the shadow cache.
+ *
+ * @param propertyNumber property number
+ * @return int16_t cache entry index or -1 if the property is not cached.
+ */
+int16_t SI4735Base::findProperty(uint16_t propertyNumber)
+{
+    for (uint8_t i = 0; i < shadowCount; i++)
+        if (shadowProperty[i] == propertyNumber)
+            return i;
+    return -1;
+}
+
+/**
+ * @ingroup group10 Generic set and get property
+ *
+ * @brief Stores a property value in the shadow cache.
+ *
+ * @details When the cache is full, the entries are replaced in round-robin order.
+ *
+ * @param propertyNumber property number
+ * @param value property value
+ */
+void SI4735Base::storeProperty(uint16_t propertyNumber, uint16_t value)
+{
+    int16_t idx = findProperty(propertyNumber);
+
+    if (idx < 0)
+    {
+        if (shadowCount < PROPERTY_CACHE_SIZE)
+            idx = shadowCount++;
+        else
+        {
+            idx = shadowNext;
+            shadowNext = (shadowNext + 1) % PROPERTY_CACHE_SIZE;
+        }
+        shadowProperty[idx] = propertyNumber;
+    }
+    shadowValue[idx] = value;
+}
+
+/**
+ * @ingroup group10 Generic set and get property
+ *
+ * @brief Drops a property from the shadow cache (the value on the device is unknown).
+ *
+ * @param propertyNumber property number
+ */
+void SI4735Base::forgetProperty(uint16_t propertyNumber)
+{
+    int16_t idx = findProperty(propertyNumber);
+
+    if (idx < 0)
+        return;
+    shadowCount--;
+    shadowProperty[idx] = shadowProperty[shadowCount];
+    shadowValue[idx] = shadowValue[shadowCount];
+}
+
+/**
+ * @ingroup group10 Generic set and get property
+ *
+ * @brief Sets a list of properties.
+ *
+ * @details Sends one SET_PROPERTY command per element. Each command waits for its CTS (predicted latency and then
+ * @details polling; see transact) and is checked for ERR, and values the device already has are skipped
+ * @details (see the property shadow cache). There is no fixed delay between the commands.
+ *
+ * @code
+ * const PropertyValue myFm[] = {{FM_DEEMPHASIS, 1}, {FM_SEEK_FREQ_SPACING, 10}, {RX_VOLUME, 45}};
+ * si4735.applyProperties(myFm, myFm + 3);
+ * @endcode
+ *
+ * @see PropertyValue, sendProperty
+ *
+ * @param begin first element of the list
+ * @param end one past the last element of the list
+ */
+void SI4735Base::applyProperties(const PropertyValue *begin, const PropertyValue *end)
+{
+    for (const PropertyValue *p = begin; p < end; p++)
+        sendProperty(p->property, p->value);
 }
 
 /**
@@ -1356,13 +2253,9 @@ void SI4735Base::sendProperty(uint16_t propertyNumber, uint16_t parameter)
 void SI4735Base::sendCommand(uint8_t cmd, int parameter_size, const uint8_t *parameter)
 {
     waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    // Sends the command to the device
-    i2c.write(cmd);
-    // Sends the argments (parameters) of the command
-    for (byte i = 0; i < parameter_size; i++)
-        i2c.write(parameter[i]);
-    i2c.endTransmission();
+    // Sends the command and the argments (parameters) of the command to the device
+    writeCommand(cmd, parameter_size, parameter);
+    pendingCommand = cmd; // waitToSend uses it to predict when the device will be ready
 }
 
 /**
@@ -1405,6 +2298,124 @@ si47x_status SI4735Base::getStatusResponse()
     return status;
 }
 
+/**
+ * @ingroup group10 Generic Command and Response
+ * @brief Sends a command and reads its response in a single transaction.
+ * @details Builds the command frame once and writes it with a single buffered write. Then it reads the whole response
+ * @details while polling CTS (the first response byte is the status), so no separate status read is needed.
+ * @details If a combined transport was set (setTransaction), the write and the first read are done in one
+ * @details repeated-start sequence; when the device was not ready yet (CTS clear), the response is read again after
+ * @details the predicted latency, so a command costs no more transactions than on the regular path.
+ * @details Otherwise it sleeps the predicted latency of the command (or blocks on the interrupt line) before reading.
+ *
+ * @see sendCommand, getCommandResponse, setTransaction, setCommandLatency
+ *
+ * @param cmd command number (see AN332-Si47XX PROGRAMMING GUIDE)
+ * @param args command arguments (up to 7 bytes)
+ * @param argc number of arguments
+ * @param resp buffer for the response; resp[0] is the status byte
+ * @param respc response size in bytes (at least 1)
+ * @return false if the device reported an error (ERR bit) or did not get ready within ctsTimeout (see getLastError); true otherwise.
+ */
+bool SI4735Base::transact(uint8_t cmd, const uint8_t *args, uint8_t argc, uint8_t *resp, uint8_t respc)
+{
+    uint8_t frame[8];
+    uint8_t size = Protocol::buildFrame(frame, cmd, argc, args);
+    uint16_t *predicted;
+    uint32_t waited;
+    uint16_t reads;
+    uint16_t slept;
+    bool combined; // resp holds the read of the combined transaction, and no sleep followed it
+
+    if (!waitToSend()) // The previous command must be done
+        return false;
+    if (cmd == SET_PROPERTY && argc >= 3)
+        forgetProperty((uint16_t)args[1] << 8 | args[2]); // sendProperty caches the value again once accepted
+    predicted = &commandLatency[getCommandSlot(cmd)];
+    combined = (transaction != NULL && interruptLine == NULL && transaction->writeRead(deviceAddress, frame, size, resp, respc));
+    slept = 0;
+
+    SI4735_TRACE_BEGIN("cts", TRACE_CTS, cmd);
+    if (!combined)
+    {
+        i2c.beginTransmission(deviceAddress);
+        i2c.write(frame, size);
+        i2c.endTransmission();
+        if (interruptLine != NULL)
+            interruptLine->wait(ctsInterruptTimeout);
+        else
+            slept = *predicted;
+    }
+    else
+    {
+        SI4735_STATS_ADD(cmd, ctsPolls, 1);
+        SI4735_STATS_ADD(cmd, bytesRead, respc);
+        if (!(resp[0] & 0B10000000)) // Not ready yet: reads again after the predicted latency
+        {
+            slept = *predicted;
+            combined = (slept == 0);
+        }
+    }
+    if (slept > 0)
+    {
+        clock.waitMicroseconds(slept);
+        SI4735_STATS_ADD(cmd, ctsWaitTime, slept);
+    }
+    SI4735_STATS_ADD(cmd, commands, 1);
+    SI4735_STATS_ADD(cmd, bytesWritten, size);
+
+    // Reads the whole response until CTS is set (unless the read of the combined transaction can be used)
+    bool ready = Protocol::pollCts(i2c, clock, deviceAddress, resp, respc, ctsPollMinDelay, ctsPollMaxDelay,
+                                   (uint32_t)ctsTimeout * 1000, !combined, &waited, &reads);
+    SI4735_STATS_ADD(cmd, ctsPolls, reads);
+    SI4735_STATS_ADD(cmd, bytesRead, (uint32_t)reads * respc);
+    if (!ready)
+    {
+        SI4735_TRACE_END();
+        setCommandError(cmd, SI4735_ERR_TIMEOUT);
+        return false;
+    }
+
+    currentStatusByte.raw = resp[0];
+    SI4735_STATS_ADD(cmd, ctsWaitTime, waited);
+    SI4735_TRACE_END();
+    if (interruptLine == NULL)
+    {
+        SI4735_STATS_LATENCY(cmd, slept + waited);
+        Protocol::updateLatency(predicted, waited);
+    }
+
+    if (resp[0] & 0B01000000)
+    {
+        setCommandError(cmd, SI4735_ERR_DEVICE);
+        return false;
+    }
+    lastError = SI4735_OK;
+    return true;
+}
+
+/**
+ * @ingroup group10 Generic Command and Response
+ * @brief Like transact, but sends the command again when the device reports an error (ERR bit).
+ * @details Gives up after maxRetries retries (see setRetryPolicy) or on a CTS timeout. Each retry is counted for the command.
+ *
+ * @see transact, setRetryPolicy, getCommandRetries, getLastError
+ *
+ * @return false if all the attempts failed (see getLastError); true otherwise.
+ */
+bool SI4735Base::transactRetry(uint8_t cmd, const uint8_t *args, uint8_t argc, uint8_t *resp, uint8_t respc)
+{
+    for (uint8_t attempt = 0;; attempt++)
+    {
+        if (transact(cmd, args, argc, resp, respc))
+            return true;
+        if (lastError == SI4735_ERR_TIMEOUT || attempt >= maxRetries)
+            return false;
+        if (commandRetries[getCommandSlot(cmd)] < 0xFFFF)
+            commandRetries[getCommandSlot(cmd)]++;
+    }
+}
+
 /**
  * @ingroup group10 Generic get property
  *
@@ -1412,6 +2423,7 @@ si47x_status SI4735Base::getStatusResponse()
  *
  * @details This method is used to get a given property from SI47XX
  * @details You might need to extract set of bits information from the returned value to know the real value
+ * @details Properties written or read before are served from the property shadow cache (no I2C traffic).
  *
  * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 55, 69, 124 and  134.
  * @see sendProperty, setProperty, sendCommand, getCommandResponse
@@ -1423,33 +2435,27 @@ si47x_status SI4735Base::getStatusResponse()
 int32_t
 SI4735Base::getProperty(uint16_t propertyNumber)
 {
-    si47x_property property;
-    si47x_status status;
+    uint8_t arg[3];
+    uint8_t resp[4];
+    uint16_t value;
+    int16_t idx = findProperty(propertyNumber);
 
-    property.value = propertyNumber;
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(GET_PROPERTY);
-    i2c.write(0x00);
-    i2c.write(property.raw.byteHigh); // Send property - High byte - most significant first
-    i2c.write(property.raw.byteLow);  // Send property - Low byte - less significant after
-    i2c.endTransmission();
+    if (idx >= 0)
+    {
+        propertyCacheHits++;
+        return shadowValue[idx];
+    }
+    propertyCacheMisses++;
 
-    waitToSend();
-    i2c.requestFrom(deviceAddress, 4);
-    status.raw = i2c.read();
+    Protocol::propertyArgs(propertyNumber, arg);
 
-    // if error, return 0;
-    if (status.refined.ERR == 1)
+    // if error, return -1;
+    if (!transact<GET_PROPERTY>(arg, resp))
         return -1;
 
-    i2c.read(); // dummy
-
-    // gets the property value
-    property.raw.byteHigh = i2c.read();
-    property.raw.byteLow = i2c.read();
-
-    return property.value;
+    value = Protocol::propertyValue(resp);
+    storeProperty(propertyNumber, value);
+    return value;
 }
 
 /** @defgroup group12 FM Mono Stereo audio setup */
@@ -1614,15 +2620,7 @@ void SI4735Base::setFmStereoOn()
  */
 void SI4735Base::disableFmDebug()
 {
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(0x12);
-    i2c.write(0x00);
-    i2c.write(0xFF);
-    i2c.write(0x00);
-    i2c.write(0x00);
-    i2c.write(0x00);
-    i2c.endTransmission();
-    clock.waitMicroseconds(2500);
+    sendProperty(FM_DEBUG_CONTROL, 0x0000);
 }
 
 /** @defgroup group13 Audio setup */
@@ -1817,14 +2815,8 @@ void SI4735Base::RdsInit()
  */
 void SI4735Base::setRdsConfig(uint8_t RDSEN, uint8_t BLETHA, uint8_t BLETHB, uint8_t BLETHC, uint8_t BLETHD)
 {
-    si47x_property property;
     si47x_rds_config config;
 
-    waitToSend();
-
-    // Set property value
-    property.value = FM_RDS_CONFIG;
-
     // Arguments
     config.arg.RDSEN = RDSEN;
     config.arg.BLETHA = BLETHA;
@@ -1833,15 +2825,7 @@ void SI4735Base::setRdsConfig(uint8_t RDSEN, uint8_t BLETHA, uint8_t BLETHB, uin
     config.arg.BLETHD = BLETHD;
     config.arg.DUMMY1 = 0;
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);                  // Always 0x00 (I need to check it)
-    i2c.write(property.raw.byteHigh); // Send property - High byte - most significant first
-    i2c.write(property.raw.byteLow);  // Low byte
-    i2c.write(config.raw[1]);         // Send the argments. Most significant first
-    i2c.write(config.raw[0]);
-    i2c.endTransmission();
-    clock.waitMicroseconds(550);
+    sendProperty(FM_RDS_CONFIG, (config.raw[1] << 8) | config.raw[0]); // Most significant first
 
     RdsInit();
 }
@@ -1863,7 +2847,6 @@ void SI4735Base::setRdsConfig(uint8_t RDSEN, uint8_t BLETHA, uint8_t BLETHB, uin
  */
 void SI4735Base::setRdsIntSource(uint8_t RDSRECV, uint8_t RDSSYNCLOST, uint8_t RDSSYNCFOUND, uint8_t RDSNEWBLOCKA, uint8_t RDSNEWBLOCKB)
 {
-    si47x_property property;
     si47x_rds_int_source rds_int_source;
 
     if (currentTune != FM_TUNE_FREQ)
@@ -1877,18 +2860,7 @@ void SI4735Base::setRdsIntSource(uint8_t RDSRECV, uint8_t RDSSYNCLOST, uint8_t R
     rds_int_source.refined.DUMMY1 = 0;
     rds_int_source.refined.DUMMY2 = 0;
 
-    property.value = FM_RDS_INT_SOURCE;
-
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);                  // Always 0x00 (I need to check it)
-    i2c.write(property.raw.byteHigh); // Send property - High byte - most significant first
-    i2c.write(property.raw.byteLow);  // Low byte
-    i2c.write(rds_int_source.raw[1]); // Send the argments. Most significant first
-    i2c.write(rds_int_source.raw[0]);
-    i2c.endTransmission();
+    sendProperty(FM_RDS_INT_SOURCE, (rds_int_source.raw[1] << 8) | rds_int_source.raw[0]); // Most significant first
     waitToSend();
 }
 
@@ -1907,6 +2879,8 @@ void SI4735Base::setRdsIntSource(uint8_t RDSRECV, uint8_t RDSSYNCLOST, uint8_t R
  */
 void SI4735Base::getRdsStatus(uint8_t INTACK, uint8_t MTFIFO, uint8_t STATUSONLY)
 {
+    SI4735_TRACE_SCOPE("getRdsStatus");
+
     si47x_rds_command rds_cmd;
     static uint16_t lastFreq;
     // checking current FUNC (Am or FM)
@@ -1921,26 +2895,12 @@ void SI4735Base::getRdsStatus(uint8_t INTACK, uint8_t MTFIFO, uint8_t STATUSONLY
         clearRdsBuffer0A();
     }
 
-    waitToSend();
-
     rds_cmd.arg.INTACK = INTACK;
     rds_cmd.arg.MTFIFO = MTFIFO;
     rds_cmd.arg.STATUSONLY = STATUSONLY;
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(FM_RDS_STATUS);
-    i2c.write(rds_cmd.raw);
-    i2c.endTransmission();
-
-    do
-    {
-        waitToSend();
-        // Gets response information
-        i2c.requestFrom(deviceAddress, 13);
-        for (uint8_t i = 0; i < 13; i++)
-            currentRdsStatus.raw[i] = i2c.read();
-    } while (currentRdsStatus.resp.ERR);
-    clock.waitMicroseconds(550);
+    // Gets response information. If error, try it again (see setRetryPolicy).
+    transactRetry(FM_RDS_STATUS, &rds_cmd.raw, 1, currentRdsStatus.raw, 13);
 }
 
 
@@ -1949,19 +2909,20 @@ void SI4735Base::getRdsStatus(uint8_t INTACK, uint8_t MTFIFO, uint8_t STATUSONLY
 /**  
  * @ingroup group16 RDS status 
  * 
- * @brief Returns the programa type. 
+ * @brief Returns the Program Identification (PI) code. 
  * 
- * @details Read the Block A content
+ * @details Block A carries the 16-bit PI code; both bytes (BLOCKAH and BLOCKAL) are returned.
+ * @details Earlier versions returned only the low byte (BLOCKAL).
  * 
  * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 77 and 78
  * 
- * @return BLOCKAL
+ * @return PI code of the last group; 0 if no new block A was received
  */
 uint16_t SI4735Base::getRdsPI(void)
 {
     if (getRdsReceived() && getRdsNewBlockA())
     {
-        return currentRdsStatus.resp.BLOCKAL;
+        return getRdsView().blockA();
     }
     return 0;
 }
@@ -1971,16 +2932,11 @@ uint16_t SI4735Base::getRdsPI(void)
  * 
  * @brief Returns the Group Type (extracted from the Block B)
  * 
- * @return BLOCKBL 
+ * @return bits 15:12 of block B (the 4 most significant bits of BLOCKBH)
  */
 uint8_t SI4735Base::getRdsGroupType(void)
 {
-    si47x_rds_blockb blkb;
-
-    blkb.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-    blkb.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-
-    return blkb.refined.groupType;
+    return getRdsView().groupType();
 }
 
 /**
@@ -1992,12 +2948,7 @@ uint8_t SI4735Base::getRdsGroupType(void)
  */
 uint8_t SI4735Base::getRdsFlagAB(void)
 {
-    si47x_rds_blockb blkb;
-
-    blkb.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-    blkb.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-
-    return blkb.refined.textABFlag;
+    return getRdsView().textABFlag();
 }
 
 /**
@@ -2014,11 +2965,7 @@ uint8_t SI4735Base::getRdsFlagAB(void)
  */
 uint8_t SI4735Base::getRdsTextSegmentAddress(void)
 {
-    si47x_rds_blockb blkb;
-    blkb.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-    blkb.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-
-    return blkb.refined.content;
+    return getRdsView().content();
 }
 
 /**
@@ -2030,12 +2977,7 @@ uint8_t SI4735Base::getRdsTextSegmentAddress(void)
  */
 uint8_t SI4735Base::getRdsVersionCode(void)
 {
-    si47x_rds_blockb blkb;
-
-    blkb.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-    blkb.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-
-    return blkb.refined.versionCode;
+    return getRdsView().versionCode();
 }
 
 /**  
@@ -2048,13 +2990,8 @@ uint8_t SI4735Base::getRdsVersionCode(void)
  * @return program type (an integer betwenn 0 and 31)
  */
 uint8_t SI4735Base::getRdsProgramType(void)
-{
-    si47x_rds_blockb blkb;
-
-    blkb.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-    blkb.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-
-    return blkb.refined.programType;
+{
+    return getRdsView().programType();
 }
 
 /**
@@ -2066,8 +3003,8 @@ uint8_t SI4735Base::getRdsProgramType(void)
  */
 void SI4735Base::getNext2Block(char *c)
 {
-    c[1] = currentRdsStatus.resp.BLOCKDL;
-    c[0] = currentRdsStatus.resp.BLOCKDH;
+    c[0] = currentRdsStatus.raw[10]; // BLOCKDH
+    c[1] = currentRdsStatus.raw[11]; // BLOCKDL
 }
 
 /**
@@ -2079,10 +3016,7 @@ void SI4735Base::getNext2Block(char *c)
  */
 void SI4735Base::getNext4Block(char *c)
 {
-    c[0] = currentRdsStatus.resp.BLOCKCH;
-    c[1] = currentRdsStatus.resp.BLOCKCL;
-    c[2] = currentRdsStatus.resp.BLOCKDH;
-    c[3] = currentRdsStatus.resp.BLOCKDL;
+    memcpy(c, currentRdsStatus.raw + 8, 4); // BLOCKCH, BLOCKCL, BLOCKDH and BLOCKDL
 
 }
 
@@ -2119,8 +3053,6 @@ char *SI4735Base::getRdsText(void)
  */
 char *SI4735Base::getRdsText0A(void)
 {
-    si47x_rds_blockb blkB;
-
     if (getRdsReceived())
     {
         if (getRdsGroupType() == 0)
@@ -2130,10 +3062,7 @@ char *SI4735Base::getRdsText0A(void)
                  this->clearRdsBuffer0A();
             } 
             // Process group type 0
-            blkB.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-            blkB.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-
-            rdsTextAdress0A = blkB.group0.address;
+            rdsTextAdress0A = getRdsView().psAddress();
             if (rdsTextAdress0A >= 0 && rdsTextAdress0A < 4)
             {
                 getNext2Block(&rds_buffer0A[rdsTextAdress0A * 2]);
@@ -2154,8 +3083,6 @@ char *SI4735Base::getRdsText0A(void)
  */
 char *SI4735Base::getRdsText2A(void)
 {
-    si47x_rds_blockb blkB;
-
     // getRdsStatus();
     if (getRdsReceived())
     {
@@ -2163,9 +3090,7 @@ char *SI4735Base::getRdsText2A(void)
         {
             // Process group 2A
             // Decode B block information
-            blkB.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-            blkB.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-            rdsTextAdress2A = blkB.group2.address;
+            rdsTextAdress2A = getRdsView().content();
 
             if (rdsTextAdress2A >= 0 && rdsTextAdress2A < 16)
             {
@@ -2187,8 +3112,6 @@ char *SI4735Base::getRdsText2A(void)
  */
 char *SI4735Base::getRdsText2B(void)
 {
-    si47x_rds_blockb blkB;
-
     // getRdsStatus();
     // if (getRdsReceived())
     // {
@@ -2197,9 +3120,7 @@ char *SI4735Base::getRdsText2B(void)
     if (getRdsGroupType() == 2 /* && getRdsVersionCode() == 1 */)
     {
         // Process group 2B
-        blkB.raw.highValue = currentRdsStatus.resp.BLOCKBH;
-        blkB.raw.lowValue = currentRdsStatus.resp.BLOCKBL;
-        rdsTextAdress2B = blkB.group2.address;
+        rdsTextAdress2B = getRdsView().content();
         if (rdsTextAdress2B >= 0 && rdsTextAdress2B < 16)
         {
             getNext2Block(&rds_buffer2B[rdsTextAdress2B * 2]);
@@ -2300,6 +3221,47 @@ bool SI4735Base::getRdsAllData(char **stationName, char **stationInformation, ch
     return (bool)stationName | (bool)stationInformation | (bool)programInformation | (bool)utcTime;
 }
 
+/**
+ * @ingroup group16 RDS Data
+ *
+ * @brief Reads and decodes every group waiting in the RDS FIFO.
+ *
+ * @details Each group is decoded as it is read (program service name, radio text, station information and time),
+ * @details so the groups received between two polls are not lost. The FIFO is read at the bulk I2C speed
+ * @details (see setBusSpeedControl). Afterwards getRdsText0A, getRdsText2A, getRdsText2B and getRdsTime return the texts.
+ * @code
+ *   rx.setFifoCount(4);
+ *   ...
+ *   if (rx.drainRdsFifo())
+ *       showStationName(rx.getRdsText0A());
+ * @endcode
+ * @param maxGroups maximum number of groups to read.
+ * @return number of groups read.
+ * @see getRdsStatus, getRdsAllData, setBusSpeedControl
+ */
+uint8_t SI4735Base::drainRdsFifo(uint8_t maxGroups)
+{
+    SI4735_TRACE_SCOPE("drainRdsFifo");
+    BulkBusPhase bulk(*this);
+    uint8_t groups = 0;
+
+    while (groups < maxGroups)
+    {
+        getRdsStatus(0, 0, 0);
+        if (getNumRdsFifoUsed() == 0) // Empty FIFO: the blocks are not a new group
+            break;
+        groups++;
+        currentRdsStatus.raw[1] |= 0B00000001; // RDSRECV drops below the FIFO count; the group is still valid
+        getRdsText0A();
+        getRdsText2A();
+        getRdsText2B();
+        getRdsTime();
+        if (getNumRdsFifoUsed() == 1) // That was the last group
+            break;
+    }
+    return groups;
+}
+
 /**
  * @ingroup group16 RDS Time and Date 
  * 
@@ -2315,7 +3277,7 @@ char *SI4735Base::getRdsTime()
 {
     // Under Test and construction
     // Need to check the Group Type before.
-    si47x_rds_date_time dt;
+    si47x_rds_view dt = getRdsView();
 
     uint16_t minute;
     uint16_t hour;
@@ -2328,22 +3290,14 @@ char *SI4735Base::getRdsTime()
 
         // uint16_t y, m, d;
 
-        dt.raw[4] = currentRdsStatus.resp.BLOCKBL;
-        dt.raw[5] = currentRdsStatus.resp.BLOCKBH;
-        dt.raw[2] = currentRdsStatus.resp.BLOCKCL;
-        dt.raw[3] = currentRdsStatus.resp.BLOCKCH;
-        dt.raw[0] = currentRdsStatus.resp.BLOCKDL;
-        dt.raw[1] = currentRdsStatus.resp.BLOCKDH;
-
-        // Unfortunately it was necessary dues to  the GCC compiler on 32-bit platform.
-        // See si47x_rds_date_time (typedef union) and CGG “Crosses boundary” issue/features.
-        // Now it is working on Atmega328, STM32, Arduino DUE, ESP32 and more.
-        minute =  dt.refined.minute;
-        hour =   dt.refined.hour;
-
-        offset_sign = (dt.refined.offset_sense == 1) ? '+' : '-';
-        offset_h = (dt.refined.offset * 30) / 60;
-        offset_m = (dt.refined.offset * 30) - (offset_h * 60);
+
+        // Decoded straight from the response bytes (see si47x_rds_view): same result on every platform.
+        minute = dt.minute();
+        hour = dt.hour();
+
+        offset_sign = (dt.offsetSense() == 1) ? '+' : '-';
+        offset_h = (dt.offset() * 30) / 60;
+        offset_m = (dt.offset() * 30) - (offset_h * 60);
         // sprintf(rds_time, "%02u:%02u %c%02u:%02u", dt.refined.hour, dt.refined.minute, offset_sign, offset_h, offset_m);
         // sprintf(rds_time, "%02u:%02u %c%02u:%02u", hour, minute, offset_sign, offset_h, offset_m);
 
@@ -2420,7 +3374,7 @@ void SI4735Base::mjdConverter(uint32_t mjd, uint32_t *year, uint32_t *month, uin
  */
 bool SI4735Base::getRdsDateTime(uint16_t *rYear, uint16_t *rMonth, uint16_t *rDay, uint16_t *rHour, uint16_t *rMinute)
 {
-    si47x_rds_date_time dt;
+    si47x_rds_view dt = getRdsView();
 
     int16_t local_minute;
     uint16_t minute;
@@ -2430,27 +3384,18 @@ bool SI4735Base::getRdsDateTime(uint16_t *rYear, uint16_t *rMonth, uint16_t *rDa
     if (getRdsGroupType() == 4)
     {
 
-        dt.raw[4] = currentRdsStatus.resp.BLOCKBL;
-        dt.raw[5] = currentRdsStatus.resp.BLOCKBH;
-        dt.raw[2] = currentRdsStatus.resp.BLOCKCL;
-        dt.raw[3] = currentRdsStatus.resp.BLOCKCH;
-        dt.raw[0] = currentRdsStatus.resp.BLOCKDL;
-        dt.raw[1] = currentRdsStatus.resp.BLOCKDH;
-
-        // Unfortunately the resource below was necessary dues to  the GCC compiler on 32-bit platform.
-        // See si47x_rds_date_time (typedef union) and CGG “Crosses boundary” issue/features.
-        // Now it is working on Atmega328, STM32, Arduino DUE, ESP32 and more.
 
-        mjd = dt.refined.mjd;
+        // Decoded straight from the response bytes (see si47x_rds_view): same result on every platform.
+        mjd = dt.mjd();
 
-        minute = dt.refined.minute;
-        hour =  dt.refined.hour;
+        minute = dt.minute();
+        hour = dt.hour();
 
         // calculates the jd Year, Month and Day base on mjd number
         // mjdConverter(mjd, &year, &month, &day);
 
         // Converting UTC to local time
-        local_minute = ((hour * 60) + minute) + ((dt.refined.offset * 30) * ((dt.refined.offset_sense == 1) ? -1 : 1));
+        local_minute = ((hour * 60) + minute) + ((dt.offset() * 30) * ((dt.offsetSense() == 1) ? -1 : 1));
         if (local_minute < 0) {
             local_minute += 1440;
             mjd--;  // drecreases one day 
@@ -2494,7 +3439,7 @@ bool SI4735Base::getRdsDateTime(uint16_t *rYear, uint16_t *rMonth, uint16_t *rDa
  */
 char *SI4735Base::getRdsDateTime()
 {
-    si47x_rds_date_time dt;
+    si47x_rds_view dt = getRdsView();
 
     uint16_t minute;
     uint16_t hour;
@@ -2506,29 +3451,20 @@ char *SI4735Base::getRdsDateTime()
         int offset_h;
         int offset_m;
 
-        dt.raw[4] = currentRdsStatus.resp.BLOCKBL;
-        dt.raw[5] = currentRdsStatus.resp.BLOCKBH;
-        dt.raw[2] = currentRdsStatus.resp.BLOCKCL;
-        dt.raw[3] = currentRdsStatus.resp.BLOCKCH;
-        dt.raw[0] = currentRdsStatus.resp.BLOCKDL;
-        dt.raw[1] = currentRdsStatus.resp.BLOCKDH;
 
-        // Unfortunately the resource below was necessary dues to  the GCC compiler on 32-bit platform.
-        // See si47x_rds_date_time (typedef union) and CGG “Crosses boundary” issue/features.
-        // Now it is working on Atmega328, STM32, Arduino DUE, ESP32 and more.
+        // Decoded straight from the response bytes (see si47x_rds_view): same result on every platform.
+        mjd = dt.mjd();
 
-        mjd |= dt.refined.mjd;
-
-        minute = dt.refined.minute;
-        hour =  dt.refined.hour;
+        minute = dt.minute();
+        hour = dt.hour();
 
         // calculates the jd (Year, Month and Day) base on mjd number
         mjdConverter(mjd, &year, &month, &day);
 
         // Calculating hour, minute and offset
-        offset_sign = (dt.refined.offset_sense == 1) ? '+' : '-';
-        offset_h = (dt.refined.offset * 30) / 60;
-        offset_m = (dt.refined.offset * 30) - (offset_h * 60);
+        offset_sign = (dt.offsetSense() == 1) ? '+' : '-';
+        offset_h = (dt.offset() * 30) / 60;
+        offset_m = (dt.offset() * 30) - (offset_h * 60);
 
         // Converting the result to array char - 
         // Using convertToChar instead sprintf to save space (about 1.2K on ATmega328 compiler tools).
@@ -2620,27 +3556,14 @@ char *SI4735Base::getRdsDateTime()
 void SI4735Base::setSSBBfo(int offset)
 {
 
-    si47x_property property;
     si47x_frequency bfo_offset;
 
     if (currentTune == FM_TUNE_FREQ) // Only for AM/SSB mode
         return;
 
-    waitToSend();
-
-    property.value = SSB_BFO;
     bfo_offset.value = offset;
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);                  // Always 0x00
-    i2c.write(property.raw.byteHigh); // High byte first
-    i2c.write(property.raw.byteLow);  // Low byte after
-    i2c.write(bfo_offset.raw.FREQH);  // Offset freq. high byte first
-    i2c.write(bfo_offset.raw.FREQL);  // Offset freq. low byte first
-
-    i2c.endTransmission();
-    clock.waitMicroseconds(550);
+    sendProperty(SSB_BFO, bfo_offset.value); // Offset freq. high byte first
 }
 
 /**
@@ -2809,6 +3732,8 @@ void SI4735Base::setSSBAudioBandwidth(uint8_t AUDIOBW)
  */
 void SI4735Base::setSSB(uint8_t usblsb)
 {
+    SI4735_TRACE_SCOPE("setSSB");
+
     // Is it needed to load patch when switch to SSB?
     // powerDown();
     // It starts with the same AM parameters.
@@ -2864,19 +3789,7 @@ void SI4735Base::setSSB(uint16_t fromFreq, uint16_t toFreq, uint16_t initialFreq
  */
 void SI4735Base::sendSSBModeProperty()
 {
-    si47x_property property;
-    property.value = SSB_MODE;
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SET_PROPERTY);
-    i2c.write(0x00);                  // Always 0x00
-    i2c.write(property.raw.byteHigh); // High byte first
-    i2c.write(property.raw.byteLow);  // Low byte after
-    i2c.write(currentSSBMode.raw[1]); // SSB MODE params; freq. high byte first
-    i2c.write(currentSSBMode.raw[0]); // SSB MODE params; freq. low byte after
-
-    i2c.endTransmission();
-    clock.waitMicroseconds(550);
+    sendProperty(SSB_MODE, (currentSSBMode.raw[1] << 8) | currentSSBMode.raw[0]); // SSB MODE params; high byte first
 }
 
 /**
@@ -2890,19 +3803,8 @@ void SI4735Base::sendSSBModeProperty()
  */
 void SI4735Base::getSsbAgcStatus()
 {
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SSB_AGC_STATUS);
-    i2c.endTransmission();
-    do
-    {
-        waitToSend();
-        i2c.requestFrom(deviceAddress, 3);
-        currentAgcStatus.raw[0] = i2c.read(); // STATUS response
-        currentAgcStatus.raw[1] = i2c.read(); // RESP 1
-        currentAgcStatus.raw[2] = i2c.read(); // RESP 2
-    } while (currentAgcStatus.refined.ERR);    // If error, try get AGC status again.
+    // STATUS response, RESP 1 and RESP 2. If error, try get AGC status again (see setRetryPolicy).
+    transactRetry<SSB_AGC_STATUS>(currentAgcStatus.raw);
 }
 
 /**
@@ -2923,13 +3825,7 @@ void SI4735Base::setSsbAgcOverrite(uint8_t SSBAGCDIS, uint8_t SSBAGCNDX, uint8_t
     agc.arg.AGCDIS = SSBAGCDIS;
     agc.arg.AGCIDX = SSBAGCNDX;
 
-    waitToSend();
-
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(SSB_AGC_OVERRIDE);
-    i2c.write(agc.raw[0]);
-    i2c.write(agc.raw[1]);
-    i2c.endTransmission();
+    sendCommand<SSB_AGC_OVERRIDE>(agc.raw);
 
     waitToSend();
 }
@@ -2963,27 +3859,17 @@ void SI4735Base::setSsbAgcOverrite(uint8_t SSBAGCDIS, uint8_t SSBAGCNDX, uint8_t
 si47x_firmware_query_library SI4735Base::queryLibraryId()
 {
     si47x_firmware_query_library libraryID;
+    uint8_t arg[2];
 
     powerDown(); // Is it necessary
 
     // clock.wait(500);
 
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_UP);
-    i2c.write(0b00011111);          // Set to Read Library ID, disable interrupt; disable GPO2OEN; boot normaly; enable External Crystal Oscillator  .
-    i2c.write(SI473X_ANALOG_AUDIO); // Set to Analog Line Input.
-    i2c.endTransmission();
-
-    do
-    {
-        waitToSend();
-        i2c.requestFrom(deviceAddress, 8);
-        for (int i = 0; i < 8; i++)
-            libraryID.raw[i] = i2c.read();
-    } while (libraryID.resp.ERR); // If error found, try it again.
+    arg[0] = 0b00011111;          // Set to Read Library ID, disable interrupt; disable GPO2OEN; boot normaly; enable External Crystal Oscillator  .
+    arg[1] = SI473X_ANALOG_AUDIO; // Set to Analog Line Input.
 
-    clock.waitMicroseconds(2500);
+    // If error found, try it again (see setRetryPolicy and getLastError).
+    transactRetry(POWER_UP, arg, 2, libraryID.raw, 8);
 
     return libraryID;
 }
@@ -3003,13 +3889,12 @@ si47x_firmware_query_library SI4735Base::queryLibraryId()
  */
 void SI4735Base::patchPowerUp()
 {
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_UP);
-    i2c.write(0b00110001);          // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled. You can change this calling setSSB.
-    i2c.write(SI473X_ANALOG_AUDIO); // This is a condition for loading the patch: Set to Analog Output. You can change this calling setSSB.
-    i2c.endTransmission();
-    clock.wait(maxDelayAfterPowerUp);
+    uint8_t arg[2];
+
+    arg[0] = 0b00110001;          // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled. You can change this calling setSSB.
+    arg[1] = SI473X_ANALOG_AUDIO; // This is a condition for loading the patch: Set to Analog Output. You can change this calling setSSB.
+    sendCommand<POWER_UP>(arg);
+    fixedWait(POWER_UP, maxDelayAfterPowerUp);
 }
 
 /**
@@ -3019,13 +3904,12 @@ void SI4735Base::patchPowerUp()
  */
 void SI4735Base::ssbPowerUp()
 {
+    uint8_t arg[2];
+
+    arg[0] = 0b00010001; // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled. You can change this calling setSSB.
+    arg[1] = 0b00000101; // This is a condition for loading the patch: Set to Analog Output. You can change this calling setSSB.
+    sendCommand<POWER_UP>(arg);
     waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_UP);
-    i2c.write(0b00010001); // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled. You can change this calling setSSB.
-    i2c.write(0b00000101); // This is a condition for loading the patch: Set to Analog Output. You can change this calling setSSB.
-    i2c.endTransmission();
-    clock.waitMicroseconds(2500);
 
     powerUp.arg.CTSIEN = this->ctsIntEnable;     // 1 -> Interrupt anabled;
     powerUp.arg.GPO2OEN = 0;                     // 1 -> GPO2 Output Enable;
@@ -3046,9 +3930,11 @@ void SI4735Base::ssbPowerUp()
  */
 void SI4735Base::loadPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_patch_content_size, uint8_t ssb_audiobw)
 {
+    SI4735_TRACE_SCOPE("loadPatch");
+
     queryLibraryId();
     patchPowerUp();
-    clock.wait(50);
+    fixedWait(POWER_UP, 50);
     downloadPatch(ssb_patch_content, ssb_patch_content_size);
     // Parameters
     // AUDIOBW - SSB Audio bandwidth; 0 = 1.2kHz (default); 1=2.2kHz; 2=3kHz; 3=4kHz; 4=500Hz; 5=1kHz;
@@ -3058,7 +3944,7 @@ void SI4735Base::loadPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_
     // SMUTESEL - SSB Soft-mute Based on RSSI or SNR (0 or 1).
     // DSP_AFCDIS - DSP AFC Disable or enable; 0=SYNC MODE, AFC enable; 1=SSB MODE, AFC disable.
     setSSBConfig(ssb_audiobw, 1, 0, 0, 0, 1);
-    clock.wait(25);
+    fixedWait(PATCH_DATA, 25);
 }
 
 /**
@@ -3074,9 +3960,11 @@ void SI4735Base::loadPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_
  */
 void SI4735Base::loadCompressedPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_patch_content_size, const uint16_t *cmd_0x15, const int16_t cmd_0x15_size, uint8_t ssb_audiobw)
 {
+    SI4735_TRACE_SCOPE("loadCompressedPatch");
+
     queryLibraryId();
     patchPowerUp();
-    clock.wait(50);
+    fixedWait(POWER_UP, 50);
     downloadCompressedPatch(ssb_patch_content, ssb_patch_content_size, cmd_0x15, cmd_0x15_size);
     // Parameters
     // AUDIOBW - SSB Audio bandwidth; 0 = 1.2kHz (default); 1=2.2kHz; 2=3kHz; 3=4kHz; 4=500Hz; 5=1kHz;
@@ -3086,7 +3974,91 @@ void SI4735Base::loadCompressedPatch(const uint8_t *ssb_patch_content, const uin
     // SMUTESEL - SSB Soft-mute Based on RSSI or SNR (0 or 1).
     // DSP_AFCDIS - DSP AFC Disable or enable; 0=SYNC MODE, AFC enable; 1=SSB MODE, AFC disable.
     setSSBConfig(ssb_audiobw, 1, 0, 0, 0, 1);
-    clock.wait(25);
+    fixedWait(PATCH_DATA, 25);
+}
+
+/**
+ * @ingroup group17 Patch and SSB support
+ *
+ * @brief Transfers the content of a patch stored in a array of bytes to the SI4735 device.
+ *
+ * @details Portable version: the patch is read from regular memory (see SI4735Arduino::downloadPatch for PROGMEM).
+ * @details Each line of 8 bytes starts with PATCH_ARGS (0x15) or PATCH_DATA (0x16).
+ *
+ * @see Si47XX PROGRAMMING GUIDE; ;AN332 (REV 1.0) pages 64 and 215-220.
+ *
+ * @param ssb_patch_content point to array of bytes content patch.
+ * @param ssb_patch_content_size array size (number of bytes). The maximum size allowed for a patch is 15856 bytes
+ *
+ * @return false if an error is found.
+ */
+bool SI4735Base::downloadPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_patch_content_size)
+{
+    SI4735_TRACE_SCOPE("downloadPatch");
+    BulkBusPhase bulk(*this);
+
+    for (uint16_t offset = 0; offset < ssb_patch_content_size; offset += 8)
+    {
+        if (!waitToSend()) // The first line also waits for the patch POWER_UP
+            return false;
+        i2c.beginTransmission(deviceAddress);
+        i2c.write(ssb_patch_content + offset, 8);
+        i2c.endTransmission();
+        pendingCommand = ssb_patch_content[offset]; // PATCH_ARGS or PATCH_DATA
+        SI4735_STATS_ADD(pendingCommand, commands, 1);
+        SI4735_STATS_ADD(pendingCommand, bytesWritten, 8);
+    }
+    return waitToSend();
+}
+
+/**
+ * @ingroup group17 Patch and SSB support
+ *
+ * @brief Deal with compressed SSB patch
+ *
+ * @details Portable version of SI4735Arduino::downloadCompressedPatch: the patch is read from regular memory.
+ * @details Each line has 7 bytes; the lines listed in cmd_0x15 start with PATCH_ARGS, the others with PATCH_DATA.
+ *
+ * @see downloadPatch
+ * @see patch_ssb_compressed.h
+ *
+ * @param ssb_patch_content         point to array of bytes content patch.
+ * @param ssb_patch_content_size    array size (number of bytes). The maximum size allowed for a patch is 15856 bytes
+ * @param cmd_0x15                  Array of lines where the first byte of each patch content line is 0x15
+ * @param cmd_0x15_size             Array size
+ *
+ * @return false if an error is found.
+ */
+bool SI4735Base::downloadCompressedPatch(const uint8_t *ssb_patch_content, const uint16_t ssb_patch_content_size, const uint16_t *cmd_0x15, const int16_t cmd_0x15_size)
+{
+    SI4735_TRACE_SCOPE("downloadCompressedPatch");
+    BulkBusPhase bulk(*this);
+
+    uint8_t cmd, frame[8];
+    uint16_t command_line = 0;
+    uint16_t next_0x15 = 0; // cmd_0x15 is sorted: only the next entry has to be checked
+
+    for (uint16_t offset = 0; offset < ssb_patch_content_size; offset += 7)
+    {
+        cmd = PATCH_DATA;
+        if (next_0x15 < cmd_0x15_size / sizeof(uint16_t) && cmd_0x15[next_0x15] == command_line)
+        {
+            cmd = PATCH_ARGS;
+            next_0x15++;
+        }
+        if (!waitToSend()) // The first line also waits for the patch POWER_UP
+            return false;
+        frame[0] = cmd;
+        memcpy(frame + 1, ssb_patch_content + offset, 7);
+        i2c.beginTransmission(deviceAddress);
+        i2c.write(frame, 8);
+        i2c.endTransmission();
+        pendingCommand = cmd;
+        SI4735_STATS_ADD(cmd, commands, 1);
+        SI4735_STATS_ADD(cmd, bytesWritten, 8);
+        command_line++;
+    }
+    return waitToSend();
 }
 
 /**
@@ -3104,6 +4076,9 @@ void SI4735Base::loadCompressedPatch(const uint8_t *ssb_patch_content, const uin
  */
 si4735_eeprom_patch_header SI4735Base::downloadPatchFromEeprom(int eeprom_i2c_address)
 {
+    SI4735_TRACE_SCOPE("downloadPatchFromEeprom");
+    BulkBusPhase bulk(*this);
+
     si4735_eeprom_patch_header eep;
     const int header_size = sizeof eep;
     uint8_t bufferAux[8];
@@ -3114,7 +4089,7 @@ si4735_eeprom_patch_header SI4735Base::downloadPatchFromEeprom(int eeprom_i2c_ad
     i2c.write(0x00); // offset Most significant Byte
     i2c.write(0x00); // offset Less significant Byte
     i2c.endTransmission();
-    clock.wait(5);
+    fixedWait(0, 5);
 
     // The first two bytes of the header will be ignored.
     for (int k = 0; k < header_size; k += 8)
@@ -3143,6 +4118,9 @@ si4735_eeprom_patch_header SI4735Base::downloadPatchFromEeprom(int eeprom_i2c_ad
         i2c.beginTransmission(deviceAddress);
         i2c.write(bufferAux, 8);
         i2c.endTransmission();
+        pendingCommand = bufferAux[0]; // PATCH_ARGS or PATCH_DATA
+        SI4735_STATS_ADD(pendingCommand, commands, 1);
+        SI4735_STATS_ADD(pendingCommand, bytesWritten, 8);
 
         waitToSend();
         uint8_t cmd_status;
@@ -3157,7 +4135,7 @@ si4735_eeprom_patch_header SI4735Base::downloadPatchFromEeprom(int eeprom_i2c_ad
         offset += 8; // Start processing the next 8 bytes
     }
 
-    clock.wait(50);
+    fixedWait(0, 50);
     return eep;
 }
 
@@ -3288,13 +4266,12 @@ void SI4735Base::removeUnwantedChar(char *str, int size) {
  */
 void SI4735Base::patchPowerUpNBFM()
 {
-    waitToSend();
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(POWER_UP);
-    i2c.write(0b00110000);          // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled.
-    i2c.write(SI473X_ANALOG_AUDIO); // This is a condition for loading the patch: Set to Analog Output. You can change this calling setNBFM.
-    i2c.endTransmission();
-    clock.wait(maxDelayAfterPowerUp);
+    uint8_t arg[2];
+
+    arg[0] = 0b00110000;          // This is a condition for loading the patch: Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled.
+    arg[1] = SI473X_ANALOG_AUDIO; // This is a condition for loading the patch: Set to Analog Output. You can change this calling setNBFM.
+    sendCommand<POWER_UP>(arg);
+    fixedWait(POWER_UP, maxDelayAfterPowerUp);
 }
 
 /**
@@ -3307,12 +4284,14 @@ void SI4735Base::patchPowerUpNBFM()
  */
 void SI4735Base::loadPatchNBFM(const uint8_t *patch_content, const uint16_t patch_content_size)
 {
+    SI4735_TRACE_SCOPE("loadPatchNBFM");
+
     queryLibraryId();
     patchPowerUpNBFM();
-    clock.wait(50);
+    fixedWait(POWER_UP, 50);
     downloadPatch(patch_content, patch_content_size);
     // TODO
-    clock.wait(25);
+    fixedWait(PATCH_DATA, 25);
 }
 
 /**
@@ -3331,6 +4310,8 @@ void SI4735Base::loadPatchNBFM(const uint8_t *patch_content, const uint16_t patc
  */
 void SI4735Base::setNBFM()
 {
+    SI4735_TRACE_SCOPE("setNBFM");
+
     // Is it needed to load patch when switch to SSB?
     // powerDown();
     // It starts with the same AM parameters.
@@ -3390,18 +4371,413 @@ void SI4735Base::setNBFM(uint16_t fromFreq, uint16_t toFreq, uint16_t initialFre
  */
 void SI4735Base::setFrequencyNBFM(uint16_t freq)
 {
-    waitToSend(); // Wait for the si473x is ready.
+    uint8_t arg[3];
+
     currentFrequency.value = freq;
     currentFrequencyParams.arg.FREQH = currentFrequency.raw.FREQH;
     currentFrequencyParams.arg.FREQL = currentFrequency.raw.FREQL;
 
-    i2c.beginTransmission(deviceAddress);
-    i2c.write(0x50);
-    i2c.write(0x00); // Send a byte with FAST and  FREEZE information; if not FM must be 0;
-    i2c.write(currentFrequency.raw.FREQH);
-    i2c.write(currentFrequency.raw.FREQL);
-    i2c.endTransmission();
+    arg[0] = 0x00; // Send a byte with FAST and  FREEZE information; if not FM must be 0;
+    arg[1] = currentFrequency.raw.FREQH;
+    arg[2] = currentFrequency.raw.FREQL;
+    sendCommand<NBFM_TUNE_FREQ>(arg);
     waitToSend();                // Wait for the si473x is ready.
     currentWorkFrequency = freq; // check it
-    clock.wait(250);                  // For some reason I need to delay here.
+    fixedWait(NBFM_TUNE_FREQ, 250); // For some reason I need to delay here.
+}
+
+/**
+ * @defgroup group21 Non-blocking (async) commands
+ *
+ * @details The functions of this group start a command and return right away. Call poll() from your event loop
+ * @details until it returns ASYNC_DONE or ASYNC_ERROR. poll() never sleeps: each call does at most one status
+ * @details (or response) read and one command write on the I2C bus. This way one thread can drive many receivers.
+ * @details Do not call the blocking functions of the same instance while an async command is in flight.
+ *
+ * @code
+ * rx.beginTune(10390);
+ * while (rx.poll() == ASYNC_BUSY)
+ * {
+ *     // serve the other receivers
+ * }
+ * uint16_t f = rx.getCurrentFrequency();
+ * @endcode
+ */
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts an async command.
+ *
+ * @param operation ASYNC_OP_TUNE, ASYNC_OP_SEEK, ASYNC_OP_RDS, ASYNC_OP_RSQ, ASYNC_OP_PATCH or ASYNC_OP_PROPERTY
+ * @param cmd command opcode
+ * @param argc number of arguments (already stored in asyncArgs)
+ * @param resp buffer that receives the response (currentStatus, currentRdsStatus or currentRqsStatus)
+ * @param respSize response size in bytes
+ * @param timeout maximum time (ms) for the whole command
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginAsync(uint8_t operation, uint8_t cmd, uint8_t argc, uint8_t *resp, uint8_t respSize, uint32_t timeout)
+{
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    asyncOperation = operation;
+    asyncCmd = cmd;
+    asyncArgc = argc;
+    asyncResp = resp;
+    asyncRespSize = respSize;
+    asyncTimeout = timeout;
+    asyncStart = clock.now();
+    asyncPhase = ASYNC_PHASE_SEND;
+    asyncCancel = false;
+    asyncState = ASYNC_BUSY;
+
+    poll();
+    return true;
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts tuning a frequency (non-blocking).
+ *
+ * @details When poll() returns ASYNC_DONE, the tune is complete (STCINT acknowledged), currentStatus has the tune status and
+ * @details getCurrentFrequency, getReceivedSignalStrengthIndicator, getStatusSNR etc return the result.
+ *
+ * @see poll, setFrequency
+ *
+ * @param freq frequency to tune. For example, FM => 10390 = 103.9 MHz; AM => 810 = 810 kHz.
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginTune(uint16_t freq)
+{
+    uint8_t argc;
+
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    applyAntennaCapacitor(freq);
+    argc = prepareTune(freq);
+    memcpy(asyncArgs, currentFrequencyParams.raw, argc);
+    return beginAsync(ASYNC_OP_TUNE, currentTune, argc, currentStatus.raw, (currentTune == NBFM_TUNE_FREQ) ? 6 : 8, MAX_ASYNC_TIME);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts a seek (non-blocking).
+ *
+ * @details When poll() returns ASYNC_DONE, the seek is complete and getCurrentFrequency returns the station found.
+ * @details The seek is bounded by maxSeekTime (see setMaxSeekTime).
+ *
+ * @see poll, seekStation
+ *
+ * @param up Seek Up/Down. Determines the direction of the search, either UP = 1, or DOWN = 0.
+ * @param wrap Wrap/Halt. Determines whether the seek should Wrap = 1, or Halt = 0 when it hits the band limit.
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginSeek(uint8_t up, uint8_t wrap)
+{
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    return beginAsync(ASYNC_OP_SEEK, (currentTune == FM_TUNE_FREQ) ? FM_SEEK_START : AM_SEEK_START, prepareSeek(up, wrap, asyncArgs),
+                      currentStatus.raw, (currentTune == NBFM_TUNE_FREQ) ? 6 : 8, maxSeekTime);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts reading the RDS status (FM_RDS_STATUS, non-blocking).
+ *
+ * @details When poll() returns ASYNC_DONE, currentRdsStatus has the response. Only for FM mode.
+ *
+ * @see poll, getRdsStatus
+ *
+ * @param INTACK Interrupt Acknowledge; 0 = RDSINT status preserved. 1 = Clears RDSINT.
+ * @param MTFIFO 0 = If FIFO not empty, read and remove oldest FIFO entry; 1 = Clear RDS Receive FIFO.
+ * @param STATUSONLY Determines if data should be removed from the RDS FIFO.
+ * @return false if another async command is in flight or the current mode is not FM.
+ */
+bool SI4735Base::beginRdsRead(uint8_t INTACK, uint8_t MTFIFO, uint8_t STATUSONLY)
+{
+    si47x_rds_command rds_cmd;
+
+    if (asyncState == ASYNC_BUSY || currentTune != FM_TUNE_FREQ)
+        return false;
+
+    rds_cmd.raw = 0;
+    rds_cmd.arg.INTACK = INTACK;
+    rds_cmd.arg.MTFIFO = MTFIFO;
+    rds_cmd.arg.STATUSONLY = STATUSONLY;
+    asyncArgs[0] = rds_cmd.raw;
+    return beginAsync(ASYNC_OP_RDS, FM_RDS_STATUS, 1, currentRdsStatus.raw, 13, MAX_ASYNC_TIME);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts reading the Received Signal Quality (RSQ) of the current channel (non-blocking).
+ *
+ * @details When poll() returns ASYNC_DONE, currentRqsStatus has the response (getCurrentRSSI, getCurrentSNR etc).
+ *
+ * @see poll, getCurrentReceivedSignalQuality
+ *
+ * @param INTACK Interrupt Acknowledge. 0 = Interrupt status preserved; 1 = Clears RSQINT, BLENDINT, SNRHINT, SNRLINT, RSSIHINT, RSSILINT, MULTHINT, MULTLINT.
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginRsqRead(uint8_t INTACK)
+{
+    uint8_t cmd = (currentTune == FM_TUNE_FREQ) ? FM_RSQ_STATUS : (currentTune == NBFM_TUNE_FREQ) ? NBFM_RSQ_STATUS : AM_RSQ_STATUS;
+
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    asyncArgs[0] = INTACK;
+    return beginAsync(ASYNC_OP_RSQ, cmd, 1, currentRqsStatus.raw, (cmd == AM_RSQ_STATUS) ? 6 : 8, MAX_ASYNC_TIME);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts a patch download (non-blocking).
+ *
+ * @details Powers the device down, powers it up in patch mode (like patchPowerUp) and then sends one 8 bytes line of the
+ * @details patch each time the device is clear to send. When poll() returns ASYNC_DONE, the patch is loaded;
+ * @details call setSSBConfig (SSB) or setNBFM as you would after loadPatch.
+ * @details The patch content must be in RAM (on AVR, use loadPatch for PROGMEM content).
+ *
+ * @see poll, loadPatch, patchPowerUp
+ *
+ * @param patch_content patch content (lines of 8 bytes starting with 0x15 or 0x16).
+ * @param patch_content_size patch size in bytes.
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginPatch(const uint8_t *patch_content, const uint16_t patch_content_size)
+{
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    asyncPatch = patch_content;
+    asyncPatchSize = patch_content_size;
+    asyncPatchOffset = 0;
+    asyncPatchPowerUp = false;
+    // Bounds the download to 1ms per byte, far more than the bus needs.
+    return beginAsync(ASYNC_OP_PATCH, POWER_DOWN, 0, NULL, 0, MAX_ASYNC_TIME + patch_content_size);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts setting a property (SET_PROPERTY, non-blocking).
+ *
+ * @details When poll() returns ASYNC_DONE, the device has accepted the value. Like sendProperty, a value the device
+ * @details already has (property shadow cache) is not written: the command is done right away.
+ *
+ * @see poll, sendProperty
+ *
+ * @param propertyNumber property number (example: RX_VOLUME)
+ * @param parameter property value
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginSetProperty(uint16_t propertyNumber, uint16_t parameter)
+{
+    int16_t idx = findProperty(propertyNumber);
+
+    if (asyncState == ASYNC_BUSY)
+        return false;
+
+    if (idx >= 0 && shadowValue[idx] == parameter)
+    {
+        propertyCacheHits++;
+        asyncOperation = ASYNC_OP_PROPERTY;
+        asyncState = ASYNC_DONE;
+        return true;
+    }
+    propertyCacheMisses++;
+
+    Protocol::propertyArgs(propertyNumber, parameter, asyncArgs);
+    forgetProperty(propertyNumber); // Cached again by poll() when the device accepts the value
+    return beginAsync(ASYNC_OP_PROPERTY, SET_PROPERTY, 5, &currentStatusByte.raw, 1, MAX_ASYNC_TIME);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Starts setting the volume (non-blocking).
+ * @see beginSetProperty, setVolume
+ * @param volume volume level (0 to 63).
+ * @return false if another async command is in flight.
+ */
+bool SI4735Base::beginSetVolume(uint8_t volume)
+{
+    if (!beginSetProperty(RX_VOLUME, volume))
+        return false;
+    this->volume = volume;
+    return true;
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Cancels the seek in flight.
+ *
+ * @details A seek that was not sent yet ends right away. A seek in progress is stopped by the next poll(), which sends
+ * @details the tune status with CANCEL and INTACK; the device stays on the channel it was checking and currentStatus
+ * @details has that channel. In both cases poll() returns ASYNC_CANCELLED. Other commands are short and cannot be
+ * @details cancelled: they run to the end.
+ *
+ * @return true if the async command in flight is a seek that will be cancelled.
+ */
+bool SI4735Base::cancelAsync()
+{
+    if (asyncState != ASYNC_BUSY || asyncOperation != ASYNC_OP_SEEK || asyncPhase == ASYNC_PHASE_RESPONSE)
+        return false;
+    if (asyncPhase == ASYNC_PHASE_SEND)
+        asyncState = ASYNC_CANCELLED;
+    else
+        asyncCancel = true;
+    return true;
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Advances the async command in flight without sleeping.
+ *
+ * @details Each call reads the device status (or the response) once and, if the device is clear to send, writes the next
+ * @details command of the sequence: the command itself; GET_INT_STATUS until STCINT is set (tune and seek);
+ * @details the tune status with INTACK (tune and seek); the next patch line (patch download). When the response is read, the result is decoded into
+ * @details currentStatus (and currentWorkFrequency), currentRdsStatus or currentRqsStatus.
+ *
+ * @see beginTune, beginSeek, beginRdsRead, beginRsqRead, getAsyncOperation
+ *
+ * @return uint8_t ASYNC_IDLE, ASYNC_BUSY, ASYNC_DONE, ASYNC_ERROR or ASYNC_CANCELLED
+ */
+uint8_t SI4735Base::poll()
+{
+    si47x_tune_status status;
+
+    if (asyncState != ASYNC_BUSY)
+        return asyncState;
+
+    if ((uint32_t)(clock.now() - asyncStart) > asyncTimeout)
+    {
+        setCommandError(asyncCmd, SI4735_ERR_TIMEOUT);
+        return (asyncState = ASYNC_ERROR);
+    }
+
+    if (asyncPhase == ASYNC_PHASE_RESPONSE)
+    {
+        getStatusBytes(asyncResp, asyncRespSize);
+        if (!(asyncResp[0] & 0B10000000))
+            return ASYNC_BUSY;
+        if (asyncResp[0] & 0B01000000)
+        {
+            setCommandError(asyncCmd, SI4735_ERR_DEVICE);
+            return (asyncState = ASYNC_ERROR);
+        }
+        if (asyncOperation == ASYNC_OP_TUNE || asyncOperation == ASYNC_OP_SEEK)
+            currentWorkFrequency = getStatusView().frequency();
+        else if (asyncOperation == ASYNC_OP_PROPERTY) // Accepted by the device: now it can be cached
+            storeProperty(((uint16_t)asyncArgs[1] << 8) | asyncArgs[2], ((uint16_t)asyncArgs[3] << 8) | asyncArgs[4]);
+        lastError = SI4735_OK;
+        return (asyncState = asyncCancel ? ASYNC_CANCELLED : ASYNC_DONE);
+    }
+
+    getStatusBytes(&currentStatusByte.raw, 1);
+    if (!si47x_status_view(&currentStatusByte.raw).cts())
+        return ASYNC_BUSY;
+    if (asyncPhase != ASYNC_PHASE_SEND && si47x_status_view(&currentStatusByte.raw).err())
+    {
+        setCommandError(asyncCmd, SI4735_ERR_DEVICE);
+        return (asyncState = ASYNC_ERROR);
+    }
+
+    if (asyncPhase == ASYNC_PHASE_SEND)
+    {
+        writeCommand(asyncCmd, asyncArgc, asyncArgs);
+        if (asyncOperation == ASYNC_OP_PATCH)
+            asyncPhase = ASYNC_PHASE_PATCH;
+        else if (asyncOperation == ASYNC_OP_PROPERTY)
+            asyncPhase = ASYNC_PHASE_RESPONSE; // No response: done at the next CTS
+        else
+            asyncPhase = (asyncOperation == ASYNC_OP_TUNE || asyncOperation == ASYNC_OP_SEEK) ? ASYNC_PHASE_STC : ASYNC_PHASE_RESPONSE;
+    }
+    else if (asyncPhase == ASYNC_PHASE_PATCH)
+    {
+        if (!asyncPatchPowerUp)
+        {
+            // Set to AM, Enable External Crystal Oscillator; Set patch enable; GPO2 output disabled; CTS interrupt disabled. Analog Output.
+            asyncArgs[0] = 0b00110001;
+            asyncArgs[1] = SI473X_ANALOG_AUDIO;
+            writeCommand(POWER_UP, 2, asyncArgs);
+            asyncPatchPowerUp = true;
+        }
+        else if (asyncPatchOffset < asyncPatchSize)
+        {
+            writeCommand(asyncPatch[asyncPatchOffset], 7, asyncPatch + asyncPatchOffset + 1); // 0x15 or 0x16 and 7 bytes
+            asyncPatchOffset += 8;
+        }
+        else
+        {
+            lastError = SI4735_OK;
+            return (asyncState = ASYNC_DONE);
+        }
+    }
+    else if (!asyncCancel && !si47x_status_view(&currentStatusByte.raw).stcint()) // ASYNC_PHASE_STC
+        writeCommand(GET_INT_STATUS, 0, NULL);
+    else
+    {
+        // Tune or seek complete (or cancelled): reads the tune status and clears STCINT
+        status.raw = 0;
+        status.arg.INTACK = 1;
+        status.arg.CANCEL = asyncCancel;
+        writeCommand((currentTune == FM_TUNE_FREQ) ? FM_TUNE_STATUS : (currentTune == NBFM_TUNE_FREQ) ? NBFM_TUNE_STATUS : AM_TUNE_STATUS, 1, &status.raw);
+        asyncPhase = ASYNC_PHASE_RESPONSE;
+    }
+    return ASYNC_BUSY;
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Writes a command frame without waiting for CTS.
+ *
+ * @details The command and its arguments are assembled in a stack buffer and sent with a single write.
+ * @details Power up, power down and patch download restore the device default properties, so these commands
+ * @details also invalidate the property shadow cache. A SET_PROPERTY drops the cached value of its property: the
+ * @details callers that know the result (sendProperty, poll) cache it again.
+ *
+ * @param cmd command opcode
+ * @param argc number of arguments
+ * @param args arguments
+ */
+void SI4735Base::writeCommand(uint8_t cmd, uint8_t argc, const uint8_t *args)
+{
+    uint8_t size = Protocol::writeFrame(i2c, deviceAddress, cmd, argc, args);
+
+    SI4735_STATS_ADD(cmd, commands, 1);
+    SI4735_STATS_ADD(cmd, bytesWritten, size);
+
+    if (cmd == POWER_UP || cmd == POWER_DOWN || cmd == PATCH_ARGS || cmd == PATCH_DATA)
+        invalidatePropertyCache();
+    else if (cmd == SET_PROPERTY && argc >= 3)
+        forgetProperty((uint16_t)args[1] << 8 | args[2]);
+}
+
+/**
+ * @ingroup group21 Async commands
+ *
+ * @brief Reads the status byte (and the response bytes) once, without waiting for CTS.
+ *
+ * @param resp buffer that receives the bytes; resp[0] is the status byte.
+ * @param size number of bytes to read.
+ */
+void SI4735Base::getStatusBytes(uint8_t *resp, uint8_t size)
+{
+    Protocol::readBytes(i2c, deviceAddress, resp, size);
+    SI4735_STATS_ADD(asyncCmd, ctsPolls, 1);
+    SI4735_STATS_ADD(asyncCmd, bytesRead, size);
 }
@@ -40,6 +40,8 @@
 #define SET_PROPERTY 0x12   // Sets the value of a property.
 #define GET_PROPERTY 0x13   // Retrieves a property’s value.
 #define GET_INT_STATUS 0x14 // Read interrupt status bits.
+#define PATCH_ARGS 0x15     // Patch download: first (command/arguments) line of a patch.
+#define PATCH_DATA 0x16     // Patch download: data lines of a patch.
 
 // FM
 #define FM_TUNE_FREQ 0x20
@@ -152,6 +154,8 @@
 #define RX_VOLUME 0x4000
 #define RX_HARD_MUTE 0x4001
 
+#define FM_DEBUG_CONTROL 0xFF00 // Undocumented. Write 0 to disable the D60 firmware debug feature (see disableFmDebug).
+
 // SSB properties
 // See AN332 REV 0.8 Universal Programming Guide (Amendment for SI4735-D60 SSN and NBFM Patches)
 
@@ -204,9 +208,89 @@
 #define MAX_DELAY_AFTER_SET_FREQUENCY 30 // In ms - This value helps to improve the precision during of getting frequency value
 #define MAX_DELAY_AFTER_POWERUP 10       // In ms - Max delay you have to setup after a power up command.
 #define MIN_DELAY_WAIT_SEND_LOOP 300     // In uS (Microsecond) - each loop of waitToSend sould wait this value in microsecond
+#define MIN_DELAY_CTS_POLL 20            // In uS - first waitToSend backoff step. It doubles on each retry up to MIN_DELAY_WAIT_SEND_LOOP
+#define MAX_DELAY_WAIT_INTERRUPT 2000    // In uS - maximum time waitToSend blocks on the GPO2/INT line before polling the bus
+#define MAX_DELAY_STC_POLL 2000          // In uS - backoff ceiling used while polling STCINT after a tune command
+#define MAX_DELAY_SEEK_POLL 20000        // In uS - backoff ceiling used while polling STCINT during a seek (about one FM channel)
+#define SEEK_PROGRESS_INTERVAL 50        // In ms - default interval of the seek progress reports (seekStationProgress)
+
+// Tune completion (see setTuneWait)
+#define TUNE_WAIT_PREDICTED 0 // Sleeps the calibrated tune time, then polls STCINT (default)
+#define TUNE_WAIT_STC 1       // Polls STCINT (or blocks on the interrupt line) right away: returns as soon as the tune completes
+#define TUNE_WAIT_FIXED 2     // Sleeps maxDelaySetFrequency without polling (the behavior of the first library versions)
+
+// Latency model - initial predictions (uS) used by waitToSend / waitTuneComplete before any calibration
+#define LATENCY_SLOTS 29                 // One slot per known command opcode plus one shared by unknown opcodes
+#define LATENCY_POWER 2500               // POWER_UP and POWER_DOWN
+#define LATENCY_PROPERTY 550             // SET_PROPERTY and FM_RDS_STATUS
+#define LATENCY_COMMAND 300              // Other commands (status queries, AGC, GPIO, patch lines)
+#define LATENCY_TUNE_FM 20000            // FM_TUNE_FREQ until STCINT
+#define LATENCY_TUNE_AM 30000            // AM_TUNE_FREQ (and SSB) until STCINT
+#define LATENCY_TUNE_NBFM 30000          // NBFM_TUNE_FREQ until STCINT
+
+// Command errors (see getLastError) and retry policy (see setRetryPolicy)
+#define SI4735_OK 0                // No error
+#define SI4735_ERR_DEVICE 1        // The device answered with the ERR bit set
+#define SI4735_ERR_TIMEOUT 2       // The device did not get ready (CTS) in time
+#define MAX_COMMAND_RETRIES 3      // Default number of times a command is sent again after an ERR response
+#define MAX_DELAY_CTS_TIMEOUT 1000 // In ms - default maximum time waiting for CTS
+
+// Property shadow cache (see sendProperty / getProperty)
+#define PROPERTY_CACHE_SIZE 48 // Number of properties kept in the cache
+
+// I2C bus speeds (see setBusSpeedControl)
+#define I2C_SPEED_LOW 10000          // In Hz - low speed mode (long or noisy wires)
+#define I2C_SPEED_STANDARD 100000    // In Hz - standard mode; default speed outside the bulk transfers
+#define I2C_SPEED_FAST 400000        // In Hz - fast mode; highest speed of the Si47XX data sheet; default bulk speed
+#define I2C_SPEED_FAST_CUSTOM 500000 // In Hz - default of setI2CFastModeCustom
+#define BUS_PROBE_READS 16           // Status reads at each speed tried by probeBusSpeed
+#define MAX_RDS_FIFO_GROUPS 25       // Groups held by the RDS FIFO of the Si4735-D60 (see drainRdsFifo)
+
+// Async (non-blocking) commands. See poll()
+#define ASYNC_IDLE 0        // No command in flight
+#define ASYNC_BUSY 1        // Command in flight; call poll() again
+#define ASYNC_DONE 2        // Command complete; the result is in currentStatus, currentRdsStatus or currentRqsStatus
+#define ASYNC_ERROR 3       // The device reported an error (ERR) or the command timed out
+#define ASYNC_CANCELLED 4   // The seek was cancelled (cancelAsync); currentStatus has the channel where it stopped
+#define ASYNC_OP_TUNE 1     // beginTune
+#define ASYNC_OP_SEEK 2     // beginSeek
+#define ASYNC_OP_RDS 3      // beginRdsRead
+#define ASYNC_OP_RSQ 4      // beginRsqRead
+#define ASYNC_OP_PATCH 5    // beginPatch
+#define ASYNC_OP_PROPERTY 6 // beginSetProperty
+#define ASYNC_PHASE_SEND 0     // Waiting for CTS to send the command
+#define ASYNC_PHASE_STC 1      // Tune or seek sent; polling STCINT with GET_INT_STATUS
+#define ASYNC_PHASE_RESPONSE 2 // Waiting for the response
+#define ASYNC_PHASE_PATCH 3    // Patch download: power up in patch mode, then one line per CTS
+#define MAX_ASYNC_TIME 1000 // In ms - timeout of the async commands (seek uses maxSeekTime)
+
+// Bus instrumentation (see getBusStats). Compiled only when SI4735_INSTRUMENTATION is defined; otherwise it costs nothing.
+#define SI4735_STATS_BUCKETS 16 // Latency histogram buckets: bucket i counts commands that took [2^i, 2^(i+1)) uS
+#ifdef SI4735_INSTRUMENTATION
+#define SI4735_STATS_ADD(cmd, field, n) (this->busStats.command[getCommandSlot(cmd)].field += (n))
+#define SI4735_STATS_LATENCY(cmd, us) addLatencySample(cmd, us)
+#define SI4735_TRACE_BEGIN(name, kind, cmd) (this->tracer != NULL ? this->tracer->begin(name, kind, cmd) : (void)0)
+#define SI4735_TRACE_END() (this->tracer != NULL ? this->tracer->end() : (void)0)
+#define SI4735_TRACE_SCOPE(name) SI4735TraceScope traceScope(this->tracer, name)
+#else
+// The arguments are named but not evaluated, so a value kept only for the statistics or the trace does not warn as unused
+#define SI4735_STATS_ADD(cmd, field, n) ((void)sizeof(cmd), (void)sizeof(n))
+#define SI4735_STATS_LATENCY(cmd, us) ((void)sizeof(cmd), (void)sizeof(us))
+#define SI4735_TRACE_BEGIN(name, kind, cmd) ((void)sizeof(cmd))
+#define SI4735_TRACE_END() ((void)0)
+#define SI4735_TRACE_SCOPE(name) ((void)0)
+#endif
+
+// Span kinds reported to SI4735Tracer (see setTracer)
+#define TRACE_OPERATION 0 // Driver operation (setFrequency, seekStation, loadPatch, getRdsStatus...)
+#define TRACE_I2C 1       // Bus transfer (reported by the transport, see SI4735ChromeTrace)
+#define TRACE_CTS 2       // Wait for CTS: sleep on the predicted latency and status polls
+#define TRACE_STC 3       // Wait for STCINT after a tune or seek
+#define TRACE_SLEEP 4     // Fixed delay (see fixedWait)
 #define MAX_SEEK_TIME 8000               // defines the maximum seeking time 8s is default.
 
 #define DEFAULT_CURRENT_AVC_AM_MAX_GAIN 36
+#define DEFAULT_VOLUME 32
 
 #define XOSCEN_CRYSTAL 1 // Use crystal oscillator
 #define XOSCEN_RCLK 0    // Use external RCLK (crystal oscillator disabled).
@@ -892,6 +976,136 @@ typedef union
     uint8_t raw[6];
 } si47x_rds_date_time;
 
+/**
+ * @ingroup group01
+ *
+ * @brief Extracts a bit field from a response byte: width bits starting at bit shift (bit 0 = least significant).
+ */
+constexpr uint8_t si47xBits(uint8_t value, uint8_t shift, uint8_t width)
+{
+    return (uint8_t)((value >> shift) & ((1 << width) - 1));
+}
+
+/**
+ * @ingroup group01
+ *
+ * @brief Read-only view of a status byte (first byte of every response)
+ *
+ * @details The views below decode the raw response bytes with shifts and masks instead of bit-fields, so the result does
+ * @details not depend on the compiler bit-field layout. They only hold a pointer to the receive buffer: nothing is copied.
+ *
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); page 63
+ */
+struct si47x_status_view
+{
+    const uint8_t *raw;
+
+    constexpr explicit si47x_status_view(const uint8_t *raw) : raw(raw) {}
+
+    constexpr bool cts() const { return raw[0] & 0B10000000; }    //!< Clear to Send
+    constexpr bool err() const { return raw[0] & 0B01000000; }    //!< Error
+    constexpr bool rsqint() const { return raw[0] & 0B00001000; } //!< Received Signal Quality interrupt
+    constexpr bool rdsint() const { return raw[0] & 0B00000100; } //!< RDS interrupt
+    constexpr bool stcint() const { return raw[0] & 0B00000001; } //!< Seek/Tune Complete interrupt
+};
+
+/**
+ * @ingroup group01
+ *
+ * @brief Read-only view of a FM_TUNE_STATUS / AM_TUNE_STATUS / NBFM_TUNE_STATUS response (see si47x_response_status)
+ *
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 73 and 139
+ */
+struct si47x_tune_status_view : si47x_status_view
+{
+    constexpr explicit si47x_tune_status_view(const uint8_t *raw) : si47x_status_view(raw) {}
+
+    constexpr bool bltf() const { return raw[1] & 0B10000000; }  //!< Seek hit the band limit
+    constexpr bool afcrl() const { return raw[1] & 0B00000010; } //!< AFC rail
+    constexpr bool valid() const { return raw[1] & 0B00000001; } //!< Valid channel
+    constexpr uint16_t frequency() const { return (uint16_t)((raw[2] << 8) | raw[3]); }
+    constexpr uint8_t rssi() const { return raw[4]; }
+    constexpr uint8_t snr() const { return raw[5]; }
+    constexpr uint8_t mult() const { return raw[6]; }       //!< FM multipath (AM: READANTCAPH)
+    constexpr uint8_t readAntCap() const { return raw[7]; } //!< FM antenna capacitor (AM: READANTCAPL)
+    constexpr uint16_t amAntCap() const { return (uint16_t)((raw[6] << 8) | raw[7]); }
+};
+
+/**
+ * @ingroup group01
+ *
+ * @brief Read-only view of a FM_RSQ_STATUS / AM_RSQ_STATUS / NBFM_RSQ_STATUS response (see si47x_rqs_status)
+ *
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 75 and 141
+ */
+struct si47x_rsq_view : si47x_status_view
+{
+    constexpr explicit si47x_rsq_view(const uint8_t *raw) : si47x_status_view(raw) {}
+
+    constexpr bool blendint() const { return raw[1] & 0B10000000; }
+    constexpr bool multhint() const { return raw[1] & 0B00100000; }
+    constexpr bool multlint() const { return raw[1] & 0B00010000; }
+    constexpr bool snrhint() const { return raw[1] & 0B00001000; }
+    constexpr bool snrlint() const { return raw[1] & 0B00000100; }
+    constexpr bool rssihint() const { return raw[1] & 0B00000010; }
+    constexpr bool rssilint() const { return raw[1] & 0B00000001; }
+    constexpr bool smute() const { return raw[2] & 0B00001000; }
+    constexpr bool afcrl() const { return raw[2] & 0B00000010; }
+    constexpr bool valid() const { return raw[2] & 0B00000001; }
+    constexpr bool pilot() const { return raw[3] & 0B10000000; }
+    constexpr uint8_t stblend() const { return si47xBits(raw[3], 0, 7); }
+    constexpr uint8_t rssi() const { return raw[4]; }
+    constexpr uint8_t snr() const { return raw[5]; }
+    constexpr uint8_t mult() const { return raw[6]; }
+    constexpr int8_t freqoff() const { return (int8_t)raw[7]; }
+};
+
+/**
+ * @ingroup group01
+ *
+ * @brief Read-only view of a FM_RDS_STATUS response (see si47x_rds_status) and of the group it carries
+ *
+ * @details Block B fields follow si47x_rds_blockb; the group 4A fields (date and time) use blocks B, C and D.
+ *
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 77 and 78
+ * @see https://en.wikipedia.org/wiki/Radio_Data_System
+ */
+struct si47x_rds_view : si47x_status_view
+{
+    constexpr explicit si47x_rds_view(const uint8_t *raw) : si47x_status_view(raw) {}
+
+    constexpr bool newBlockB() const { return raw[1] & 0B00100000; }
+    constexpr bool newBlockA() const { return raw[1] & 0B00010000; }
+    constexpr bool syncFound() const { return raw[1] & 0B00000100; }
+    constexpr bool syncLost() const { return raw[1] & 0B00000010; }
+    constexpr bool received() const { return raw[1] & 0B00000001; }
+    constexpr bool groupLost() const { return raw[2] & 0B00000100; }
+    constexpr bool sync() const { return raw[2] & 0B00000001; }
+    constexpr uint8_t fifoUsed() const { return raw[3]; }
+
+    constexpr uint16_t blockA() const { return (uint16_t)((raw[4] << 8) | raw[5]); }
+    constexpr uint16_t blockB() const { return (uint16_t)((raw[6] << 8) | raw[7]); }
+    constexpr uint16_t blockC() const { return (uint16_t)((raw[8] << 8) | raw[9]); }
+    constexpr uint16_t blockD() const { return (uint16_t)((raw[10] << 8) | raw[11]); }
+    constexpr uint8_t blockErrors(uint8_t block) const { return si47xBits(raw[12], 6 - 2 * block, 2); } //!< block: 0 = A ... 3 = D
+
+    // Block B
+    constexpr uint8_t groupType() const { return si47xBits(raw[6], 4, 4); }
+    constexpr uint8_t versionCode() const { return si47xBits(raw[6], 3, 1); } //!< 0 = A; 1 = B
+    constexpr uint8_t trafficProgramCode() const { return si47xBits(raw[6], 2, 1); }
+    constexpr uint8_t programType() const { return (uint8_t)((si47xBits(raw[6], 0, 2) << 3) | si47xBits(raw[7], 5, 3)); }
+    constexpr uint8_t textABFlag() const { return si47xBits(raw[7], 4, 1); }
+    constexpr uint8_t content() const { return si47xBits(raw[7], 0, 4); }      //!< Group 2: text segment address
+    constexpr uint8_t psAddress() const { return si47xBits(raw[7], 0, 2); }    //!< Group 0: program service segment address
+
+    // Group 4A - clock time and date
+    constexpr uint8_t offset() const { return si47xBits(raw[11], 0, 5); }      //!< Local time offset (multiple of 30 minutes)
+    constexpr uint8_t offsetSense() const { return si47xBits(raw[11], 5, 1); } //!< 0 = +, 1 = -
+    constexpr uint8_t minute() const { return (uint8_t)((si47xBits(raw[10], 0, 4) << 2) | si47xBits(raw[11], 6, 2)); }
+    constexpr uint8_t hour() const { return (uint8_t)((si47xBits(raw[9], 0, 1) << 4) | si47xBits(raw[10], 4, 4)); }
+    constexpr uint32_t mjd() const { return ((uint32_t)si47xBits(raw[7], 0, 2) << 15) | ((uint32_t)raw[8] << 7) | (raw[9] >> 1); }
+};
+
 /**
  * @ingroup group01
  *
@@ -1049,6 +1263,562 @@ typedef struct
     uint16_t DOSR;                   // Digital Output Sample Rate(32–48 ksps .0 to disable digital audio output).
 } si4735_digital_output_sample_rate; // Maybe not necessary
 
+/**
+ * @ingroup group10 Generic set and get property
+ *
+ * @brief A property and the value to be set
+ *
+ * @details Element of the property lists used by applyProperties.
+ *
+ * @see applyProperties
+ */
+typedef struct
+{
+    uint16_t property; //!< Property number (example: RX_VOLUME)
+    uint16_t value;    //!< Property value
+} PropertyValue;
+
+/**
+ * @ingroup group08 Received Signal Quality
+ *
+ * @brief Signal quality of one channel measured by scanBand
+ *
+ * @details multipath and offset come from FM_RSQ_STATUS (MULT and FREQOFF); they are 0 on AM and SSB.
+ *
+ * @see scanBand
+ */
+typedef struct
+{
+    uint16_t frequency; //!< Channel (same unit as setFrequency)
+    uint8_t rssi;       //!< dBuV
+    uint8_t snr;        //!< dB
+    uint8_t multipath;  //!< FM multipath (0 to 100)
+    int8_t offset;      //!< FM frequency offset in kHz
+} si47x_scan_record;
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Entry of an antenna capacitor table: the capacitor of a frequency segment
+ *
+ * @details A table is sorted by frequency; each entry applies from its frequency up to the frequency of the next entry
+ * @details (the last one to the end of the band). Capacitor 0 means "not calibrated": the capacitor in use when the table was
+ * @details attached (automatic, or the one given to setTuneFrequencyAntennaCapacitor) is sent.
+ *
+ * @see calibrateAntennaCapacitor, setAntennaCapacitorTable
+ */
+typedef struct
+{
+    uint16_t frequency; //!< First frequency of the segment (same unit as setFrequency)
+    uint16_t capacitor; //!< ANTCAP of the segment (FM 1 to 191; AM 1 to 6143; 0 = not calibrated)
+    uint8_t rssi;       //!< Peak RSSI (dBuV) measured by calibrateAntennaCapacitor
+    uint8_t snr;        //!< SNR (dB) at the peak
+} si4735_antcap_entry;
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Bus counters of one command opcode
+ *
+ * @details Times are in uS and add up the delays requested from the Clock (predicted sleeps, CTS and STCINT polling backoff
+ * @details and fixed clock.wait calls), so they do not depend on the resolution of Clock::now.
+ * @details The fixed waits that are not related to a command (EEPROM reads) are counted in the entry of opcode 0.
+ *
+ * @see getBusStats, getCommandStats
+ */
+typedef struct
+{
+    uint8_t opcode;                           //!< Command opcode (0 for the entry shared by the other opcodes)
+    uint32_t commands;                        //!< Commands (or patch lines) written
+    uint32_t bytesWritten;                    //!< Bytes written, command byte included
+    uint32_t bytesRead;                       //!< Bytes read (status polls and responses)
+    uint32_t ctsPolls;                        //!< Bus reads done waiting for CTS (the read that got the response included)
+    uint32_t ctsWaitTime;                     //!< Time waiting for CTS (predicted sleep plus polling backoff)
+    uint32_t stcWaitTime;                     //!< Time waiting for STCINT after a tune command
+    uint32_t sleepTime;                       //!< Time in fixed waits (see fixedWait)
+    uint32_t latency[SI4735_STATS_BUCKETS];  //!< log2 histogram of the time from command to CTS
+} si4735_command_stats;
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Snapshot of the bus counters, one entry per command slot
+ *
+ * @see getBusStats
+ */
+typedef struct
+{
+    si4735_command_stats command[LATENCY_SLOTS];
+} si4735_bus_stats;
+
+/**
+ * @ingroup group08 Tune Frequency
+ *
+ * @brief Tune-to-ready latency of one band (FM, AM, SSB or NBFM): time from the end of the tune command to STCINT
+ *
+ * @details Times are in uS and, like stcWaitTime, add up the sleeps and the polling backoff (the bus time of the STCINT
+ * @details polls is not included); they are rounded up to the polling step.
+ *
+ * @see getTuneStats, getTuneSettleTime
+ */
+typedef struct
+{
+    uint32_t tunes; //!< Tunes measured
+    uint32_t last;  //!< Last tune
+    uint32_t min;   //!< Fastest tune
+    uint32_t max;   //!< Slowest tune
+    uint32_t total; //!< Sum of the tunes (total / tunes is the average)
+} si4735_tune_stats;
+
+#define CMD_MODE_FM (1 << FM_CURRENT_MODE)     // Command accepted in FM mode
+#define CMD_MODE_AM (1 << AM_CURRENT_MODE)     // Command accepted in AM mode
+#define CMD_MODE_SSB (1 << SSB_CURRENT_MODE)   // Command accepted in SSB mode (SSB patch)
+#define CMD_MODE_NBFM (1 << NBFM_CURRENT_MODE) // Command accepted in NBFM mode (NBFM patch)
+#define CMD_MODE_ANY (CMD_MODE_FM | CMD_MODE_AM | CMD_MODE_SSB | CMD_MODE_NBFM)
+
+/**
+ * @ingroup group10 Generic Command and Response
+ *
+ * @brief Descriptor of a command opcode
+ *
+ * @see SI4735_COMMANDS, getCommandInfo
+ */
+typedef struct
+{
+    uint8_t opcode;   //!< Command opcode
+    uint8_t minArgs;  //!< Minimum number of argument bytes
+    uint8_t maxArgs;  //!< Maximum number of argument bytes (up to 7)
+    uint8_t response; //!< Response bytes, status byte included
+    uint8_t modes;    //!< Modes where the command is accepted (CMD_MODE_FM, CMD_MODE_AM...)
+} si4735_command_info;
+
+/**
+ * @ingroup group10 Generic Command and Response
+ *
+ * @brief Commands used by the library (the index of a command is its slot in the per-command tables, see getCommandSlot)
+ *
+ * @details SSB commands share the AM opcodes.
+ * @details The table is a static member, so there is one copy in the program (defined in si4735-cpp.cpp for C++11 and
+ * @details C++14; an inline variable from C++17), while the compile-time checks still read it as a constant expression.
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 64 and 127
+ */
+class SI4735CommandTable
+{
+public:
+    static constexpr si4735_command_info commands[LATENCY_SLOTS - 1] = {
+        {POWER_UP, 2, 2, 8, CMD_MODE_ANY}, // 8 response bytes for the library ID query (FUNC = 15)
+        {GET_REV, 0, 0, 9, CMD_MODE_ANY},
+        {POWER_DOWN, 0, 0, 1, CMD_MODE_ANY},
+        {SET_PROPERTY, 5, 5, 1, CMD_MODE_ANY},
+        {GET_PROPERTY, 3, 3, 4, CMD_MODE_ANY},
+        {GET_INT_STATUS, 0, 0, 1, CMD_MODE_ANY},
+        {PATCH_ARGS, 7, 7, 1, CMD_MODE_ANY},
+        {PATCH_DATA, 7, 7, 1, CMD_MODE_ANY},
+        {FM_TUNE_FREQ, 3, 4, 1, CMD_MODE_FM},
+        {FM_SEEK_START, 1, 1, 1, CMD_MODE_FM},
+        {FM_TUNE_STATUS, 1, 1, 8, CMD_MODE_FM},
+        {FM_RSQ_STATUS, 1, 1, 8, CMD_MODE_FM},
+        {FM_RDS_STATUS, 1, 1, 13, CMD_MODE_FM},
+        {FM_AGC_STATUS, 0, 0, 3, CMD_MODE_FM},
+        {FM_AGC_OVERRIDE, 2, 2, 1, CMD_MODE_FM},
+        {AM_TUNE_FREQ, 4, 5, 1, CMD_MODE_AM | CMD_MODE_SSB},
+        {AM_SEEK_START, 1, 5, 1, CMD_MODE_AM},
+        {AM_TUNE_STATUS, 1, 1, 8, CMD_MODE_AM | CMD_MODE_SSB},
+        {AM_RSQ_STATUS, 1, 1, 6, CMD_MODE_AM | CMD_MODE_SSB},
+        {AM_AGC_STATUS, 0, 0, 3, CMD_MODE_AM | CMD_MODE_SSB},
+        {AM_AGC_OVERRIDE, 2, 2, 1, CMD_MODE_AM | CMD_MODE_SSB},
+        {NBFM_TUNE_FREQ, 3, 4, 1, CMD_MODE_NBFM},
+        {NBFM_TUNE_STATUS, 1, 1, 8, CMD_MODE_NBFM},
+        {NBFM_RSQ_STATUS, 1, 1, 8, CMD_MODE_NBFM},
+        {NBFM_AGC_STATUS, 0, 0, 3, CMD_MODE_NBFM},
+        {NBFM_AGC_OVERRIDE, 2, 2, 1, CMD_MODE_NBFM},
+        {GPIO_CTL, 1, 1, 1, CMD_MODE_ANY},
+        {GPIO_SET, 1, 1, 1, CMD_MODE_ANY}};
+};
+
+#define SI4735_COMMANDS SI4735CommandTable::commands // Commands used by the library (see SI4735CommandTable)
+
+/**
+ * @ingroup group10 Generic Command and Response
+ *
+ * @brief Index of a command in SI4735_COMMANDS (LATENCY_SLOTS - 1 if the opcode is unknown). Usable in constant expressions.
+ */
+constexpr uint8_t si4735CommandIndex(uint8_t cmd, uint8_t i = 0)
+{
+    return (i >= LATENCY_SLOTS - 1 || SI4735_COMMANDS[i].opcode == cmd) ? i : si4735CommandIndex(cmd, i + 1);
+}
+
+/**
+ * @ingroup group10 Generic Command and Response
+ *
+ * @brief true if the opcode is in SI4735_COMMANDS and argc is a valid number of arguments for it.
+ */
+constexpr bool si4735CommandAccepts(uint8_t cmd, uint8_t argc)
+{
+    return si4735CommandIndex(cmd) < LATENCY_SLOTS - 1 &&
+           argc >= SI4735_COMMANDS[si4735CommandIndex(cmd)].minArgs && argc <= SI4735_COMMANDS[si4735CommandIndex(cmd)].maxArgs;
+}
+
+/**
+ * @ingroup group05
+ *
+ * @brief GPO2/INT interrupt line interface
+ *
+ * @details When the CTS interrupt is enabled (CTSIEN in setPowerUp or setGpioIen) and GPO2 is an output (GPO2OEN),
+ * @details the Si47XX drives the GPO2/INT pin low when it is clear to send the next command.
+ * @details Implement this class for your platform (GPIO read, edge interrupt flag, poll() on a gpiochip etc)
+ * @details and pass it to setInterruptLine. waitToSend will then block on the line instead of polling the I2C bus.
+ *
+ * @see setInterruptLine, waitToSend
+ * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 13, 65 and 146
+ */
+class SI4735InterruptLine
+{
+public:
+    virtual ~SI4735InterruptLine() {}
+
+    /**
+     * @brief Waits for the GPO2/INT line to signal an interrupt.
+     * @param timeout_us maximum time to wait in microseconds.
+     * @return true if the line signaled within the timeout; false otherwise.
+     */
+    virtual bool wait(uint16_t timeout_us) = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief Combined write-then-read I2C transaction interface
+ *
+ * @details Some I2C transports (for example, Linux i2c-dev with I2C_RDWR) can write a command frame and read the
+ * @details response in a single repeated-start sequence, saving one bus round trip (and one syscall) per command.
+ * @details Implement this class in your I2C transport and pass it to setTransaction. transact then writes every
+ * @details command and reads its response in one sequence; if the device was not ready yet (CTS clear), the response is
+ * @details read again after the predicted latency of the command, as on the regular write / read path.
+ *
+ * @see setTransaction, transact
+ */
+class SI4735Transaction
+{
+public:
+    /**
+     * @brief Writes out and reads in using a repeated start between the two messages.
+     * @param address I2C bus address of the device.
+     * @param out bytes to write (command frame).
+     * @param outSize number of bytes to write.
+     * @param in buffer that receives the response.
+     * @param inSize number of bytes to read.
+     * @return true on success; false if the transport failed.
+     */
+    virtual bool writeRead(int address, const uint8_t *out, size_t outSize, uint8_t *in, size_t inSize) = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2C bus clock control
+ *
+ * @details Implement this class for your I2C transport (for example, calling Wire.setClock on Arduino; see
+ * @details SI4735ArduinoBusSpeed) and pass it to setBusSpeedControl. The driver then runs the bulk transfers (patch
+ * @details download, RDS FIFO drain) at the bulk speed and everything else at the normal speed.
+ *
+ * @see setBusSpeedControl, probeBusSpeed
+ */
+class SI4735BusSpeed
+{
+public:
+    /**
+     * @brief Sets the I2C clock.
+     * @param hz clock in Hz.
+     * @return false if the transport cannot run at this speed.
+     */
+    virtual bool setSpeed(uint32_t hz) = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief Timeline of the driver operations
+ *
+ * @details With SI4735_INSTRUMENTATION, the driver reports a span for each operation (setFrequency, seekStation,
+ * @details loadPatch, getRdsStatus, mode switches...) and, nested inside, the waits for CTS and STCINT and the fixed delays.
+ * @details Spans always end in the reverse order they begin. Implement this class to record them (SI4735ChromeTrace of the
+ * @details host library writes Chrome trace JSON) and pass it to setTracer.
+ *
+ * @see setTracer
+ */
+class SI4735Tracer
+{
+public:
+    /**
+     * @brief Starts a span.
+     * @param name span name (a string literal; it lives as long as the program).
+     * @param kind TRACE_OPERATION, TRACE_CTS, TRACE_STC or TRACE_SLEEP (TRACE_I2C is for transports).
+     * @param cmd command opcode the span belongs to (0 if none).
+     */
+    virtual void begin(const char *name, uint8_t kind, uint8_t cmd) = 0;
+
+    /**
+     * @brief Ends the last span started.
+     */
+    virtual void end() = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief Operation span that ends when the scope ends (see SI4735_TRACE_SCOPE).
+ */
+struct SI4735TraceScope
+{
+    SI4735Tracer *tracer;
+
+    SI4735TraceScope(SI4735Tracer *tracer, const char *name) : tracer(tracer)
+    {
+        if (tracer != NULL)
+            tracer->begin(name, TRACE_OPERATION, 0);
+    }
+    ~SI4735TraceScope()
+    {
+        if (tracer != NULL)
+            tracer->end();
+    }
+};
+
+/**
+ * @ingroup group06 Wait to send command
+ *
+ * @brief Protocol engine shared by SI4735Base and SI4735Core (si4735-core.h).
+ *
+ * @details Command framing, the CTS polling with its adaptive backoff, the STCINT polling, the latency calibration and
+ * @details the command arguments are implemented once here. SI4735Base uses SI4735Protocol<I2C, Clock>; SI4735Core
+ * @details instantiates it with the concrete transport and clock, so the same code runs without virtual calls.
+ * @details The callers keep their state (latency tables, delays, errors) and add their own statistics and trace.
+ *
+ * @tparam Transport I2C transport (beginTransmission, write(const uint8_t *, size_t), endTransmission, requestFrom, read).
+ * @tparam ClockT clock (wait and waitMicroseconds).
+ */
+template <typename Transport, typename ClockT>
+struct SI4735Protocol
+{
+    /**
+     * @brief Assembles a command and its arguments in frame (8 bytes).
+     * @return uint8_t frame size (the Si47XX accepts up to 8 bytes per write, so at most 7 arguments are kept).
+     */
+    static uint8_t buildFrame(uint8_t *frame, uint8_t cmd, uint8_t argc, const uint8_t *args)
+    {
+        if (argc > 7)
+            argc = 7;
+        frame[0] = cmd;
+        for (uint8_t i = 0; i < argc; i++)
+            frame[i + 1] = args[i];
+        return argc + 1;
+    }
+
+    /**
+     * @brief Writes a command and its arguments with a single write.
+     * @return uint8_t bytes written.
+     */
+    static uint8_t writeFrame(Transport &bus, int16_t address, uint8_t cmd, uint8_t argc, const uint8_t *args)
+    {
+        uint8_t frame[8];
+        uint8_t size = buildFrame(frame, cmd, argc, args);
+
+        bus.beginTransmission(address);
+        bus.write(frame, size);
+        bus.endTransmission();
+        return size;
+    }
+
+    /**
+     * @brief Reads the status byte and the response bytes once (resp[0] is the status byte).
+     */
+    static void readBytes(Transport &bus, int16_t address, uint8_t *resp, uint8_t size)
+    {
+        bus.requestFrom(address, size);
+        for (uint8_t i = 0; i < size; i++)
+            resp[i] = bus.read();
+    }
+
+    /**
+     * @brief Next backoff step: doubles the delay up to maxDelay.
+     */
+    static inline uint16_t nextDelay(uint16_t delay, uint16_t maxDelay) { return (delay < (maxDelay >> 1)) ? (delay << 1) : maxDelay; }
+
+    /**
+     * @brief Reads the response until CTS is set, with a backoff from minDelay to maxDelay between reads.
+     *
+     * @param resp buffer for the response; resp[0] is the status byte.
+     * @param size response size in bytes (1 reads the status byte only).
+     * @param limit maximum time (uS) polling.
+     * @param read false if resp already holds the first read (combined write-then-read transaction).
+     * @param waited receives the time (uS) spent polling.
+     * @param reads receives the number of reads done.
+     * @return false if CTS was not set within limit.
+     */
+    static bool pollCts(Transport &bus, ClockT &clock, int16_t address, uint8_t *resp, uint8_t size, uint16_t minDelay,
+                        uint16_t maxDelay, uint32_t limit, bool read, uint32_t *waited, uint16_t *reads)
+    {
+        uint16_t delay = minDelay;
+
+        *waited = 0;
+        *reads = 0;
+        for (;;)
+        {
+            if (read)
+            {
+                readBytes(bus, address, resp, size);
+                (*reads)++;
+            }
+            read = true;
+            if (resp[0] & 0B10000000)
+                return true;
+            if (*waited >= limit)
+                return false;
+            clock.waitMicroseconds(delay);
+            *waited += delay;
+            delay = nextDelay(delay, maxDelay);
+        }
+    }
+
+    /**
+     * @brief Sleeps predicted uS, then polls STCINT with a backoff from firstDelay up to MAX_DELAY_STC_POLL.
+     *
+     * @param stcint polls the device once (GET_INT_STATUS and CTS) and returns true when STCINT is set.
+     * @param sleep waits one backoff step (uS) and returns the time it spent (uS); it may return early, for example on
+     * an interrupt.
+     * @param polled set to true if STCINT was not set at the first poll.
+     * @return uint32_t time waited (uS).
+     */
+    template <typename PollStc, typename Sleep>
+    static uint32_t waitStc(ClockT &clock, uint32_t predicted, uint32_t limit, uint16_t firstDelay, bool *polled, PollStc stcint, Sleep sleep)
+    {
+        uint32_t waited = (predicted < limit) ? predicted : limit;
+        uint16_t delay = firstDelay;
+
+        clock.wait(waited / 1000);
+        clock.waitMicroseconds(waited % 1000);
+
+        *polled = false;
+        while (!stcint() && waited < limit)
+        {
+            *polled = true;
+            waited += sleep(delay);
+            delay = nextDelay(delay, MAX_DELAY_STC_POLL);
+        }
+        return waited;
+    }
+
+    /**
+     * @brief Calibrates a latency prediction.
+     *
+     * @details Shrinks the prediction by 1/8 when the device was ready right after it (waited = 0),
+     * @details otherwise grows it by 1/4 of the extra time spent polling.
+     *
+     * @param predicted the prediction (uS) to update.
+     * @param waited extra time (uS) spent polling after the predicted time.
+     */
+    static void updateLatency(uint16_t *predicted, uint32_t waited)
+    {
+        if (waited == 0)
+            *predicted -= *predicted >> 3;
+        else
+        {
+            waited = *predicted + (waited >> 2);
+            *predicted = (waited > 0xFFFF) ? 0xFFFF : waited;
+        }
+    }
+
+    /**
+     * @brief Calibrates a tune prediction with the time waited by waitStc.
+     */
+    static void updateTuneLatency(uint16_t *predicted, uint32_t settle, bool polled)
+    {
+        if (!polled)
+            updateLatency(predicted, 0);
+        else if (settle > *predicted)
+            updateLatency(predicted, settle - *predicted);
+    }
+
+    /**
+     * @brief Initial command (LATENCY_SLOTS entries, see si4735CommandIndex) and tune (FM, AM/SSB, NBFM) predictions.
+     */
+    static void resetLatency(uint16_t *commandLatency, uint16_t *tuneLatency)
+    {
+        for (uint8_t i = 0; i < LATENCY_SLOTS; i++)
+            commandLatency[i] = LATENCY_COMMAND;
+        commandLatency[si4735CommandIndex(POWER_UP)] = LATENCY_POWER;
+        commandLatency[si4735CommandIndex(POWER_DOWN)] = LATENCY_POWER;
+        commandLatency[si4735CommandIndex(SET_PROPERTY)] = LATENCY_PROPERTY;
+        commandLatency[si4735CommandIndex(FM_RDS_STATUS)] = LATENCY_PROPERTY;
+
+        tuneLatency[0] = LATENCY_TUNE_FM;
+        tuneLatency[1] = LATENCY_TUNE_AM; // AM and SSB
+        tuneLatency[2] = LATENCY_TUNE_NBFM;
+    }
+
+    /**
+     * @brief Arguments of FM_SEEK_START or AM_SEEK_START.
+     *
+     * @details On AM, ANTCAPL is 1 above 1800 kHz (SW), so the device selects the tuning capacitor automatically.
+     *
+     * @param tune current tune command (FM_TUNE_FREQ, AM_TUNE_FREQ...).
+     * @param frequency current frequency.
+     * @param arg buffer (5 bytes) that receives the arguments.
+     * @return uint8_t number of arguments.
+     */
+    static uint8_t seekArgs(uint8_t tune, uint16_t frequency, uint8_t SEEKUP, uint8_t WRAP, uint8_t *arg)
+    {
+        si47x_seek seek;
+        si47x_seek_am_complement seek_am_complement;
+
+        seek.arg.SEEKUP = SEEKUP;
+        seek.arg.WRAP = WRAP;
+        seek.arg.RESERVED1 = 0;
+        seek.arg.RESERVED2 = 0;
+
+        arg[0] = seek.raw; // ARG1
+
+        if (tune != FM_TUNE_FREQ) // Sets additional configuration for AM mode
+        {
+            seek_am_complement.ARG2 = seek_am_complement.ARG3 = 0;
+            seek_am_complement.ANTCAPH = 0;
+            seek_am_complement.ANTCAPL = (frequency > 1800) ? 1 : 0; // if SW = 1
+            arg[1] = seek_am_complement.ARG2;                        // ARG2 - Always 0
+            arg[2] = seek_am_complement.ARG3;                        // ARG3 - Always 0
+            arg[3] = seek_am_complement.ANTCAPH;                     // ARG4 - Tuning Capacitor: The tuning capacitor value
+            arg[4] = seek_am_complement.ANTCAPL;                     // ARG5 - will be selected automatically.
+            return 5;
+        }
+        return 1;
+    }
+
+    /**
+     * @brief Arguments of GET_PROPERTY (3 bytes).
+     */
+    static void propertyArgs(uint16_t property, uint8_t *arg)
+    {
+        arg[0] = 0x00;
+        arg[1] = property >> 8;   // Property - High byte - most significant first
+        arg[2] = property & 0xFF; // Property - Low byte - less significant after
+    }
+
+    /**
+     * @brief Arguments of SET_PROPERTY (5 bytes).
+     */
+    static void propertyArgs(uint16_t property, uint16_t value, uint8_t *arg)
+    {
+        propertyArgs(property, arg);
+        arg[3] = value >> 8; // Value - High byte - most significant first
+        arg[4] = value & 0xFF;
+    }
+
+    /**
+     * @brief Property value in a GET_PROPERTY response (resp[1] is a dummy byte).
+     */
+    static inline uint16_t propertyValue(const uint8_t *resp) { return ((uint16_t)resp[2] << 8) | resp[3]; }
+};
+
 /**********************************************************************
  * SI4735 Class definition
  **********************************************************************/
@@ -1067,6 +1837,8 @@ typedef struct
 class SI4735Base
 {
 protected:
+    typedef SI4735Protocol<I2C, Clock> Protocol;
+
     I2C& i2c;
     Clock& clock;
 
@@ -1086,8 +1858,11 @@ protected:
 
     // Delays
     uint16_t maxDelaySetFrequency = MAX_DELAY_AFTER_SET_FREQUENCY; //!< Stores the maximum delay after set frequency command (in ms).
+    uint8_t tuneWait = TUNE_WAIT_PREDICTED;                        //!< How setFrequency waits for the tune (see setTuneWait)
+    uint32_t tuneSettleTime = 0;                                   //!< Last tune-to-ready time (uS). See getTuneSettleTime
     uint16_t maxDelayAfterPowerUp = MAX_DELAY_AFTER_POWERUP;      //!< Stores the maximum delay you have to setup after a power up command (in ms).
     unsigned long maxSeekTime = MAX_SEEK_TIME;                     //!< Stores the maximum time (ms) for a seeking process. Defines the maximum seeking time.
+    uint16_t seekProgressInterval = SEEK_PROGRESS_INTERVAL;        //!< Time (ms) between two seek progress reports
 
     uint8_t lastTextFlagAB;
     uint8_t resetPin; //!<  pin used on Arduino Board to RESET the Si47XX device
@@ -1120,13 +1895,151 @@ protected:
     si47x_agc_status currentAgcStatus;       //!<  current AGC status
     si47x_ssb_mode currentSSBMode;           //!<  indicates if USB or LSB
 
-    si473x_powerup powerUp;
+    si473x_powerup powerUp;
+
+    uint8_t volume = DEFAULT_VOLUME; //!< Stores the current vlume setup (0-63).
+
+    uint8_t currentAudioMode = SI473X_ANALOG_AUDIO; //!< Current audio mode used (ANALOG or DIGITAL or both)
+    uint8_t currentSsbStatus;
+    int8_t audioMuteMcuPin = -1;
+
+    SI4735InterruptLine *interruptLine = NULL;               //!< GPO2/INT line used by waitToSend (NULL means CTS polling only).
+    uint16_t ctsInterruptTimeout = MAX_DELAY_WAIT_INTERRUPT; //!< Maximum time (uS) waitToSend blocks on the interrupt line.
+    uint16_t ctsPollMinDelay = MIN_DELAY_CTS_POLL;           //!< First backoff step (uS) of the CTS polling.
+    uint16_t ctsPollMaxDelay = MIN_DELAY_WAIT_SEND_LOOP;     //!< Backoff ceiling (uS) of the CTS polling.
+    SI4735Transaction *transaction = NULL;                   //!< Combined write-then-read transport used by transact (NULL means not supported).
+    SI4735BusSpeed *busSpeedControl = NULL;                  //!< I2C clock control (NULL means the speed is never changed). See setBusSpeedControl.
+    uint32_t busSpeedNormal = I2C_SPEED_STANDARD;            //!< I2C clock outside the bulk transfers (Hz)
+    uint32_t busSpeedBulk = I2C_SPEED_FAST;                  //!< I2C clock of the patch download and RDS FIFO drain (Hz)
+    uint32_t busSpeed = 0;                                   //!< I2C clock in use (0 = unknown)
+
+    uint8_t pendingCommand = 0;             //!< Last command sent and not yet confirmed by CTS (0 = none).
+    si47x_status currentStatusByte;         //!< Last status byte read by waitToSend.
+    uint16_t commandLatency[LATENCY_SLOTS]; //!< Predicted time (uS) from each command to CTS. See getCommandSlot.
+    uint16_t tuneLatency[3];                //!< Predicted time (uS) from a tune command to STCINT (FM, AM/SSB, NBFM).
+
+    const si4735_antcap_entry *antCapTable[2] = {NULL, NULL}; //!< Antenna capacitor table of FM and AM/SSB. See setAntennaCapacitorTable.
+    uint16_t antCapCount[2] = {0, 0};                         //!< Entries of each table.
+    uint16_t antCapCached[2] = {0, 0};                        //!< Entry found by the last lookup of each table.
+    uint16_t antCapFallback[2] = {0, 0};                      //!< Capacitor outside the calibrated segments of each table.
+    void (*antCapStore)(uint8_t tune, const si4735_antcap_entry *table, uint16_t count) = NULL; //!< See setAntennaCapacitorStore.
+
+    uint16_t shadowProperty[PROPERTY_CACHE_SIZE]; //!< Shadow cache: property numbers.
+    uint16_t shadowValue[PROPERTY_CACHE_SIZE];    //!< Shadow cache: last value written to (or read from) each property.
+    uint8_t shadowCount = 0;                      //!< Shadow cache: number of valid entries.
+    uint8_t shadowNext = 0;                       //!< Shadow cache: next entry replaced when the cache is full.
+    uint32_t propertyCacheHits = 0;               //!< Property writes skipped and reads served by the shadow cache.
+    uint32_t propertyCacheMisses = 0;             //!< Property writes and reads that went to the device.
+
+    int16_t findProperty(uint16_t propertyNumber);
+    void storeProperty(uint16_t propertyNumber, uint16_t value);
+    void forgetProperty(uint16_t propertyNumber);
+    uint8_t asyncState = ASYNC_IDLE; //!< ASYNC_IDLE, ASYNC_BUSY, ASYNC_DONE, ASYNC_ERROR or ASYNC_CANCELLED
+    uint8_t asyncOperation = 0;      //!< Current (or last) async operation (ASYNC_OP_TUNE etc)
+    uint8_t asyncPhase;              //!< Step of the current async operation (ASYNC_PHASE_SEND etc)
+    uint8_t asyncCmd;                //!< Command of the current async operation
+    uint8_t asyncArgs[7];            //!< Arguments of asyncCmd
+    uint8_t asyncArgc;               //!< Number of arguments of asyncCmd
+    uint8_t *asyncResp;              //!< Where the response is stored
+    uint8_t asyncRespSize;           //!< Response size in bytes
+    uint32_t asyncStart;             //!< clock.now() when the async operation started
+    uint32_t asyncTimeout;           //!< Maximum time (ms) of the async operation
+    const uint8_t *asyncPatch;       //!< Patch content (beginPatch)
+    uint16_t asyncPatchSize;         //!< Patch size in bytes
+    uint16_t asyncPatchOffset;       //!< Next patch line to send
+    bool asyncPatchPowerUp;          //!< Patch power up already sent
+    bool asyncCancel;                //!< cancelAsync was called; the seek stops at the next poll
+
+    bool beginAsync(uint8_t operation, uint8_t cmd, uint8_t argc, uint8_t *resp, uint8_t respSize, uint32_t timeout);
+    void writeCommand(uint8_t cmd, uint8_t argc, const uint8_t *args);
+    void getStatusBytes(uint8_t *resp, uint8_t size);
+    uint8_t prepareTune(uint16_t freq);
+    bool measureChannel(uint16_t freq, uint32_t *settle, uint16_t dwell, uint8_t averaging, si47x_scan_record *record);
+    void setAntennaCapacitorArgs(uint16_t capacitor);
+    uint16_t getAntennaCapacitorArgs();
+    uint16_t sweepAntennaCapacitor(uint16_t freq, uint16_t from, uint16_t to, uint16_t step, uint16_t best, uint32_t *settle,
+                                   si47x_scan_record *peak);
+
+    /**
+     * @brief Antenna capacitor table of the current mode: 0 = FM, 1 = AM and SSB, 2 = none (NBFM).
+     */
+    inline uint8_t antCapSlot() { return (currentTune == FM_TUNE_FREQ) ? 0 : (currentTune == AM_TUNE_FREQ) ? 1 : 2; }
+
+    /**
+     * @brief Sets the capacitor of the calibration table (if one is attached to the current mode) for a tune to freq.
+     */
+    inline void applyAntennaCapacitor(uint16_t freq)
+    {
+        uint8_t slot = antCapSlot();
+
+        if (slot < 2 && antCapTable[slot] != NULL)
+            setAntennaCapacitorArgs(lookupAntennaCapacitor(freq));
+    }
+    uint8_t prepareSeek(uint8_t SEEKUP, uint8_t WRAP, uint8_t *arg);
+    void startSeek(uint8_t SEEKUP, uint8_t WRAP);
+    bool waitSeekComplete(void (*showFunc)(uint16_t f), bool (*stopSeeking)());
+    uint8_t lastError = SI4735_OK;                //!< Result of the last command (SI4735_OK, SI4735_ERR_DEVICE or SI4735_ERR_TIMEOUT).
+    uint8_t maxRetries = MAX_COMMAND_RETRIES;     //!< Times a command is sent again after an ERR response.
+    uint16_t ctsTimeout = MAX_DELAY_CTS_TIMEOUT;  //!< Maximum time (ms) waiting for CTS.
+    uint16_t commandErrors[LATENCY_SLOTS];        //!< Errors (ERR or CTS timeout) per command. See getCommandSlot.
+    uint16_t commandRetries[LATENCY_SLOTS];       //!< Retries per command. See getCommandSlot.
+#ifdef SI4735_INSTRUMENTATION
+    si4735_bus_stats busStats; //!< Bus counters. See getBusStats.
+    si4735_tune_stats tuneStats[4]; //!< Tune-to-ready latency per band (FM_CURRENT_MODE...). See getTuneStats.
+    SI4735Tracer *tracer = NULL; //!< Timeline of the operations. See setTracer.
+    void addLatencySample(uint8_t cmd, uint32_t us);
+#endif
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Fixed delay attributed to a command.
+     * @details Same as clock.wait(ms); with SI4735_INSTRUMENTATION the time is added to the sleepTime of cmd.
+     * @param cmd command opcode the delay belongs to (0 if none).
+     * @param ms delay in ms.
+     */
+    inline void fixedWait(uint8_t cmd, uint32_t ms)
+    {
+        (void)cmd; // Only used by the statistics and the trace
+        SI4735_STATS_ADD(cmd, sleepTime, ms * 1000);
+        SI4735_TRACE_BEGIN("sleep", TRACE_SLEEP, cmd);
+        clock.wait(ms);
+        SI4735_TRACE_END();
+    }
+
+    void setCommandError(uint8_t cmd, uint8_t error);
 
-    uint8_t volume = 32; //!< Stores the current vlume setup (0-63).
+    bool applyBusSpeed(uint32_t hz);
 
-    uint8_t currentAudioMode = SI473X_ANALOG_AUDIO; //!< Current audio mode used (ANALOG or DIGITAL or both)
-    uint8_t currentSsbStatus;
-    int8_t audioMuteMcuPin = -1;
+    /**
+     * @ingroup group05
+     *
+     * @brief Runs the scope at the bulk I2C speed and goes back to the previous speed when the scope ends.
+     * @see setBusSpeedControl
+     */
+    struct BulkBusPhase
+    {
+        SI4735Base &rx;
+        uint32_t previous;
+
+        BulkBusPhase(SI4735Base &rx) : rx(rx), previous(rx.busSpeed) { rx.applyBusSpeed(rx.busSpeedBulk); }
+        ~BulkBusPhase() { rx.applyBusSpeed(previous ? previous : rx.busSpeedNormal); }
+    };
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the slot of a command in the per-command tables (latency, errors and retries).
+     *
+     * @details The slot is the index of the command in SI4735_COMMANDS. Unknown opcodes share the last slot.
+     * @details Resolved at compile time when cmd is a constant.
+     *
+     * @param cmd command opcode.
+     * @return uint8_t slot index (0 to LATENCY_SLOTS - 1).
+     */
+    static constexpr uint8_t getCommandSlot(uint8_t cmd) { return si4735CommandIndex(cmd); }
+    bool waitStc(uint32_t predicted, uint32_t limit, uint32_t *waited, bool *polled);
+    void waitTuneComplete(void);
 
     void waitInterrupr(void);
     si47x_status getInterruptStatus();
@@ -1183,7 +2096,167 @@ protected:
 public:
     SI4735Base(I2C& i2c, Clock& clock);
     void reset(void);
-    void waitToSend(void);
+    bool waitToSend(void);
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Sets the GPO2/INT line used to wait for CTS.
+     *
+     * @details With a line set, waitToSend blocks on the line and confirms the CTS bit with a single status read,
+     * @details instead of repeatedly polling the I2C bus. If the line does not signal within timeout_us,
+     * @details waitToSend falls back to the adaptive CTS polling.
+     * @details The CTS interrupt must be enabled (CTSIEN = 1 and GPO2OEN = 1 in setup or setPowerUp).
+     * @details The STC waits of setFrequency (TUNE_WAIT_STC and TUNE_WAIT_PREDICTED, see setTuneWait) and of the seeks
+     * @details (waitSeekComplete) block on the same line: enable STCIEN in setGpioIen so they end as soon as the tune
+     * @details completes. Every wait confirms the interrupt with a status read, and the STC waits end with INTACK, so an
+     * @details STC interrupt seen by waitToSend only costs one read.
+     * @details Enable RSQIEN only if the application acknowledges RSQINT (getCurrentReceivedSignalQuality with INTACK).
+     *
+     * @see SI4735InterruptLine, setCtsPolling, waitToSend
+     *
+     * @param line the interrupt line; NULL disables it (polling only).
+     * @param timeout_us maximum time in uS waitToSend blocks on the line. Default is MAX_DELAY_WAIT_INTERRUPT.
+     */
+    inline void setInterruptLine(SI4735InterruptLine *line, uint16_t timeout_us = MAX_DELAY_WAIT_INTERRUPT)
+    {
+        this->interruptLine = line;
+        this->ctsInterruptTimeout = timeout_us;
+    }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Sets the adaptive backoff used by waitToSend to poll the CTS bit.
+     *
+     * @details The first status read is done immediately. If the device is busy, waitToSend waits minDelay uS,
+     * @details then doubles the delay on each retry until it reaches maxDelay.
+     *
+     * @see MIN_DELAY_CTS_POLL, MIN_DELAY_WAIT_SEND_LOOP
+     *
+     * @param minDelay first backoff step in uS. Default is MIN_DELAY_CTS_POLL.
+     * @param maxDelay backoff ceiling in uS. Default is MIN_DELAY_WAIT_SEND_LOOP.
+     */
+    inline void setCtsPolling(uint16_t minDelay, uint16_t maxDelay = MIN_DELAY_WAIT_SEND_LOOP)
+    {
+        this->ctsPollMinDelay = (minDelay > 0) ? minDelay : 1;
+        this->ctsPollMaxDelay = (maxDelay > this->ctsPollMinDelay) ? maxDelay : this->ctsPollMinDelay;
+    }
+
+    void resetCommandLatency(void);
+    void resetCommandErrors(void);
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Sets the retry budget and the CTS deadline of the commands.
+     *
+     * @details Commands that read a response (getStatus, getRdsStatus, queryLibraryId, getFirmware, AGC status) are sent again
+     * @details up to retries times when the device answers with the ERR bit set. Any wait for CTS gives up after timeout_ms.
+     * @details On failure the functions return without looping; check getLastError.
+     *
+     * @see getLastError, getCommandErrors, getCommandRetries
+     *
+     * @param retries number of retries after an ERR response. Default is MAX_COMMAND_RETRIES.
+     * @param timeout_ms maximum time waiting for CTS in ms. Default is MAX_DELAY_CTS_TIMEOUT.
+     */
+    inline void setRetryPolicy(uint8_t retries, uint16_t timeout_ms = MAX_DELAY_CTS_TIMEOUT)
+    {
+        this->maxRetries = retries;
+        this->ctsTimeout = timeout_ms;
+    }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the result of the last command.
+     * @details An error stays until the next command succeeds: a response without ERR, the device clear to send (CTS)
+     * @details after a blocking command, or an async command that ends with ASYNC_DONE or ASYNC_CANCELLED.
+     * @return uint8_t SI4735_OK, SI4735_ERR_DEVICE or SI4735_ERR_TIMEOUT
+     */
+    inline uint8_t getLastError() { return this->lastError; }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the number of errors (ERR response or CTS timeout) of a command.
+     * @param cmd command opcode (for example, FM_TUNE_STATUS).
+     */
+    inline uint16_t getCommandErrors(uint8_t cmd) { return this->commandErrors[getCommandSlot(cmd)]; }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the number of times a command was sent again after an ERR response.
+     * @param cmd command opcode (for example, FM_RDS_STATUS).
+     */
+    inline uint16_t getCommandRetries(uint8_t cmd) { return this->commandRetries[getCommandSlot(cmd)]; }
+
+#ifdef SI4735_INSTRUMENTATION
+    void getBusStats(si4735_bus_stats *stats);
+    void resetBusStats(void);
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the bus counters of a command (available with SI4735_INSTRUMENTATION).
+     * @param cmd command opcode (for example, FM_TUNE_FREQ). Unknown opcodes share one entry.
+     */
+    inline const si4735_command_stats &getCommandStats(uint8_t cmd) { return this->busStats.command[getCommandSlot(cmd)]; }
+
+    /**
+     * @ingroup group08 Tune Frequency
+     *
+     * @brief Returns the tune-to-ready latency of a band (available with SI4735_INSTRUMENTATION).
+     * @details Cleared by resetBusStats.
+     * @param band FM_CURRENT_MODE, AM_CURRENT_MODE, SSB_CURRENT_MODE or NBFM_CURRENT_MODE.
+     */
+    inline const si4735_tune_stats &getTuneStats(uint8_t band) { return this->tuneStats[band & 3]; }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Sets the tracer that records the timeline of the driver operations (available with SI4735_INSTRUMENTATION).
+     *
+     * @code
+     * SI4735ChromeTrace trace(bus, out);   // host library: I2C decorator and tracer
+     * SI4735 rx(trace, clock);
+     * rx.setTracer(&trace);
+     * @endcode
+     *
+     * @see SI4735Tracer
+     * @param tracer the tracer; NULL stops tracing.
+     */
+    inline void setTracer(SI4735Tracer *tracer) { this->tracer = tracer; }
+#endif
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Sets the predicted completion time of a command.
+     *
+     * @details waitToSend sleeps this time after the command is sent and only then polls the CTS bit.
+     * @details The prediction is calibrated at runtime from the observed CTS times; use this function to seed it
+     * @details with a value measured on your board. Use 0 to poll right away.
+     *
+     * @see getCommandLatency, resetCommandLatency, waitToSend
+     *
+     * @param cmd command opcode (for example, SET_PROPERTY or FM_RDS_STATUS).
+     * @param us predicted time in uS.
+     */
+    inline void setCommandLatency(uint8_t cmd, uint16_t us) { this->commandLatency[getCommandSlot(cmd)] = us; }
+
+    /**
+     * @ingroup group06 Wait to send command
+     *
+     * @brief Returns the current (calibrated) predicted completion time of a command.
+     *
+     * @see setCommandLatency
+     *
+     * @param cmd command opcode.
+     * @return uint16_t predicted time in uS.
+     */
+    inline uint16_t getCommandLatency(uint8_t cmd) { return this->commandLatency[getCommandSlot(cmd)]; }
 
     void setGpioCtl(uint8_t GPO1OEN, uint8_t GPO2OEN, uint8_t GPO3OEN);
     void setGpio(uint8_t GPO1LEVEL, uint8_t GPO2LEVEL, uint8_t GPO3LEVEL);
@@ -1196,6 +2269,27 @@ public:
     void setRefClockPrescaler(uint16_t prescale, uint8_t rclk_sel = 0);
 
     int32_t getProperty(uint16_t propertyValue);
+    void applyProperties(const PropertyValue *begin, const PropertyValue *end);
+
+    /**
+     * @ingroup group10 Generic set and get property
+     *
+     * @brief Applies a whole property list (array).
+     *
+     * @code
+     * static const PropertyValue myFm[] = {{FM_DEEMPHASIS, 1}, {FM_SEEK_FREQ_SPACING, 10}};
+     * si4735.applyProperties(myFm);
+     * @endcode
+     *
+     * @see applyProperties(const PropertyValue *begin, const PropertyValue *end)
+     *
+     * @param list array of PropertyValue
+     */
+    template <size_t N>
+    inline void applyProperties(const PropertyValue (&list)[N])
+    {
+        applyProperties(list, list + N);
+    }
 
     /**
      * @ingroup group10 Generic set and get property
@@ -1219,6 +2313,184 @@ public:
     void sendCommand(uint8_t cmd, int parameter_size, const uint8_t *parameter);
     void getCommandResponse(int num_of_bytes, uint8_t *response);
     si47x_status getStatusResponse();
+    bool transact(uint8_t cmd, const uint8_t *args, uint8_t argc, uint8_t *resp, uint8_t respc);
+    bool transactRetry(uint8_t cmd, const uint8_t *args, uint8_t argc, uint8_t *resp, uint8_t respc);
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief Sends a command whose opcode and arguments are checked at compile time against SI4735_COMMANDS.
+     *
+     * @details Same as sendCommand(cmd, argc, args). An unknown opcode or a wrong number of arguments does not compile.
+     * @details Prefer setProperty to set a property: a SET_PROPERTY sent here drops the cached value of the property, so
+     * @details the next setProperty of it is written to the device.
+     * @code
+     * uint8_t arg[1] = {1}, status[8];
+     * rx.sendCommand<FM_TUNE_STATUS>(arg); // INTACK: clears STCINT
+     * rx.getCommandResponse(8, status);
+     * @endcode
+     */
+    template <uint8_t cmd, size_t argc>
+    inline void sendCommand(const uint8_t (&args)[argc])
+    {
+        static_assert(si4735CommandIndex(cmd) < LATENCY_SLOTS - 1, "Unknown Si47XX command");
+        static_assert(si4735CommandAccepts(cmd, argc), "Wrong number of arguments for this Si47XX command");
+        sendCommand(cmd, (int)argc, args);
+    }
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief Sends a command without arguments, checked at compile time against SI4735_COMMANDS.
+     */
+    template <uint8_t cmd>
+    inline void sendCommand()
+    {
+        static_assert(si4735CommandIndex(cmd) < LATENCY_SLOTS - 1, "Unknown Si47XX command");
+        static_assert(si4735CommandAccepts(cmd, 0), "This Si47XX command needs arguments");
+        sendCommand(cmd, 0, NULL);
+    }
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief transact with the opcode, the arguments and the response size checked at compile time against SI4735_COMMANDS.
+     *
+     * @details The response buffer may be shorter than the full response of the command (the device sends the first bytes).
+     */
+    template <uint8_t cmd, size_t argc, size_t respc>
+    inline bool transact(const uint8_t (&args)[argc], uint8_t (&resp)[respc])
+    {
+        static_assert(si4735CommandAccepts(cmd, argc), "Unknown Si47XX command or wrong number of arguments");
+        static_assert(respc >= 1 && respc <= SI4735_COMMANDS[si4735CommandIndex(cmd)].response, "Response size does not match the command");
+        return transact(cmd, args, argc, resp, respc);
+    }
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief transactRetry for commands without arguments, checked at compile time against SI4735_COMMANDS.
+     */
+    template <uint8_t cmd, size_t respc>
+    inline bool transactRetry(uint8_t (&resp)[respc])
+    {
+        static_assert(si4735CommandAccepts(cmd, 0), "Unknown Si47XX command or it needs arguments");
+        static_assert(respc >= 1 && respc <= SI4735_COMMANDS[si4735CommandIndex(cmd)].response, "Response size does not match the command");
+        return transactRetry(cmd, NULL, 0, resp, respc);
+    }
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief Returns the descriptor of a command (argument and response sizes, modes).
+     *
+     * @return NULL if the opcode is not in SI4735_COMMANDS.
+     */
+    static inline const si4735_command_info *getCommandInfo(uint8_t cmd)
+    {
+        return (si4735CommandIndex(cmd) < LATENCY_SLOTS - 1) ? &SI4735_COMMANDS[si4735CommandIndex(cmd)] : NULL;
+    }
+
+    /**
+     * @ingroup group10 Generic Command and Response
+     *
+     * @brief Sets the combined write-then-read transport used by transact.
+     *
+     * @details Pass your I2C object here if it also implements SI4735Transaction.
+     *
+     * @see SI4735Transaction, transact
+     *
+     * @param transaction the transport; NULL disables the combined path.
+     */
+    inline void setTransaction(SI4735Transaction *transaction) { this->transaction = transaction; }
+
+    void setBusSpeedControl(SI4735BusSpeed *control, uint32_t normal = I2C_SPEED_STANDARD, uint32_t bulk = I2C_SPEED_FAST);
+    void setBusSpeeds(uint32_t normal, uint32_t bulk);
+    uint32_t probeBusSpeed(const uint32_t *speeds, uint8_t count, uint8_t reads = BUS_PROBE_READS);
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Returns the I2C clock in use (Hz; 0 if no speed control was set).
+     * @see setBusSpeedControl
+     */
+    inline uint32_t getBusSpeed() { return this->busSpeed; }
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Returns the I2C clock of the bulk transfers (patch download and RDS FIFO drain).
+     * @see setBusSpeedControl, probeBusSpeed
+     */
+    inline uint32_t getBulkBusSpeed() { return this->busSpeedBulk; }
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Sets the I2C bus to 10 kHz (needs setBusSpeedControl).
+     * @details The speed becomes the normal speed: the bulk transfers still run at the bulk speed.
+     */
+    inline void setI2CLowSpeedMode(void) { setBusSpeeds(I2C_SPEED_LOW, this->busSpeedBulk); }
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Sets the I2C bus to 100 kHz (needs setBusSpeedControl).
+     */
+    inline void setI2CStandardMode(void) { setBusSpeeds(I2C_SPEED_STANDARD, this->busSpeedBulk); }
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Sets the I2C bus to 400 kHz (needs setBusSpeedControl).
+     */
+    inline void setI2CFastMode(void) { setBusSpeeds(I2C_SPEED_FAST, this->busSpeedBulk); }
+
+    /**
+     * @ingroup group05
+     *
+     * @brief Sets the I2C bus to a custom speed (needs setBusSpeedControl).
+     * @details The Si47XX data sheet only specifies up to 400 kHz; see probeBusSpeed before going faster.
+     * @param value speed in Hz.
+     */
+    inline void setI2CFastModeCustom(long value = I2C_SPEED_FAST_CUSTOM) { setBusSpeeds((uint32_t)value, this->busSpeedBulk); }
+
+    /**
+     * @ingroup group10 Generic set and get property
+     *
+     * @brief Invalidates the property shadow cache.
+     *
+     * @details sendProperty skips writes of unchanged values and getProperty is served from the shadow cache.
+     * @details The cache is invalidated automatically on POWER_UP, POWER_DOWN and patch download.
+     * @details Call this function if the device was reset or reconfigured outside this library.
+     *
+     * @see sendProperty, getProperty, getPropertyCacheHits, getPropertyCacheMisses
+     */
+    inline void invalidatePropertyCache() { this->shadowCount = this->shadowNext = 0; }
+
+    /**
+     * @ingroup group10 Generic set and get property
+     *
+     * @brief Returns the number of property writes skipped and property reads served by the shadow cache.
+     * @see getPropertyCacheMisses, resetPropertyCacheCounters
+     */
+    inline uint32_t getPropertyCacheHits() { return this->propertyCacheHits; }
+
+    /**
+     * @ingroup group10 Generic set and get property
+     *
+     * @brief Returns the number of property writes and reads that went to the device.
+     * @see getPropertyCacheHits, resetPropertyCacheCounters
+     */
+    inline uint32_t getPropertyCacheMisses() { return this->propertyCacheMisses; }
+
+    /**
+     * @ingroup group10 Generic set and get property
+     *
+     * @brief Resets the property shadow cache hit and miss counters.
+     * @see getPropertyCacheHits, getPropertyCacheMisses
+     */
+    inline void resetPropertyCacheCounters() { this->propertyCacheHits = this->propertyCacheMisses = 0; }
 
     void setPowerUp(uint8_t CTSIEN, uint8_t GPO2OEN, uint8_t PATCH, uint8_t XOSCEN, uint8_t FUNC, uint8_t OPMODE);
     void radioPowerUp(void);
@@ -1237,6 +2509,27 @@ public:
      * @see Si47XX PROGRAMMING GUIDE; AN332 (REV 1.0); pages 63
      */
 
+    /**
+     * @ingroup group08
+     * @brief Decodes the last tune status response (getStatus) in place.
+     * @see si47x_tune_status_view
+     */
+    inline si47x_tune_status_view getStatusView() const { return si47x_tune_status_view(currentStatus.raw); }
+
+    /**
+     * @ingroup group08
+     * @brief Decodes the last Received Signal Quality response (getCurrentReceivedSignalQuality) in place.
+     * @see si47x_rsq_view
+     */
+    inline si47x_rsq_view getRsqView() const { return si47x_rsq_view(currentRqsStatus.raw); }
+
+    /**
+     * @ingroup group16
+     * @brief Decodes the last RDS status response (getRdsStatus) in place.
+     * @see si47x_rds_view
+     */
+    inline si47x_rds_view getRdsView() const { return si47x_rds_view(currentRdsStatus.raw); }
+
     /**
      * @ingroup group08
      * @brief Get the Signal Quality Interrupt status
@@ -1245,7 +2538,7 @@ public:
      */
     inline bool getSignalQualityInterrupt()
     {
-        return currentStatus.resp.RSQINT;
+        return getStatusView().rsqint();
     };
 
     /**
@@ -1256,7 +2549,7 @@ public:
      */
     inline bool getRadioDataSystemInterrupt()
     {
-        return currentStatus.resp.RDSINT;
+        return getStatusView().rdsint();
     };
 
     /**
@@ -1267,7 +2560,7 @@ public:
      */
     inline bool getTuneCompleteTriggered()
     {
-        return currentStatus.resp.STCINT;
+        return getStatusView().stcint();
     };
 
     /**
@@ -1278,7 +2571,7 @@ public:
      */
     inline bool getStatusError()
     {
-        return currentStatus.resp.ERR;
+        return getStatusView().err();
     };
 
     /**
@@ -1287,7 +2580,7 @@ public:
      *
      * @return CTS
      */
-    inline bool getStatusCTS() { return currentStatus.resp.CTS; };
+    inline bool getStatusCTS() { return getStatusView().cts(); };
 
     /**
      * @ingroup group08
@@ -1297,7 +2590,7 @@ public:
      */
     inline bool getACFIndicator()
     {
-        return currentStatus.resp.AFCRL;
+        return getStatusView().afcrl();
     };
 
     /**
@@ -1310,7 +2603,7 @@ public:
      */
     inline bool getBandLimit()
     {
-        return currentStatus.resp.BLTF;
+        return getStatusView().bltf();
     };
 
     /**
@@ -1324,7 +2617,7 @@ public:
      */
     inline bool getStatusValid()
     {
-        return currentStatus.resp.VALID;
+        return getStatusView().valid();
     };
 
     /**
@@ -1335,7 +2628,7 @@ public:
      */
     inline uint8_t getReceivedSignalStrengthIndicator()
     {
-        return currentStatus.resp.RSSI;
+        return getStatusView().rssi();
     };
 
     /**
@@ -1348,7 +2641,7 @@ public:
      */
     inline uint8_t getStatusSNR()
     {
-        return currentStatus.resp.SNR;
+        return getStatusView().snr();
     };
 
     /**
@@ -1361,7 +2654,7 @@ public:
      */
     inline uint8_t getStatusMULT()
     {
-        return currentStatus.resp.MULT;
+        return getStatusView().mult();
     };
 
     /**
@@ -1378,11 +2671,11 @@ public:
         si47x_antenna_capacitor cap;
 
         if (currentTune == FM_TUNE_FREQ)
-            return currentStatus.resp.READANTCAP;
+            return getStatusView().readAntCap();
         else
         {
-            cap.raw.ANTCAPL = currentStatus.resp.READANTCAP; // On AM it is the low byte the READANTCAP value
-            cap.raw.ANTCAPH = currentStatus.resp.MULT;       // On AM it is the high byte the READANTCAP value
+            cap.raw.ANTCAPL = getStatusView().readAntCap(); // On AM it is the low byte the READANTCAP value
+            cap.raw.ANTCAPH = getStatusView().mult();       // On AM it is the high byte the READANTCAP value
             return cap.value;
         }
     };
@@ -1533,6 +2826,8 @@ public:
 
     void getCurrentReceivedSignalQuality(uint8_t INTACK);
     void getCurrentReceivedSignalQuality(void);
+    uint16_t scanBand(uint16_t from, uint16_t to, uint16_t step, si47x_scan_record *out, uint16_t size, uint16_t dwell = 0,
+                      uint8_t averaging = 1);
 
     // AM and FM
 
@@ -1544,7 +2839,7 @@ public:
      */
     inline uint8_t getCurrentRSSI()
     {
-        return currentRqsStatus.resp.RSSI;
+        return getRsqView().rssi();
     };
 
     /**
@@ -1555,7 +2850,7 @@ public:
      */
     inline uint8_t getCurrentSNR()
     {
-        return currentRqsStatus.resp.SNR;
+        return getRsqView().snr();
     };
 
     /**
@@ -1566,7 +2861,7 @@ public:
      */
     inline bool getCurrentRssiDetectLow()
     {
-        return currentRqsStatus.resp.RSSIILINT;
+        return getRsqView().rssilint();
     };
 
     /**
@@ -1577,7 +2872,7 @@ public:
      */
     inline bool getCurrentRssiDetectHigh()
     {
-        return currentRqsStatus.resp.RSSIHINT;
+        return getRsqView().rssihint();
     };
 
     /**
@@ -1588,7 +2883,7 @@ public:
      */
     inline bool getCurrentSnrDetectLow()
     {
-        return currentRqsStatus.resp.SNRLINT;
+        return getRsqView().snrlint();
     };
 
     /**
@@ -1599,7 +2894,7 @@ public:
      */
     inline bool getCurrentSnrDetectHigh()
     {
-        return currentRqsStatus.resp.SNRHINT;
+        return getRsqView().snrhint();
     };
 
     /**
@@ -1610,7 +2905,7 @@ public:
      */
     inline bool getCurrentValidChannel()
     {
-        return currentRqsStatus.resp.VALID;
+        return getRsqView().valid();
     };
 
     /**
@@ -1621,7 +2916,7 @@ public:
      */
     inline bool getCurrentAfcRailIndicator()
     {
-        return currentRqsStatus.resp.AFCRL;
+        return getRsqView().afcrl();
     };
 
     /**
@@ -1634,7 +2929,7 @@ public:
      */
     inline bool getCurrentSoftMuteIndicator()
     {
-        return currentRqsStatus.resp.SMUTE;
+        return getRsqView().smute();
     };
 
     // Just FM
@@ -1647,7 +2942,7 @@ public:
      */
     inline uint8_t getCurrentStereoBlend()
     {
-        return currentRqsStatus.resp.STBLEND;
+        return getRsqView().stblend();
     };
 
     /**
@@ -1660,7 +2955,7 @@ public:
      */
     inline bool getCurrentPilot()
     {
-        return currentRqsStatus.resp.PILOT;
+        return getRsqView().pilot();
     };
 
     /**
@@ -1673,7 +2968,7 @@ public:
      */
     inline uint8_t getCurrentMultipath()
     {
-        return currentRqsStatus.resp.MULT;
+        return getRsqView().mult();
     };
 
     /**
@@ -1684,7 +2979,7 @@ public:
      */
     inline uint8_t getCurrentSignedFrequencyOffset()
     {
-        return currentRqsStatus.resp.FREQOFF;
+        return getRsqView().freqoff();
     };
 
     /**
@@ -1696,7 +2991,7 @@ public:
      */
     inline bool getCurrentMultipathDetectLow()
     {
-        return currentRqsStatus.resp.MULTLINT;
+        return getRsqView().multlint();
     };
 
     /**
@@ -1708,7 +3003,7 @@ public:
      */
     inline bool getCurrentMultipathDetectHigh()
     {
-        return currentRqsStatus.resp.MULTHINT;
+        return getRsqView().multhint();
     };
 
     /**
@@ -1720,7 +3015,7 @@ public:
      */
     inline bool getCurrentBlendDetectInterrupt()
     {
-        return currentRqsStatus.resp.BLENDINT;
+        return getRsqView().blendint();
     };
 
     /*
@@ -2269,6 +3564,33 @@ public:
 
     void setTuneFrequencyAntennaCapacitor(uint16_t capacitor);
 
+    uint16_t calibrateAntennaCapacitor(uint16_t from, uint16_t to, uint16_t segment, si4735_antcap_entry *table, uint16_t size,
+                                       uint16_t capStep = 1, uint16_t capFrom = 1, uint16_t capTo = 0);
+    void setAntennaCapacitorTable(const si4735_antcap_entry *table, uint16_t count);
+    uint16_t lookupAntennaCapacitor(uint16_t freq);
+
+    /**
+     * @ingroup group08 Tune Frequency
+     * @brief Sets the function that saves the tables made by calibrateAntennaCapacitor (EEPROM, flash, file...).
+     * @details tune is FM_TUNE_FREQ or AM_TUNE_FREQ (AM and SSB). To use a saved table, load it into an array that outlives
+     * @details the receiver and pass it to setAntennaCapacitorTable after setFM or setAM.
+     * @code
+     * void saveTable(uint8_t tune, const si4735_antcap_entry *table, uint16_t count)
+     * {
+     *     EEPROM.put((tune == FM_TUNE_FREQ) ? FM_TABLE_ADDRESS : AM_TABLE_ADDRESS, count);
+     *     for (uint16_t i = 0; i < count; i++)
+     *         EEPROM.put(... + 2 + i * sizeof(si4735_antcap_entry), table[i]);
+     * }
+     *
+     * rx.setAntennaCapacitorStore(saveTable);
+     * @endcode
+     * @param store function called with the table; NULL for none.
+     */
+    inline void setAntennaCapacitorStore(void (*store)(uint8_t tune, const si4735_antcap_entry *table, uint16_t count))
+    {
+        this->antCapStore = store;
+    }
+
     void frequencyUp();
     void frequencyDown();
 
@@ -2307,6 +3629,17 @@ public:
         this->maxSeekTime = time_in_ms;
     };
 
+    /**
+     * @ingroup group08 Seek
+     * @brief Sets how often seekStationProgress reports the frequency being checked. The default value is 50 ms.
+     * @details Each report reads the tune status (one command and an 8 bytes response). Use 0 to report only the station found.
+     * @param interval_ms time in milliseconds between two reports.
+     */
+    inline void setSeekProgressInterval(uint16_t interval_ms)
+    {
+        this->seekProgressInterval = interval_ms;
+    };
+
     /**
      * @ingroup group08 Seek
      *
@@ -2431,7 +3764,7 @@ public:
      */
     inline bool getRdsReceived()
     {
-        return currentRdsStatus.resp.RDSRECV;
+        return getRdsView().received();
     };
 
     /**
@@ -2442,7 +3775,7 @@ public:
      */
     inline bool getRdsSyncLost()
     {
-        return currentRdsStatus.resp.RDSSYNCLOST;
+        return getRdsView().syncLost();
     };
 
     /**
@@ -2453,7 +3786,7 @@ public:
      */
     inline bool getRdsSyncFound()
     {
-        return currentRdsStatus.resp.RDSSYNCFOUND;
+        return getRdsView().syncFound();
     };
 
     /**
@@ -2465,7 +3798,7 @@ public:
      */
     inline bool getRdsNewBlockA()
     {
-        return currentRdsStatus.resp.RDSNEWBLOCKA;
+        return getRdsView().newBlockA();
     };
 
     /**
@@ -2476,7 +3809,7 @@ public:
      */
     inline bool getRdsNewBlockB()
     {
-        return currentRdsStatus.resp.RDSNEWBLOCKB;
+        return getRdsView().newBlockB();
     };
 
     /**
@@ -2487,7 +3820,7 @@ public:
      */
     inline bool getRdsSync()
     {
-        return currentRdsStatus.resp.RDSSYNC;
+        return getRdsView().sync();
     };
 
     /**
@@ -2498,7 +3831,7 @@ public:
      */
     inline bool getGroupLost()
     {
-        return currentRdsStatus.resp.GRPLOST;
+        return getRdsView().groupLost();
     };
 
     /**
@@ -2509,7 +3842,7 @@ public:
      */
     inline uint8_t getNumRdsFifoUsed()
     {
-        return currentRdsStatus.resp.RDSFIFOUSED;
+        return getRdsView().fifoUsed();
     };
 
     /**
@@ -2616,6 +3949,7 @@ public:
     char *getRdsText2A(void); // Gets the Radio Text
     char *getRdsText2B(void);
     bool getRdsAllData(char **stationName, char **stationInformation, char **programInformation, char **utcTime);
+    uint8_t drainRdsFifo(uint8_t maxGroups = MAX_RDS_FIFO_GROUPS);
 
     /**
      * @ingroup group16
@@ -2709,7 +4043,7 @@ public:
      * @brief Set the Max Delay after Set Frequency
      *
      * @details After the set frequency command, the system need a time to get ready to the next set frequency (default value 30ms).
-     * @details Why the waitToSend() does not work in this case? No idea for while!
+     * @details setFrequency sleeps the predicted tune time and then polls STCINT; this value is the upper bound of that wait.
      * @details A low value makes the getFrequency command inaccurate.
      *
      * @see  MAX_DELAY_AFTER_POWERUP
@@ -2720,6 +4054,39 @@ public:
         this->maxDelaySetFrequency = ms;
     }
 
+    /**
+     * @ingroup   group08 Tune Frequency
+     * @brief Selects how setFrequency waits for the end of the tune.
+     *
+     * @details TUNE_WAIT_PREDICTED (default) sleeps the calibrated tune time of the band and then polls STCINT.
+     * @details TUNE_WAIT_STC polls STCINT right away with a short backoff (or blocks on the interrupt line, see
+     * @details setInterruptLine, with STCIEN enabled in setGpioIen): setFrequency returns as soon as the device
+     * @details completes the tune, and getTuneSettleTime is the measured settle time. Use it for channel hopping and to
+     * @details calibrate a board.
+     * @details TUNE_WAIT_FIXED sleeps maxDelaySetFrequency and does not poll.
+     * @details In every mode the wait ends after maxDelaySetFrequency: the fixed delay is only the fallback. The tune
+     * @details status is then read with INTACK, which clears STCINT.
+     *
+     * @see setMaxDelaySetFrequency, getTuneSettleTime, getTuneStats
+     * @param mode TUNE_WAIT_PREDICTED, TUNE_WAIT_STC or TUNE_WAIT_FIXED
+     */
+    inline void setTuneWait(uint8_t mode)
+    {
+        this->tuneWait = mode;
+    }
+
+    /**
+     * @ingroup   group08 Tune Frequency
+     * @brief Returns the time (uS) waited for STCINT after the last tune command.
+     * @details Sleeps and polling backoff, rounded up to the polling step; the bus time of the polls is not included.
+     * @details With TUNE_WAIT_FIXED it is the fixed delay. Set by setFrequency.
+     * @see setTuneWait
+     */
+    inline uint32_t getTuneSettleTime()
+    {
+        return this->tuneSettleTime;
+    }
+
     /**
      * @ingroup group08 Tune Frequency step
      *
@@ -2750,6 +4117,25 @@ public:
         this->currentStep = step;
     }
 
+    /**
+     * @ingroup group08 Frequency
+     * @brief Gets the step used by frequencyUp and frequencyDown.
+     * @see setFrequencyStep
+     */
+    inline uint16_t getFrequencyStep() { return this->currentStep; }
+
+    /**
+     * @ingroup group08 Frequency
+     * @brief Gets the minimum frequency of the current band (setFM, setAM, setSSB...).
+     */
+    inline uint16_t getMinimumFrequency() { return this->currentMinimumFrequency; }
+
+    /**
+     * @ingroup group08 Frequency
+     * @brief Gets the maximum frequency of the current band (setFM, setAM, setSSB...).
+     */
+    inline uint16_t getMaximumFrequency() { return this->currentMaximumFrequency; }
+
     /**
      * @ingroup group08 Frequency
      *
@@ -2783,5 +4169,31 @@ public:
 
     void convertToChar(uint16_t value, char *strValue, uint8_t len, uint8_t dot, uint8_t separator, bool remove_leading_zeros = true);
     void removeUnwantedChar(char *str, int size);
+
+    bool beginTune(uint16_t freq);
+    bool beginSeek(uint8_t up, uint8_t wrap = 1);
+    bool beginRdsRead(uint8_t INTACK = 0, uint8_t MTFIFO = 0, uint8_t STATUSONLY = 0);
+    bool beginRsqRead(uint8_t INTACK = 0);
+    bool beginPatch(const uint8_t *patch_content, const uint16_t patch_content_size);
+    bool beginSetProperty(uint16_t propertyNumber, uint16_t parameter);
+    bool beginSetVolume(uint8_t volume);
+    bool cancelAsync(void);
+    uint8_t poll(void);
+
+    /**
+     * @ingroup group21 Async commands
+     *
+     * @brief Returns the current (or last) async operation.
+     * @details Use it after poll() returns ASYNC_DONE to know which result (currentStatus, currentRdsStatus or currentRqsStatus) is ready.
+     * @return uint8_t ASYNC_OP_TUNE, ASYNC_OP_SEEK, ASYNC_OP_RDS, ASYNC_OP_RSQ, ASYNC_OP_PATCH or ASYNC_OP_PROPERTY
+     */
+    inline uint8_t getAsyncOperation() { return this->asyncOperation; }
+
+    /**
+     * @ingroup group21 Async commands
+     *
+     * @brief Returns true if an async command is in flight.
+     */
+    inline bool isAsyncBusy() { return this->asyncState == ASYNC_BUSY; }
 };
 #endif // _SI4735_H
@@ -0,0 +1,173 @@
+/**
+ * @file si4735-panadapter.h
+ *
+ * @brief Optional panadapter: sweeps the channels around the listening frequency and publishes spectrum frames.
+ *
+ * @details This header is not included by si4735.h. SI4735Panadapter::sweep() measures the RSSI of span channels on each
+ * @details side of the listening frequency (scanBand: FAST tune, STCINT, RSQ read, optional dwell and averaging), tunes back
+ * @details to the listening frequency and publishes the frame into a fixed ring of SI4735_PANADAPTER_FRAMES frames.
+ * @details The ring is single producer, single consumer and lock-free (__atomic acquire/release on the head and tail
+ * @details indexes): the radio loop calls sweep(), a display or network thread calls read(). When the consumer falls behind,
+ * @details new frames are dropped (getDropped) and the frames already published stay consistent.
+ * @details Audio is interrupted while a frame is swept: keep the span small, or sweep less often, while listening.
+ *
+ * @code
+ * SI4735Panadapter pan(rx, clock);
+ *
+ * pan.configure(20, 10);           // +/- 20 channels of 100 kHz around the listening frequency
+ *
+ * // radio loop                    // display thread
+ * pan.sweep();                     // si4735_spectrum_frame frame;
+ *                                  // if (pan.read(&frame))
+ *                                  //     drawSpectrum(frame.first, frame.step, frame.rssi, frame.bins);
+ * @endcode
+ *
+ * @see scanBand
+ */
+
+#ifndef _SI4735_PANADAPTER_H
+#define _SI4735_PANADAPTER_H
+
+#include "si4735-cpp.h"
+
+#define SI4735_PANADAPTER_MAX_SPAN 32                                   // Channels on each side of the listening frequency
+#define SI4735_PANADAPTER_MAX_BINS (2 * SI4735_PANADAPTER_MAX_SPAN + 1) // Bins of a frame
+#ifndef SI4735_PANADAPTER_FRAMES
+#define SI4735_PANADAPTER_FRAMES 4 // Frames of the ring (power of two, up to 128)
+#endif
+
+// head - tail is taken on uint8_t and the slot is index & (FRAMES - 1): both break with any other ring size
+static_assert(SI4735_PANADAPTER_FRAMES > 0 && (SI4735_PANADAPTER_FRAMES & (SI4735_PANADAPTER_FRAMES - 1)) == 0 &&
+                  SI4735_PANADAPTER_FRAMES <= 128,
+              "SI4735_PANADAPTER_FRAMES must be a power of two up to 128");
+
+/**
+ * @ingroup group08 Received Signal Quality
+ *
+ * @brief Spectrum frame published by SI4735Panadapter
+ */
+typedef struct
+{
+    uint32_t timestamp;                        //!< Clock::now() (ms) at the end of the sweep
+    uint32_t sequence;                         //!< Frame number (gaps show dropped frames)
+    uint16_t center;                           //!< Listening frequency
+    uint16_t first;                            //!< Frequency of bin 0
+    uint16_t step;                             //!< Frequency step between two bins
+    uint8_t bins;                              //!< Bins used (fewer near the band limits)
+    uint8_t rssi[SI4735_PANADAPTER_MAX_BINS];  //!< dBuV per bin (0 if the channel could not be read)
+} si4735_spectrum_frame;
+
+/**
+ * @ingroup group08 Received Signal Quality
+ *
+ * @brief Sweep mode that publishes spectrum frames around the listening frequency into a lock-free ring.
+ * @see si4735-panadapter.h
+ */
+class SI4735Panadapter
+{
+public:
+    SI4735Panadapter(SI4735Base &rx, Clock &clock) : rx(rx), clock(clock) {}
+
+    /**
+     * @brief Sets the shape of the frames.
+     * @param span channels on each side of the listening frequency (1 to SI4735_PANADAPTER_MAX_SPAN).
+     * @param step channel spacing; 0 uses the step of the receiver (setFrequencyStep).
+     * @param dwell time (uS) on each channel after the tune, before the RSSI is read.
+     * @param averaging RSSI reads averaged per channel.
+     */
+    void configure(uint8_t span, uint16_t step = 0, uint16_t dwell = 0, uint8_t averaging = 1)
+    {
+        this->span = (span == 0) ? 1 : (span > SI4735_PANADAPTER_MAX_SPAN) ? SI4735_PANADAPTER_MAX_SPAN : span;
+        this->step = step;
+        this->dwell = dwell;
+        this->averaging = (averaging == 0) ? 1 : averaging;
+    }
+
+    /**
+     * @brief Sweeps one frame around the listening frequency, tunes back to it and publishes the frame.
+     * @details Call it from the loop that owns the receiver, as often as the display needs frames.
+     * @return false if the ring is full (the frame is dropped) or the span is empty.
+     */
+    bool sweep()
+    {
+        uint16_t center = rx.getCurrentFrequency();
+        uint16_t delta = (step != 0) ? step : rx.getFrequencyStep();
+        uint32_t from, to;
+        uint8_t head = __atomic_load_n(&this->head, __ATOMIC_RELAXED);
+        uint8_t n;
+
+        if (delta == 0)
+            return false;
+        from = ((uint32_t)center > (uint32_t)span * delta) ? center - (uint32_t)span * delta : 0;
+        while (from < rx.getMinimumFrequency())
+            from += delta;
+        to = (uint32_t)center + (uint32_t)span * delta;
+        while (to > rx.getMaximumFrequency() && to >= from + delta)
+            to -= delta;
+
+        n = (uint8_t)rx.scanBand((uint16_t)from, (uint16_t)to, delta, records, SI4735_PANADAPTER_MAX_BINS, dwell, averaging);
+        rx.setFrequency(center);
+        sequence++;
+        if (n == 0)
+            return false;
+        if ((uint8_t)(head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) >= SI4735_PANADAPTER_FRAMES)
+        {
+            dropped++;
+            return false;
+        }
+
+        si4735_spectrum_frame &frame = frames[head & (SI4735_PANADAPTER_FRAMES - 1)];
+        frame.timestamp = (uint32_t)clock.now();
+        frame.sequence = sequence;
+        frame.center = center;
+        frame.first = (uint16_t)from;
+        frame.step = delta;
+        frame.bins = (uint8_t)((to - from) / delta + 1);
+        memset(frame.rssi, 0, frame.bins);
+        for (uint8_t i = 0; i < n; i++) // scanBand leaves out the channels it could not read
+            frame.rssi[(records[i].frequency - from) / delta] = records[i].rssi;
+        __atomic_store_n(&this->head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest frame of the ring. Lock-free; call it from one consumer thread.
+     * @return false if no frame is waiting.
+     */
+    bool read(si4735_spectrum_frame *frame)
+    {
+        uint8_t tail = __atomic_load_n(&this->tail, __ATOMIC_RELAXED);
+
+        if (tail == __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+            return false;
+        *frame = frames[tail & (SI4735_PANADAPTER_FRAMES - 1)];
+        __atomic_store_n(&this->tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Frames waiting in the ring.
+     */
+    inline uint8_t getPending() { return (uint8_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)); }
+
+    /**
+     * @brief Frames dropped because the ring was full.
+     */
+    inline uint32_t getDropped() { return dropped; }
+
+protected:
+    SI4735Base &rx;
+    Clock &clock;
+    uint8_t span = 16;
+    uint16_t step = 0;
+    uint16_t dwell = 0;
+    uint8_t averaging = 1;
+    uint32_t sequence = 0;
+    uint32_t dropped = 0;
+    uint8_t head = 0; //!< Next frame to write (producer)
+    uint8_t tail = 0; //!< Next frame to read (consumer)
+    si4735_spectrum_frame frames[SI4735_PANADAPTER_FRAMES] = {};
+    si47x_scan_record records[SI4735_PANADAPTER_MAX_BINS];
+};
+
+#endif // _SI4735_PANADAPTER_H
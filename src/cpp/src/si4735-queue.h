@@ -0,0 +1,323 @@
+/**
+ * @file si4735-queue.h
+ *
+ * @brief Optional per-receiver command queue with priority classes, over the non-blocking (async) commands of SI4735Base.
+ *
+ * @details This header is not included by si4735.h. Use it when more than one part of the application talks to the same
+ * @details receiver, for example a UI thread (tune, volume), a seek/scan task and a telemetry poller (RSQ, RDS).
+ * @details Each part submits requests; one loop calls service(), the only place that touches the bus.
+ * @details Requests run one at a time, highest class first:
+ * @details - QUEUE_PRIORITY_USER: tune, volume and other properties set by the user;
+ * @details - QUEUE_PRIORITY_SEEK: seek and scan steps;
+ * @details - QUEUE_PRIORITY_BACKGROUND: RSQ and RDS polling.
+ * @details The choice is made between two chip commands, so a user request waits for at most the command already on the
+ * @details bus (an RSQ or RDS read is one write and one response read). A seek in progress is preempted: it is cancelled
+ * @details (the device stays on the channel it was checking) and completes with ASYNC_CANCELLED.
+ * @details A newer request of the same kind (and property) replaces an older one still pending, except seeks: turning
+ * @details the volume knob quickly sends only the last value, and a slow bus does not pile up RSQ reads.
+ * @details submit() is lock-free (one __atomic compare-and-swap per slot) and can be called from any thread or from an
+ * @details interrupt handler; service() must always be called from the same thread.
+ *
+ * @code
+ * void done(void *context, uint8_t request, uint8_t result)
+ * {
+ *     if (request == QUEUE_RSQ && result == ASYNC_DONE)
+ *         showSignal(rx.getCurrentRSSI(), rx.getCurrentSNR());
+ * }
+ *
+ * SI4735CommandQueue queue(rx, done);
+ *
+ * queue.submit(QUEUE_RSQ);                  // telemetry poller
+ * queue.submit(QUEUE_VOLUME, 40);           // UI thread: runs before the RSQ read
+ *
+ * while (true)
+ *     queue.service();                      // radio loop
+ * @endcode
+ *
+ * @see group21 Non-blocking (async) commands
+ */
+
+#ifndef _SI4735_QUEUE_H
+#define _SI4735_QUEUE_H
+
+#include "si4735-cpp.h"
+
+#define SI4735_QUEUE_SIZE 8 // Requests pending at the same time (per receiver)
+
+// Priority classes (lower runs first)
+#define QUEUE_PRIORITY_USER 0       // Tune, volume, properties
+#define QUEUE_PRIORITY_SEEK 1       // Seek and scan steps
+#define QUEUE_PRIORITY_BACKGROUND 2 // RSQ and RDS polling
+
+// Requests
+#define QUEUE_TUNE 1     // beginTune(arg)
+#define QUEUE_VOLUME 2   // beginSetVolume(arg)
+#define QUEUE_PROPERTY 3 // beginSetProperty(property, arg)
+#define QUEUE_SEEK 4     // beginSeek(arg & 1, arg >> 1): arg = SEEK_UP or SEEK_DOWN, plus 2 to halt at the band limit
+#define QUEUE_RSQ 5      // beginRsqRead(arg)
+#define QUEUE_RDS 6      // beginRdsRead(arg): arg = INTACK
+
+// service() results
+#define QUEUE_IDLE 0 // Nothing pending
+#define QUEUE_BUSY 1 // A request is in flight or pending
+
+// Slot states
+#define QUEUE_SLOT_FREE 0
+#define QUEUE_SLOT_CLAIMED 1 // Being filled by submit()
+#define QUEUE_SLOT_PENDING 2
+
+/**
+ * @ingroup group21
+ *
+ * @brief Called by service() when a request ends.
+ * @param context the context given to the queue.
+ * @param request QUEUE_TUNE, QUEUE_VOLUME etc.
+ * @param result ASYNC_DONE, ASYNC_ERROR or ASYNC_CANCELLED (seek preempted, or request replaced by a newer one).
+ */
+typedef void (*SI4735QueueCallback)(void *context, uint8_t request, uint8_t result);
+
+/**
+ * @ingroup group21
+ *
+ * @brief Request waiting in SI4735CommandQueue.
+ */
+typedef struct
+{
+    uint8_t state;      //!< QUEUE_SLOT_FREE, QUEUE_SLOT_CLAIMED or QUEUE_SLOT_PENDING (accessed with __atomic)
+    uint8_t request;    //!< QUEUE_TUNE, QUEUE_VOLUME etc.
+    uint8_t priority;   //!< QUEUE_PRIORITY_USER, QUEUE_PRIORITY_SEEK or QUEUE_PRIORITY_BACKGROUND
+    uint16_t property;  //!< Property number (QUEUE_PROPERTY)
+    uint16_t arg;       //!< Frequency, volume, property value, seek direction or INTACK
+    uint32_t submitted; //!< Submission stamp; decides which of two requests of the same kind is newer
+    uint32_t sequence;  //!< Queue position: the submission stamp of the oldest request this one replaced
+} SI4735QueueSlot;
+
+/**
+ * @ingroup group21
+ *
+ * @brief Command queue of one receiver with user, seek and background priority classes.
+ * @see si4735-queue.h
+ */
+class SI4735CommandQueue
+{
+public:
+    SI4735CommandQueue(SI4735Base &rx, SI4735QueueCallback callback = NULL, void *context = NULL)
+        : rx(rx), callback(callback), context(context)
+    {
+        for (uint8_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+            slots[i].state = QUEUE_SLOT_FREE;
+    }
+
+    /**
+     * @brief Default priority class of a request.
+     */
+    static uint8_t defaultPriority(uint8_t request)
+    {
+        if (request == QUEUE_SEEK)
+            return QUEUE_PRIORITY_SEEK;
+        if (request == QUEUE_RSQ || request == QUEUE_RDS)
+            return QUEUE_PRIORITY_BACKGROUND;
+        return QUEUE_PRIORITY_USER;
+    }
+
+    /**
+     * @brief Adds a request with an explicit priority class. Thread safe.
+     * @param request QUEUE_TUNE, QUEUE_VOLUME, QUEUE_PROPERTY, QUEUE_SEEK, QUEUE_RSQ or QUEUE_RDS
+     * @param arg see the request
+     * @param property property number (QUEUE_PROPERTY only)
+     * @param priority QUEUE_PRIORITY_USER, QUEUE_PRIORITY_SEEK or QUEUE_PRIORITY_BACKGROUND
+     * @return false if the queue is full.
+     */
+    bool submit(uint8_t request, uint16_t arg, uint16_t property, uint8_t priority)
+    {
+        for (uint8_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+        {
+            uint8_t expected = QUEUE_SLOT_FREE;
+
+            if (!__atomic_compare_exchange_n(&slots[i].state, &expected, (uint8_t)QUEUE_SLOT_CLAIMED, false, __ATOMIC_ACQUIRE,
+                                             __ATOMIC_RELAXED))
+                continue;
+            slots[i].request = request;
+            slots[i].priority = priority;
+            slots[i].property = property;
+            slots[i].arg = arg;
+            slots[i].submitted = slots[i].sequence = __atomic_add_fetch(&sequence, 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&slots[i].state, (uint8_t)QUEUE_SLOT_PENDING, __ATOMIC_RELEASE);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Adds a request in its default priority class. Thread safe.
+     * @see submit(uint8_t, uint16_t, uint16_t, uint8_t)
+     */
+    inline bool submit(uint8_t request, uint16_t arg = 0, uint16_t property = 0)
+    {
+        return submit(request, arg, property, defaultPriority(request));
+    }
+
+    /**
+     * @brief Runs the queue: advances the request in flight (one poll) and, when it ends, starts the next one.
+     * @details Never sleeps. Call it from the loop that owns the receiver.
+     * @return QUEUE_BUSY while requests are in flight or pending; QUEUE_IDLE otherwise.
+     */
+    uint8_t service()
+    {
+        int8_t next;
+        uint8_t result;
+
+        if (active != 0)
+        {
+            if (active == QUEUE_SEEK && !preempted && pendingAbove(activePriority) && rx.cancelAsync())
+                preempted = true;
+            result = rx.poll();
+            if (result == ASYNC_BUSY)
+                return QUEUE_BUSY;
+            finish(active, result);
+        }
+
+        if ((next = pick()) < 0)
+            return QUEUE_IDLE;
+        start(slots[next]);
+        __atomic_store_n(&slots[next].state, (uint8_t)QUEUE_SLOT_FREE, __ATOMIC_RELEASE);
+        return QUEUE_BUSY;
+    }
+
+    /**
+     * @brief Request in flight (QUEUE_TUNE etc), or 0.
+     */
+    inline uint8_t getActive() { return active; }
+
+    /**
+     * @brief Requests replaced by a newer request of the same kind before they ran.
+     */
+    inline uint32_t getReplaced() { return replaced; }
+
+    /**
+     * @brief Seeks cancelled to run a request of a higher class.
+     */
+    inline uint32_t getPreemptions() { return preemptions; }
+
+protected:
+    SI4735Base &rx;
+    SI4735QueueCallback callback;
+    void *context;
+    SI4735QueueSlot slots[SI4735_QUEUE_SIZE];
+    uint32_t sequence = 0;
+    uint8_t active = 0;         //!< Request in flight
+    uint8_t activePriority = 0; //!< Its class
+    bool preempted = false;     //!< The seek in flight is being cancelled
+    uint32_t replaced = 0;
+    uint32_t preemptions = 0;
+
+    void finish(uint8_t request, uint8_t result)
+    {
+        if (preempted)
+            preemptions++;
+        active = 0;
+        preempted = false;
+        if (callback)
+            callback(context, request, result);
+    }
+
+    /**
+     * @brief True if a request of a class higher than priority is pending.
+     */
+    bool pendingAbove(uint8_t priority)
+    {
+        for (uint8_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+            if (__atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) == QUEUE_SLOT_PENDING && slots[i].priority < priority)
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Same request, and same property for QUEUE_PROPERTY. Seeks are never merged.
+     */
+    static bool sameKind(const SI4735QueueSlot &a, const SI4735QueueSlot &b)
+    {
+        return a.request == b.request && a.request != QUEUE_SEEK && (a.request != QUEUE_PROPERTY || a.property == b.property);
+    }
+
+    /**
+     * @brief Chooses the next request: highest class, then oldest. Pending requests replaced by a newer one of the same
+     * @brief kind are dropped (ASYNC_CANCELLED); the newest takes the place of the oldest.
+     * @return slot index, or -1 if nothing is pending.
+     */
+    int8_t pick()
+    {
+        int8_t best = -1;
+
+        for (uint8_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+        {
+            if (__atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) != QUEUE_SLOT_PENDING)
+                continue;
+            for (uint8_t j = 0; j < SI4735_QUEUE_SIZE; j++)
+            {
+                if (j == i || __atomic_load_n(&slots[j].state, __ATOMIC_ACQUIRE) != QUEUE_SLOT_PENDING ||
+                    !sameKind(slots[i], slots[j]) || (int32_t)(slots[j].submitted - slots[i].submitted) < 0)
+                    continue;
+                // i is older than j: j runs in the earlier of the two positions
+                if ((int32_t)(slots[i].sequence - slots[j].sequence) < 0)
+                    slots[j].sequence = slots[i].sequence;
+                if (slots[i].priority < slots[j].priority)
+                    slots[j].priority = slots[i].priority;
+                replaced++;
+                __atomic_store_n(&slots[i].state, (uint8_t)QUEUE_SLOT_FREE, __ATOMIC_RELEASE);
+                if (callback)
+                    callback(context, slots[i].request, ASYNC_CANCELLED);
+                break;
+            }
+        }
+        for (uint8_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+        {
+            if (__atomic_load_n(&slots[i].state, __ATOMIC_ACQUIRE) != QUEUE_SLOT_PENDING)
+                continue;
+            if (best < 0 || slots[i].priority < slots[best].priority ||
+                (slots[i].priority == slots[best].priority && (int32_t)(slots[i].sequence - slots[best].sequence) < 0))
+                best = i;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Starts the async command of a request.
+     */
+    void start(const SI4735QueueSlot &slot)
+    {
+        bool started = false;
+
+        switch (slot.request)
+        {
+        case QUEUE_TUNE:
+            started = rx.beginTune(slot.arg);
+            break;
+        case QUEUE_VOLUME:
+            started = rx.beginSetVolume((uint8_t)slot.arg);
+            break;
+        case QUEUE_PROPERTY:
+            started = rx.beginSetProperty(slot.property, slot.arg);
+            break;
+        case QUEUE_SEEK:
+            started = rx.beginSeek(slot.arg & 1, !(slot.arg & 2));
+            break;
+        case QUEUE_RSQ:
+            started = rx.beginRsqRead((uint8_t)slot.arg);
+            break;
+        case QUEUE_RDS:
+            started = rx.beginRdsRead((uint8_t)slot.arg);
+            break;
+        }
+        if (!started)
+        {
+            if (callback)
+                callback(context, slot.request, ASYNC_ERROR);
+            return;
+        }
+        active = slot.request;
+        activePriority = slot.priority;
+    }
+};
+
+#endif // _SI4735_QUEUE_H
@@ -0,0 +1,305 @@
+//
+// I2C transport over the Linux i2c-dev interface (/dev/i2c-N) for single board computers.
+//
+
+#ifdef __linux__
+
+#include "I2CLinux.h"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * @brief Opens the i2c-dev device for reading and writing.
+ */
+int I2CLinuxSystem::open(const char *path)
+{
+    return ::open(path, O_RDWR);
+}
+
+/**
+ * @brief Runs the messages with a single I2C_RDWR ioctl (repeated start between the messages, stop at the end).
+ */
+int I2CLinuxSystem::transfer(int fd, struct i2c_msg *msgs, uint32_t count)
+{
+    struct i2c_rdwr_ioctl_data data;
+
+    data.msgs = msgs;
+    data.nmsgs = count;
+    return ioctl(fd, I2C_RDWR, &data);
+}
+
+void I2CLinuxSystem::close(int fd)
+{
+    ::close(fd);
+}
+
+I2CLinuxSystem &I2CLinuxSystem::instance()
+{
+    static I2CLinuxSystem system;
+    return system;
+}
+
+/**
+ * @brief Creates the transport. The device is opened by begin.
+ * @param path bus device (for example, "/dev/i2c-1" on the Raspberry Pi header).
+ * @param backend file descriptor operations; the default calls the kernel.
+ */
+I2CLinux::I2CLinux(const char *path, I2CLinuxBackend &backend) : path(path), backend(backend)
+{
+}
+
+I2CLinux::~I2CLinux()
+{
+    end();
+}
+
+/**
+ * @brief Opens the bus device.
+ * @return true if the device could be opened.
+ */
+bool I2CLinux::begin()
+{
+    if (fd < 0)
+        fd = backend.open(path);
+    transfers = errors = 0;
+    queued = 0;
+    queueDataSize = 0;
+    return fd >= 0;
+}
+
+/**
+ * @brief Closes the bus device. Queued messages are dropped.
+ */
+void I2CLinux::end()
+{
+    if (fd >= 0)
+        backend.close(fd);
+    fd = -1;
+    queued = 0;
+    queueDataSize = 0;
+}
+
+/**
+ * @brief Runs the messages as one transfer and counts the result.
+ */
+bool I2CLinux::transfer(struct i2c_msg *msgs, uint32_t count)
+{
+    if (fd < 0)
+        return false;
+    transfers++;
+    if (backend.transfer(fd, msgs, count) != (int)count)
+    {
+        errors++;
+        return false;
+    }
+    return true;
+}
+
+void I2CLinux::beginTransmission(int address)
+{
+    writeAddress = (uint16_t)address;
+    writeSize = 0;
+    overflow = false;
+}
+
+size_t I2CLinux::write(uint8_t data)
+{
+    if (writeSize >= I2C_LINUX_BUFFER_SIZE)
+    {
+        overflow = true;
+        return 0;
+    }
+    writeBuffer[writeSize++] = data;
+    return 1;
+}
+
+size_t I2CLinux::write(const uint8_t *data, size_t size)
+{
+    size_t n = 0;
+
+    while (n < size && write(data[n]))
+        n++;
+    return n;
+}
+
+/**
+ * @brief Sends the bytes written since beginTransmission as a single write message.
+ * @return 0 on success; 1 if the bytes did not fit the buffer; 4 if the transfer failed (as the Arduino Wire library).
+ */
+uint8_t I2CLinux::endTransmission()
+{
+    struct i2c_msg msg;
+
+    if (overflow)
+        return 1;
+    msg.addr = writeAddress;
+    msg.flags = 0;
+    msg.len = writeSize;
+    msg.buf = writeBuffer;
+    return transfer(&msg, 1) ? 0 : 4;
+}
+
+/**
+ * @brief Reads quantity bytes with a single read message. Use read() to get them.
+ * @return number of bytes read (0 if the transfer failed).
+ */
+uint8_t I2CLinux::requestFrom(int address, int quantity)
+{
+    struct i2c_msg msg;
+
+    readSize = readPosition = 0;
+    if (quantity <= 0)
+        return 0;
+    if (quantity > I2C_LINUX_BUFFER_SIZE)
+        quantity = I2C_LINUX_BUFFER_SIZE;
+    msg.addr = (uint16_t)address;
+    msg.flags = I2C_M_RD;
+    msg.len = (uint16_t)quantity;
+    msg.buf = readBuffer;
+    if (!transfer(&msg, 1))
+        return 0;
+    readSize = (uint8_t)quantity;
+    return readSize;
+}
+
+int I2CLinux::read()
+{
+    if (readPosition >= readSize)
+        return -1;
+    return readBuffer[readPosition++];
+}
+
+/**
+ * @brief Writes the command and reads the response in one transfer (repeated start, no stop in between).
+ * @see SI4735Base::setTransaction
+ */
+bool I2CLinux::writeRead(int address, const uint8_t *out, size_t outSize, uint8_t *in, size_t inSize)
+{
+    struct i2c_msg msgs[2];
+
+    msgs[0].addr = (uint16_t)address;
+    msgs[0].flags = 0;
+    msgs[0].len = (uint16_t)outSize;
+    msgs[0].buf = (uint8_t *)out;
+    msgs[1].addr = (uint16_t)address;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = (uint16_t)inSize;
+    msgs[1].buf = in;
+    return transfer(msgs, 2);
+}
+
+/**
+ * @brief Adds a write message to the queue. The bytes are copied; data can be reused right away.
+ * @return false if the queue is full (call submit first).
+ */
+bool I2CLinux::queueWrite(int address, const uint8_t *data, size_t size)
+{
+    struct i2c_msg *msg;
+
+    if (queued >= I2C_LINUX_MAX_MSGS || size > (size_t)(I2C_LINUX_QUEUE_SIZE - queueDataSize))
+        return false;
+    memcpy(queueData + queueDataSize, data, size);
+    msg = &queue[queued++];
+    msg->addr = (uint16_t)address;
+    msg->flags = 0;
+    msg->len = (uint16_t)size;
+    msg->buf = queueData + queueDataSize;
+    queueDataSize += (uint16_t)size;
+    return true;
+}
+
+/**
+ * @brief Adds a read message to the queue. data is filled by submit.
+ * @return false if the queue is full (call submit first).
+ */
+bool I2CLinux::queueRead(int address, uint8_t *data, size_t size)
+{
+    struct i2c_msg *msg;
+
+    if (queued >= I2C_LINUX_MAX_MSGS || size > 0xFFFF)
+        return false;
+    msg = &queue[queued++];
+    msg->addr = (uint16_t)address;
+    msg->flags = I2C_M_RD;
+    msg->len = (uint16_t)size;
+    msg->buf = data;
+    return true;
+}
+
+/**
+ * @brief Sends the queued messages in one transfer and empties the queue.
+ * @return true if every message was done (or the queue was empty).
+ */
+bool I2CLinux::submit()
+{
+    bool ok = true;
+
+    if (queued)
+        ok = transfer(queue, queued);
+    queued = 0;
+    queueDataSize = 0;
+    return ok;
+}
+
+/**
+ * @brief Opens the fake bus (one at a time) and keeps the path (see getPath).
+ */
+int I2CLinuxFakeBackend::open(const char *path)
+{
+    if (opened)
+        return -1;
+    this->path = path;
+    opened = true;
+    return 3;
+}
+
+/**
+ * @brief Plays the messages on the target: beginTransmission / write / endTransmission for a write message,
+ * @brief requestFrom / read for a read message.
+ * @return number of messages (or -1 if the fd is wrong, a message failed or failNext was called).
+ */
+int I2CLinuxFakeBackend::transfer(int fd, struct i2c_msg *msgs, uint32_t count)
+{
+    transfers++;
+    if (!opened || fd != 3 || count == 0 || count > I2C_LINUX_MAX_MSGS)
+        return -1;
+    if (failures)
+    {
+        failures--;
+        return -1;
+    }
+    if (count > largest)
+        largest = count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        struct i2c_msg &msg = msgs[i];
+
+        messages++;
+        bytes += msg.len;
+        if (msg.flags & I2C_M_RD)
+        {
+            if (target.requestFrom(msg.addr, msg.len) != msg.len)
+                return -1;
+            for (uint16_t k = 0; k < msg.len; k++)
+                msg.buf[k] = (uint8_t)target.read();
+        }
+        else
+        {
+            target.beginTransmission(msg.addr);
+            target.write(msg.buf, msg.len);
+            if (target.endTransmission() != 0)
+                return -1;
+        }
+    }
+    return (int)count;
+}
+
+void I2CLinuxFakeBackend::close(int fd)
+{
+    if (fd == 3)
+        opened = false;
+}
+
+#endif // __linux__
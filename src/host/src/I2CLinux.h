@@ -0,0 +1,210 @@
+//
+// I2C transport over the Linux i2c-dev interface (/dev/i2c-N) for single board computers.
+//
+
+#ifndef SI4735_CPP_I2CLINUX_H
+#define SI4735_CPP_I2CLINUX_H
+
+#ifdef __linux__
+
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include <si4735-cpp.h>
+
+#define I2C_LINUX_MAX_MSGS 42      // Messages per I2C_RDWR ioctl (I2C_RDWR_IOCTL_MAX_MSGS of the kernel)
+#define I2C_LINUX_BUFFER_SIZE 32   // Bytes of a single write (beginTransmission ... endTransmission) or read (requestFrom)
+#define I2C_LINUX_QUEUE_SIZE 512   // Bytes written by the queued messages of one submit
+
+/**
+ * @ingroup group05
+ *
+ * @brief File descriptor operations used by I2CLinux.
+ *
+ * @details I2CLinuxSystem calls the kernel. I2CLinuxFakeBackend runs the messages in process, so I2CLinux can be
+ * @details tested without /dev/i2c-N.
+ */
+class I2CLinuxBackend
+{
+  public:
+    virtual ~I2CLinuxBackend() {}
+
+    /**
+     * @brief Opens the bus device. Returns the file descriptor or -1.
+     */
+    virtual int open(const char *path) = 0;
+
+    /**
+     * @brief Runs the messages as one combined transfer (I2C_RDWR). Returns the number of messages done or -1.
+     */
+    virtual int transfer(int fd, struct i2c_msg *msgs, uint32_t count) = 0;
+
+    virtual void close(int fd) = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2CLinuxBackend on the kernel i2c-dev driver (open, ioctl(I2C_RDWR), close).
+ */
+class I2CLinuxSystem : public I2CLinuxBackend
+{
+  public:
+    int open(const char *path);
+    int transfer(int fd, struct i2c_msg *msgs, uint32_t count);
+    void close(int fd);
+
+    /**
+     * @brief Backend shared by the I2CLinux instances that do not get one.
+     */
+    static I2CLinuxSystem &instance();
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2C on /dev/i2c-N with one I2C_RDWR ioctl per bus transaction.
+ *
+ * @details write() only buffers the bytes: beginTransmission ... endTransmission is a single ioctl with one write message,
+ * @details and requestFrom a single ioctl with one read message. As SI4735Transaction, it runs the command write and the
+ * @details response read in one ioctl with a repeated start (see SI4735Base::setTransaction).
+ * @details queueWrite / queueRead / submit send up to I2C_LINUX_MAX_MSGS messages in one ioctl. The Si47XX does not stretch
+ * @details the clock while it is busy, so only queue messages the devices accept back to back (for example, messages to
+ * @details different devices or to the patch EEPROM); each Si47XX command still needs CTS before the next one.
+ * @details For that reason SI4735Base does not use the queue: every command, patch lines included, waits for the CTS of
+ * @details the previous one, and a status read queued right after a command sees CTS clear.
+ * @code
+ *   I2CLinux bus("/dev/i2c-1");
+ *   MyClock clock;               // Clock implementation of the application
+ *   SI4735 rx(bus, clock);
+ *
+ *   if (!bus.begin())
+ *       return 1;
+ *   rx.setTransaction(&bus);
+ *   rx.setup(RESET_PIN, POWER_UP_FM);
+ * @endcode
+ */
+class I2CLinux : public I2C, public SI4735Transaction
+{
+  public:
+    I2CLinux(const char *path, I2CLinuxBackend &backend = I2CLinuxSystem::instance());
+    ~I2CLinux();
+
+    bool begin();
+    void end();
+
+    void beginTransmission(int address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission();
+    uint8_t requestFrom(int address, int quantity);
+    int read();
+
+    bool writeRead(int address, const uint8_t *out, size_t outSize, uint8_t *in, size_t inSize);
+
+    bool queueWrite(int address, const uint8_t *data, size_t size);
+    bool queueRead(int address, uint8_t *data, size_t size);
+    bool submit();
+
+    /**
+     * @brief true if the bus device is open (see begin).
+     */
+    inline bool isOpen() { return fd >= 0; }
+
+    /**
+     * @brief Messages waiting for submit.
+     */
+    inline uint8_t getQueued() { return queued; }
+
+    /**
+     * @brief Number of ioctl calls (bus transfers) done since begin.
+     */
+    inline uint32_t getTransfers() { return transfers; }
+
+    /**
+     * @brief Number of failed ioctl calls since begin.
+     */
+    inline uint32_t getErrors() { return errors; }
+
+  protected:
+    const char *path;
+    I2CLinuxBackend &backend;
+    int fd = -1;
+    uint32_t transfers = 0;
+    uint32_t errors = 0;
+
+    // beginTransmission ... endTransmission
+    uint16_t writeAddress = 0;
+    uint8_t writeBuffer[I2C_LINUX_BUFFER_SIZE];
+    uint8_t writeSize = 0;
+    bool overflow = false;
+
+    // requestFrom ... read
+    uint8_t readBuffer[I2C_LINUX_BUFFER_SIZE];
+    uint8_t readSize = 0;
+    uint8_t readPosition = 0;
+
+    // queueWrite / queueRead ... submit
+    struct i2c_msg queue[I2C_LINUX_MAX_MSGS];
+    uint8_t queued = 0;
+    uint8_t queueData[I2C_LINUX_QUEUE_SIZE];
+    uint16_t queueDataSize = 0;
+
+    bool transfer(struct i2c_msg *msgs, uint32_t count);
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief In-process I2CLinuxBackend: runs the messages of each transfer on an I2C target (for example SI4735Simulator).
+ *
+ * @code
+ *   SI4735VirtualClock clock;
+ *   SI4735Simulator device(clock);
+ *   I2CLinuxFakeBackend fake(device);
+ *   I2CLinux bus("/dev/i2c-fake", fake);
+ *   SI4735 rx(bus, clock);
+ *
+ *   bus.begin();
+ *   rx.setup(0, POWER_UP_FM);
+ *   printf("%u ioctls, %u messages\n", fake.getTransfers(), fake.getMessages());
+ * @endcode
+ */
+class I2CLinuxFakeBackend : public I2CLinuxBackend
+{
+  public:
+    explicit I2CLinuxFakeBackend(I2C &target) : target(target) {}
+
+    int open(const char *path);
+    int transfer(int fd, struct i2c_msg *msgs, uint32_t count);
+    void close(int fd);
+
+    /**
+     * @brief Makes the next transfers fail (the ioctl returns -1, as on a NACK).
+     */
+    inline void failNext(uint8_t times = 1) { failures = times; }
+
+    /**
+     * @brief Path passed to the last open (NULL if never opened).
+     */
+    inline const char *getPath() { return path; }
+
+    inline uint32_t getTransfers() { return transfers; }
+    inline uint32_t getMessages() { return messages; }
+    inline uint32_t getBytes() { return bytes; }
+    inline uint32_t getLargestTransfer() { return largest; }
+
+  protected:
+    I2C &target;
+    const char *path = NULL;
+    bool opened = false;
+    uint8_t failures = 0;
+    uint32_t transfers = 0;
+    uint32_t messages = 0;
+    uint32_t bytes = 0;
+    uint32_t largest = 0; //!< Most messages in one transfer
+};
+
+#endif // __linux__
+
+#endif //SI4735_CPP_I2CLINUX_H
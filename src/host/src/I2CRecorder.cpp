@@ -0,0 +1,278 @@
+//
+// Record and replay of I2C traffic (capture a session on a real radio once, replay it offline).
+//
+
+#include "I2CRecorder.h"
+
+#include <cstdlib>
+
+/**
+ * @brief Wraps target and writes the file header.
+ * @param target transport that talks to the device.
+ * @param clock clock of the timestamps (Clock::now).
+ * @param out file open for writing in binary mode.
+ */
+I2CRecorder::I2CRecorder(I2C &target, Clock &clock, FILE *out) : target(target), clock(clock), out(out)
+{
+    uint8_t version = I2C_RECORD_VERSION;
+
+    lastTime = clock.now();
+    fileSize = fwrite(I2C_RECORD_MAGIC, 1, 4, out) + fwrite(&version, 1, 1, out);
+}
+
+/**
+ * @brief Appends one record to the file.
+ */
+void I2CRecorder::record(uint8_t kind, uint8_t address, uint8_t status, const uint8_t *data, uint8_t size)
+{
+    uint8_t head[3 + 5 + 1];
+    uint8_t n = 0;
+    unsigned long now = clock.now();
+    uint32_t delta = (uint32_t)(now - lastTime);
+
+    lastTime = now;
+    head[n++] = kind;
+    head[n++] = address;
+    head[n++] = status;
+    do
+    {
+        head[n++] = (uint8_t)((delta & 0x7F) | (delta > 0x7F ? 0x80 : 0));
+        delta >>= 7;
+    } while (delta);
+    head[n++] = size;
+    fileSize += fwrite(head, 1, n, out) + fwrite(data, 1, size, out);
+    records++;
+}
+
+void I2CRecorder::beginTransmission(int address)
+{
+    writeAddress = (uint8_t)address;
+    writeSize = 0;
+    target.beginTransmission(address);
+}
+
+size_t I2CRecorder::write(uint8_t data)
+{
+    if (writeSize < I2C_RECORD_MAX_DATA)
+        writeBuffer[writeSize++] = data;
+    return target.write(data);
+}
+
+size_t I2CRecorder::write(const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size && writeSize < I2C_RECORD_MAX_DATA; i++)
+        writeBuffer[writeSize++] = data[i];
+    return target.write(data, size);
+}
+
+uint8_t I2CRecorder::endTransmission()
+{
+    uint8_t result = target.endTransmission();
+
+    record(I2C_RECORD_WRITE, writeAddress, result, writeBuffer, writeSize);
+    return result;
+}
+
+/**
+ * @brief Reads the response from the target right away and records it. read() returns the recorded bytes.
+ */
+uint8_t I2CRecorder::requestFrom(int address, int quantity)
+{
+    uint8_t n = target.requestFrom(address, quantity);
+
+    readSize = readPosition = 0;
+    while (readSize < n && readSize < I2C_RECORD_MAX_DATA)
+    {
+        int c = target.read();
+        if (c < 0)
+            break;
+        readBuffer[readSize++] = (uint8_t)c;
+    }
+    record(I2C_RECORD_READ, (uint8_t)address, (uint8_t)quantity, readBuffer, readSize);
+    return readSize;
+}
+
+int I2CRecorder::read()
+{
+    if (readPosition >= readSize)
+        return -1;
+    return readBuffer[readPosition++];
+}
+
+I2CReplay::~I2CReplay()
+{
+    free(data);
+}
+
+/**
+ * @brief Loads a recording made by I2CRecorder.
+ * @return false if the file cannot be read or is not a recording.
+ */
+bool I2CReplay::load(const char *path)
+{
+    FILE *in = fopen(path, "rb");
+    bool ok;
+
+    if (!in)
+        return false;
+    ok = load(in);
+    fclose(in);
+    return ok;
+}
+
+/**
+ * @brief Loads a recording from an open file (read up to the end of the file).
+ */
+bool I2CReplay::load(FILE *in)
+{
+    uint8_t header[5];
+    uint8_t buffer[512];
+    size_t n;
+
+    free(data);
+    data = NULL;
+    size = 0;
+    if (fread(header, 1, 5, in) != 5 || memcmp(header, I2C_RECORD_MAGIC, 4) != 0 || header[4] != I2C_RECORD_VERSION)
+        return false;
+    while ((n = fread(buffer, 1, sizeof buffer, in)) > 0)
+    {
+        uint8_t *grown = (uint8_t *)realloc(data, size + n);
+        if (!grown)
+            return false;
+        data = grown;
+        memcpy(data + size, buffer, n);
+        size += (uint32_t)n;
+    }
+    rewind();
+    return true;
+}
+
+/**
+ * @brief Restarts the replay from the first record and clears the counters.
+ */
+void I2CReplay::rewind()
+{
+    position = time = records = 0;
+    mismatches = extraReads = skippedReads = 0;
+    responseSize = readSize = readPosition = 0;
+}
+
+/**
+ * @brief Kind of the next record (0 at the end of the recording).
+ */
+uint8_t I2CReplay::peek()
+{
+    return (position < size) ? data[position] : 0;
+}
+
+/**
+ * @brief Decodes the next record and moves past it.
+ * @return false at the end of the recording or if the last record is cut.
+ */
+bool I2CReplay::next(uint8_t *kind, uint8_t *address, uint8_t *status, const uint8_t **bytes, uint8_t *length)
+{
+    uint32_t p = position;
+    uint32_t delta = 0;
+    uint8_t shift = 0;
+
+    if (p + 3 > size)
+        return false;
+    *kind = data[p++];
+    *address = data[p++];
+    *status = data[p++];
+    do
+    {
+        if (p >= size || shift > 28)
+            return false;
+        delta |= (uint32_t)(data[p] & 0x7F) << shift;
+        shift += 7;
+    } while (data[p++] & 0x80);
+    if (p >= size)
+        return false;
+    *length = data[p++];
+    if (p + *length > size)
+        return false;
+    *bytes = data + p;
+    position = p + *length;
+    time += delta;
+    records++;
+    return true;
+}
+
+void I2CReplay::beginTransmission(int address)
+{
+    writeAddress = (uint8_t)address;
+    writeSize = 0;
+}
+
+size_t I2CReplay::write(uint8_t data)
+{
+    if (writeSize >= I2C_RECORD_MAX_DATA)
+        return 0;
+    writeBuffer[writeSize++] = data;
+    return 1;
+}
+
+size_t I2CReplay::write(const uint8_t *data, size_t size)
+{
+    size_t n = 0;
+
+    while (n < size && write(data[n]))
+        n++;
+    return n;
+}
+
+/**
+ * @brief Checks the write against the next recorded write and returns its recorded result.
+ * @details Recorded reads the driver did not make (status polls) are skipped.
+ * @return the recorded endTransmission result; 4 at the end of the recording.
+ */
+uint8_t I2CReplay::endTransmission()
+{
+    uint8_t kind, address, status, length;
+    const uint8_t *bytes;
+
+    while (peek() == I2C_RECORD_READ && next(&kind, &address, &status, &bytes, &length))
+        skippedReads++;
+    if (!next(&kind, &address, &status, &bytes, &length))
+    {
+        mismatches++;
+        return 4;
+    }
+    if (kind != I2C_RECORD_WRITE || address != writeAddress || length != writeSize || memcmp(bytes, writeBuffer, length) != 0)
+        mismatches++;
+    return status;
+}
+
+/**
+ * @brief Serves the next recorded read. When the recording has a write next, the driver polls more than it did
+ * @brief during the recording and gets the last response again.
+ * @return number of bytes available to read().
+ */
+uint8_t I2CReplay::requestFrom(int address, int quantity)
+{
+    uint8_t kind, recordedAddress, status, length;
+    const uint8_t *bytes;
+
+    readPosition = 0;
+    if (peek() == I2C_RECORD_READ && next(&kind, &recordedAddress, &status, &bytes, &length))
+    {
+        if (recordedAddress != (uint8_t)address || status != (uint8_t)quantity)
+            mismatches++;
+        if (length > I2C_RECORD_MAX_DATA)
+            length = I2C_RECORD_MAX_DATA;
+        memcpy(readBuffer, bytes, length);
+        responseSize = length;
+    }
+    else
+        extraReads++;
+    readSize = (quantity < responseSize) ? (uint8_t)quantity : responseSize;
+    return readSize;
+}
+
+int I2CReplay::read()
+{
+    if (readPosition >= readSize)
+        return -1;
+    return readBuffer[readPosition++];
+}
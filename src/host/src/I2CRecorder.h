@@ -0,0 +1,160 @@
+//
+// Record and replay of I2C traffic (capture a session on a real radio once, replay it offline).
+//
+
+#ifndef SI4735_CPP_I2CRECORDER_H
+#define SI4735_CPP_I2CRECORDER_H
+
+#include <cstdio>
+
+#include <si4735-cpp.h>
+
+#define I2C_RECORD_MAGIC "SI47"   // First 4 bytes of a recording
+#define I2C_RECORD_VERSION 1      // Byte 5 of a recording
+#define I2C_RECORD_WRITE 'W'      // beginTransmission ... endTransmission
+#define I2C_RECORD_READ 'R'       // requestFrom and the read() calls after it
+#define I2C_RECORD_MAX_DATA 32    // Bytes kept for a single record
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2C decorator that writes every transaction of the wrapped transport to a file.
+ *
+ * @details File format: the 4 bytes I2C_RECORD_MAGIC and the byte I2C_RECORD_VERSION, then one record per transaction:
+ * @details kind (I2C_RECORD_WRITE or I2C_RECORD_READ), address, status, time since the previous record in ms (Clock::now,
+ * @details unsigned LEB128), length and the bytes. The status of a write is the endTransmission result; the status of a read
+ * @details is the quantity asked to requestFrom. The bytes of a read are the ones returned by requestFrom / read().
+ * @details A status read takes 6 bytes on file; a command with 8 bytes takes 13.
+ * @code
+ *   FILE *out = fopen("band-scan.si47", "wb");
+ *   I2CRecorder recorder(bus, clock, out);
+ *   SI4735 rx(recorder, clock);
+ *   ...
+ *   recorder.flush();
+ *   fclose(out);
+ * @endcode
+ * @see I2CReplay
+ */
+class I2CRecorder : public I2C
+{
+  public:
+    I2CRecorder(I2C &target, Clock &clock, FILE *out);
+
+    void beginTransmission(int address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission();
+    uint8_t requestFrom(int address, int quantity);
+    int read();
+
+    /**
+     * @brief Writes the buffered records to the file.
+     */
+    inline void flush() { fflush(out); }
+
+    /**
+     * @brief Records written since the recorder was created.
+     */
+    inline uint32_t getRecords() { return records; }
+
+    /**
+     * @brief Bytes written to the file (header included).
+     */
+    inline uint32_t getFileSize() { return fileSize; }
+
+  protected:
+    I2C &target;
+    Clock &clock;
+    FILE *out;
+    unsigned long lastTime;
+    uint32_t records = 0;
+    uint32_t fileSize = 0;
+
+    uint8_t writeAddress = 0;
+    uint8_t writeBuffer[I2C_RECORD_MAX_DATA];
+    uint8_t writeSize = 0;
+
+    uint8_t readBuffer[I2C_RECORD_MAX_DATA];
+    uint8_t readSize = 0;
+    uint8_t readPosition = 0;
+
+    void record(uint8_t kind, uint8_t address, uint8_t status, const uint8_t *data, uint8_t size);
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief I2C transport that answers the driver with the responses of a recording (see I2CRecorder).
+ *
+ * @details Writes are compared with the recorded ones; a different command is counted by getMismatches and the
+ * @details replay goes on. Status polls do not have to match the recording: extra polls get the last response again and
+ * @details the recorded polls the driver no longer makes are skipped (see getExtraReads and getSkippedReads). So the replay
+ * @details keeps working when the driver waits for CTS in a different way, and a changed command sequence shows up as mismatches.
+ * @details The whole recording is kept in memory, so replay does no file I/O.
+ * @code
+ *   I2CReplay replay;
+ *   SI4735VirtualClock clock;
+ *   SI4735 rx(replay, clock);
+ *
+ *   if (!replay.load("band-scan.si47"))
+ *       return 1;
+ *   ... same calls as the recorded session ...
+ *   printf("%u mismatches\n", replay.getMismatches());
+ * @endcode
+ */
+class I2CReplay : public I2C
+{
+  public:
+    I2CReplay() {}
+    ~I2CReplay();
+
+    bool load(const char *path);
+    bool load(FILE *in);
+    void rewind();
+
+    void beginTransmission(int address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission();
+    uint8_t requestFrom(int address, int quantity);
+    int read();
+
+    /**
+     * @brief true when every record was replayed.
+     */
+    inline bool isDone() { return position >= size; }
+
+    /**
+     * @brief Time (ms since the start of the recording) of the last record replayed.
+     */
+    inline uint32_t getTime() { return time; }
+
+    inline uint32_t getRecords() { return records; }
+    inline uint32_t getMismatches() { return mismatches; }
+    inline uint32_t getExtraReads() { return extraReads; }
+    inline uint32_t getSkippedReads() { return skippedReads; }
+
+  protected:
+    uint8_t *data = NULL; //!< Records of the recording (header removed)
+    uint32_t size = 0;
+    uint32_t position = 0;
+    uint32_t time = 0;
+    uint32_t records = 0;
+    uint32_t mismatches = 0;
+    uint32_t extraReads = 0;
+    uint32_t skippedReads = 0;
+
+    uint8_t writeAddress = 0;
+    uint8_t writeBuffer[I2C_RECORD_MAX_DATA];
+    uint8_t writeSize = 0;
+
+    uint8_t readBuffer[I2C_RECORD_MAX_DATA]; //!< Last recorded response
+    uint8_t responseSize = 0;
+    uint8_t readSize = 0;
+    uint8_t readPosition = 0;
+
+    bool next(uint8_t *kind, uint8_t *address, uint8_t *status, const uint8_t **bytes, uint8_t *length);
+    uint8_t peek();
+};
+
+#endif //SI4735_CPP_I2CRECORDER_H
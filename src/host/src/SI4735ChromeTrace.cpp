@@ -0,0 +1,140 @@
+//
+// Timeline of the driver operations in Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+
+#include "SI4735ChromeTrace.h"
+
+#include <chrono>
+
+static const char *const traceCategories[] = {"operation", "i2c", "cts", "stc", "sleep"};
+
+static uint64_t steadyMicros()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Wraps target and starts the JSON document.
+ * @param target transport that talks to the device.
+ * @param out file open for writing.
+ * @param clock virtual clock of a simulated run; NULL uses the host steady clock.
+ */
+SI4735ChromeTrace::SI4735ChromeTrace(I2C &target, FILE *out, SI4735VirtualClock *clock) : target(target), out(out), clock(clock)
+{
+    start = steadyMicros();
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", out);
+}
+
+SI4735ChromeTrace::~SI4735ChromeTrace()
+{
+    finish();
+}
+
+uint64_t SI4735ChromeTrace::micros()
+{
+    return (clock != NULL) ? clock->micros() : steadyMicros() - start;
+}
+
+/**
+ * @brief Writes one trace event. cmd and bytes are added to the arguments when not negative.
+ */
+void SI4735ChromeTrace::event(char phase, const char *name, uint8_t kind, int cmd, int bytes)
+{
+    if (finished)
+        return;
+    fprintf(out, "%s\n{\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":1", events ? "," : "", phase, (unsigned long long)micros());
+    if (phase == 'B')
+    {
+        fprintf(out, ",\"name\":\"%s\",\"cat\":\"%s\",\"args\":{", name, traceCategories[kind < 5 ? kind : 0]);
+        if (cmd >= 0)
+            fprintf(out, "\"cmd\":\"0x%02X\"%s", cmd, (bytes >= 0) ? "," : "");
+        if (bytes >= 0)
+            fprintf(out, "\"bytes\":%d", bytes);
+        fputc('}', out);
+    }
+    fputc('}', out);
+    events++;
+}
+
+/**
+ * @brief Starts a span (see SI4735Tracer).
+ */
+void SI4735ChromeTrace::begin(const char *name, uint8_t kind, uint8_t cmd)
+{
+    event('B', name, kind, cmd ? cmd : -1, -1);
+    depth++;
+}
+
+void SI4735ChromeTrace::end()
+{
+    if (depth == 0)
+        return;
+    depth--;
+    event('E', NULL, 0, -1, -1);
+}
+
+/**
+ * @brief Ends the open spans and closes the JSON document. Later events are dropped.
+ */
+void SI4735ChromeTrace::finish()
+{
+    if (finished)
+        return;
+    while (depth)
+        end();
+    fputs("\n]}\n", out);
+    fflush(out);
+    finished = true;
+}
+
+void SI4735ChromeTrace::beginTransmission(int address)
+{
+    writeSize = 0;
+    target.beginTransmission(address);
+}
+
+size_t SI4735ChromeTrace::write(uint8_t data)
+{
+    if (writeSize++ == 0)
+        writeCommand = data;
+    return target.write(data);
+}
+
+size_t SI4735ChromeTrace::write(const uint8_t *data, size_t size)
+{
+    if (writeSize == 0 && size > 0)
+        writeCommand = data[0];
+    writeSize += (uint8_t)size;
+    return target.write(data, size);
+}
+
+/**
+ * @brief Sends the write as an "i2c write" span (command opcode and bytes).
+ */
+uint8_t SI4735ChromeTrace::endTransmission()
+{
+    uint8_t result;
+
+    event('B', "i2c write", TRACE_I2C, writeSize ? writeCommand : -1, writeSize);
+    result = target.endTransmission();
+    event('E', NULL, 0, -1, -1);
+    return result;
+}
+
+/**
+ * @brief Reads as an "i2c read" span (bytes asked).
+ */
+uint8_t SI4735ChromeTrace::requestFrom(int address, int quantity)
+{
+    uint8_t n;
+
+    event('B', "i2c read", TRACE_I2C, -1, quantity);
+    n = target.requestFrom(address, quantity);
+    event('E', NULL, 0, -1, -1);
+    return n;
+}
+
+int SI4735ChromeTrace::read()
+{
+    return target.read();
+}
@@ -0,0 +1,74 @@
+//
+// Timeline of the driver operations in Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+
+#ifndef SI4735_CPP_SI4735CHROMETRACE_H
+#define SI4735_CPP_SI4735CHROMETRACE_H
+
+#include <cstdio>
+
+#include <si4735-cpp.h>
+
+#include "SI4735Simulator.h"
+
+/**
+ * @ingroup group05
+ *
+ * @brief SI4735Tracer that writes Chrome trace JSON, and I2C decorator that adds the bus transfers to the same timeline.
+ *
+ * @details Needs a library built with SI4735_INSTRUMENTATION (setTracer). Operations (setFrequency, seekStation, loadPatch,
+ * @details getRdsStatus, mode switches...) are spans of category "operation"; nested inside are the CTS waits ("cts"),
+ * @details STCINT waits ("stc"), fixed delays ("sleep") and every I2C write and read ("i2c", with the command opcode and size).
+ * @details Timestamps come from the virtual clock when one is given (simulated runs), otherwise from the host steady clock.
+ * @details Open the file in chrome://tracing or ui.perfetto.dev.
+ * @code
+ *   FILE *out = fopen("mode-switch.json", "w");
+ *   SI4735ChromeTrace trace(device, out, &clock);
+ *   SI4735 rx(trace, clock);
+ *
+ *   rx.setTracer(&trace);
+ *   rx.setup(0, POWER_UP_FM);
+ *   rx.setAM(520, 1710, 810, 10);
+ *   trace.finish();
+ *   fclose(out);
+ * @endcode
+ */
+class SI4735ChromeTrace : public I2C, public SI4735Tracer
+{
+  public:
+    SI4735ChromeTrace(I2C &target, FILE *out, SI4735VirtualClock *clock = NULL);
+    ~SI4735ChromeTrace();
+
+    void beginTransmission(int address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission();
+    uint8_t requestFrom(int address, int quantity);
+    int read();
+
+    void begin(const char *name, uint8_t kind, uint8_t cmd);
+    void end();
+    void finish();
+
+    /**
+     * @brief Events written so far.
+     */
+    inline uint32_t getEvents() { return events; }
+
+  protected:
+    I2C &target;
+    FILE *out;
+    SI4735VirtualClock *clock;
+    uint64_t start;         //!< Steady clock at construction (uS), when there is no virtual clock
+    uint32_t events = 0;
+    uint16_t depth = 0;     //!< Spans open
+    bool finished = false;
+
+    uint8_t writeCommand = 0; //!< First byte of the current write
+    uint8_t writeSize = 0;
+
+    uint64_t micros();
+    void event(char phase, const char *name, uint8_t kind, int cmd, int bytes);
+};
+
+#endif //SI4735_CPP_SI4735CHROMETRACE_H
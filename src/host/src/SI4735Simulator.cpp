@@ -0,0 +1,816 @@
+//
+// Simulated Si4735 / Si4732 device for host builds (tests and benchmarks without a radio).
+//
+
+#include "SI4735Simulator.h"
+
+// Default timing model (uS). CTS times follow the fixed delays the library used on real devices;
+// POWER_UP includes the crystal start up (Si4735 data sheet: 110 ms).
+static const SI4735SimTiming defaultTiming = {
+    300,                  // command
+    550,                  // property
+    110000,               // powerUp
+    2500,                 // powerDown
+    300,                  // patchLine
+    20000,                // tuneFm
+    30000,                // tuneAm
+    30000,                // tuneNbfm
+    20000,                // seekStep
+    87600,                // rdsGroup (1187.5 bps, 104 bits per group)
+    SIM_DEFAULT_BUS_SPEED, // busSpeed
+    SIM_MAX_BUS_SPEED      // maxBusSpeed
+};
+
+/**
+ * @brief Property values after POWER_UP (see AN332 property summaries).
+ */
+static uint16_t defaultProperty(uint16_t property)
+{
+    switch (property)
+    {
+    case FM_SEEK_BAND_BOTTOM:
+        return 8750;
+    case FM_SEEK_BAND_TOP:
+        return 10790;
+    case FM_SEEK_FREQ_SPACING:
+        return 10;
+    case FM_SEEK_TUNE_SNR_THRESHOLD:
+        return 3;
+    case FM_SEEK_TUNE_RSSI_THRESHOLD:
+        return 20;
+    case AM_SEEK_BAND_BOTTOM:
+        return 520;
+    case AM_SEEK_BAND_TOP:
+        return 1710;
+    case AM_SEEK_FREQ_SPACING:
+        return 10;
+    case AM_SEEK_SNR_THRESHOLD:
+        return 5;
+    case AM_SEEK_RSSI_THRESHOLD:
+        return 25;
+    case NBFM_VALID_SNR_THRESHOLD:
+        return 3;
+    case NBFM_VALID_RSSI_THRESHOLD:
+        return 20;
+    case RX_VOLUME:
+        return 63;
+    case REFCLK_FREQ:
+        return 32768;
+    case REFCLK_PRESCALE:
+        return 1;
+    }
+    return 0;
+}
+
+SI4735Simulator::SI4735Simulator(SI4735VirtualClock &clock, uint8_t address) : clock(clock), timing(defaultTiming), address(address)
+{
+    reset();
+}
+
+/**
+ * @brief Hardware reset (RST pin): the device goes to power down mode with default properties.
+ */
+void SI4735Simulator::reset()
+{
+    powered = patchMode = patchLoaded = false;
+    patchLines = 0;
+    ctsInterrupt = false;
+    error = false;
+    busyUntil = clock.micros();
+    propertyCount = 0;
+    frequency = antennaCap = 0;
+    stcPending = stcInt = seeking = seekLimit = false;
+    agcDisabled = agcIndex = 0;
+    rdsHead = rdsCount = 0;
+    rdsSent = 0;
+    rdsStart = clock.micros();
+    rdsSyncFound = rdsGroupLost = false;
+    failCount = 0;
+}
+
+/**
+ * @brief Adds a station to the synthetic band.
+ * @return false if the band plan is full.
+ */
+bool SI4735Simulator::addStation(const SI4735SimStation &station)
+{
+    if (stationCount >= SIM_MAX_STATIONS)
+        return false;
+    stations[stationCount++] = station;
+    return true;
+}
+
+/**
+ * @brief Makes the next commands with a given opcode fail (ERR bit set, no response).
+ * @param cmd command opcode
+ * @param times number of commands that will fail
+ */
+void SI4735Simulator::failNext(uint8_t cmd, uint8_t times)
+{
+    failCommand = cmd;
+    failCount = times;
+}
+
+/**
+ * @brief Current value of a property on the device side.
+ */
+uint16_t SI4735Simulator::getProperty(uint16_t property)
+{
+    for (uint8_t i = 0; i < propertyCount; i++)
+        if (propertyNumber[i] == property)
+            return propertyValue[i];
+    return defaultProperty(property);
+}
+
+void SI4735Simulator::setProperty(uint16_t property, uint16_t value)
+{
+    for (uint8_t i = 0; i < propertyCount; i++)
+    {
+        if (propertyNumber[i] == property)
+        {
+            propertyValue[i] = value;
+            return;
+        }
+    }
+    if (propertyCount >= SIM_MAX_PROPERTIES)
+    {
+        protocolErrors++;
+        return;
+    }
+    propertyNumber[propertyCount] = property;
+    propertyValue[propertyCount++] = value;
+}
+
+/**
+ * @brief Frequency the device is on. During a seek it is the channel being checked.
+ */
+uint16_t SI4735Simulator::getFrequency()
+{
+    if (!seeking || !stcPending || timing.seekStep == 0)
+        return frequency;
+
+    uint64_t start = stcTime - (uint64_t)seekChannels * timing.seekStep;
+    uint64_t visited = (clock.micros() - start) / timing.seekStep;
+    uint16_t freq = seekFrom;
+    bool limit;
+
+    for (uint64_t i = 0; i < visited && i < seekChannels; i++)
+        freq = nextChannel(freq, &limit);
+    return freq;
+}
+
+/**
+ * @brief Advances the device to the time of the virtual clock: ends tune and seek, fills the RDS FIFO.
+ */
+void SI4735Simulator::update()
+{
+    uint64_t now = clock.micros();
+    SI4735SimStation station;
+
+    if (stcPending && now >= stcTime)
+    {
+        stcPending = false;
+        stcInt = true;
+        if (seeking)
+        {
+            seeking = false;
+            frequency = seekTo;
+        }
+        rdsStart = stcTime;
+        rdsSent = 0;
+        rdsCount = 0;
+    }
+
+    if (!powered || mode != SIM_BAND_FM || stcPending || !(getProperty(FM_RDS_CONFIG) & 1) || timing.rdsGroup == 0 ||
+        !stationAt(frequency, &station) || station.pi == 0)
+    {
+        rdsStart = now;
+        rdsSent = 0;
+        rdsCount = 0;
+        return;
+    }
+
+    uint32_t due = (uint32_t)((now - rdsStart) / timing.rdsGroup);
+    if (due - rdsSent > SIM_RDS_FIFO_SIZE) // Nobody read the FIFO for a while
+    {
+        rdsGroupLost = true;
+        rdsCount = 0;
+        rdsSent = due - SIM_RDS_FIFO_SIZE;
+    }
+    while (rdsSent < due)
+    {
+        if (rdsCount == SIM_RDS_FIFO_SIZE)
+        {
+            rdsHead = (rdsHead + 1) % SIM_RDS_FIFO_SIZE;
+            rdsCount--;
+            rdsGroupLost = true;
+        }
+        makeRdsGroup(station, rdsSent, rdsFifo[(rdsHead + rdsCount) % SIM_RDS_FIFO_SIZE]);
+        rdsCount++;
+        if (rdsSent++ == 0)
+            rdsSyncFound = true;
+    }
+}
+
+/**
+ * @brief Builds the index-th group of the station: four 0A groups (program service name) then the 2A groups (radio text).
+ */
+void SI4735Simulator::makeRdsGroup(const SI4735SimStation &station, uint32_t index, uint16_t *block)
+{
+    char ps[8];
+    char rt[64];
+    uint8_t rtSegments = 0;
+    uint8_t segment;
+
+    memset(ps, ' ', sizeof(ps));
+    if (station.ps != NULL)
+        for (uint8_t i = 0; i < sizeof(ps) && station.ps[i] != '\0'; i++)
+            ps[i] = station.ps[i];
+
+    memset(rt, ' ', sizeof(rt));
+    if (station.rt != NULL)
+    {
+        uint8_t size = 0;
+        while (size < sizeof(rt) && station.rt[size] != '\0')
+        {
+            rt[size] = station.rt[size];
+            size++;
+        }
+        if (size < sizeof(rt))
+            rt[size++] = '\r'; // End of the radio text
+        rtSegments = (size + 3) / 4;
+    }
+
+    index %= 4 + rtSegments;
+    block[0] = station.pi;
+    if (index < 4)
+    {
+        segment = (uint8_t)index;
+        block[1] = (0 << 12) | (station.pty << 5) | (1 << 3) | segment; // Group 0A, music
+        block[2] = 0xE0CD;                                               // No alternative frequency, filler
+        block[3] = ((uint8_t)ps[segment * 2] << 8) | (uint8_t)ps[segment * 2 + 1];
+    }
+    else
+    {
+        segment = (uint8_t)(index - 4);
+        block[1] = (2 << 12) | (station.pty << 5) | segment; // Group 2A, text A/B flag 0
+        block[2] = ((uint8_t)rt[segment * 4] << 8) | (uint8_t)rt[segment * 4 + 1];
+        block[3] = ((uint8_t)rt[segment * 4 + 2] << 8) | (uint8_t)rt[segment * 4 + 3];
+    }
+}
+
+/**
+ * @brief Finds the station of the current band on a frequency.
+ * @details A manual antenna capacitor away from the resonance of the antenna lowers the RSSI and SNR (see antennaLoss).
+ * @return false if there is only noise.
+ */
+bool SI4735Simulator::stationAt(uint16_t freq, SI4735SimStation *station)
+{
+    uint8_t loss;
+
+    for (uint8_t i = 0; i < stationCount; i++)
+    {
+        if (stations[i].band == mode && stations[i].frequency == freq)
+        {
+            *station = stations[i];
+            loss = antennaLoss();
+            station->rssi = (station->rssi > SIM_NOISE_RSSI + loss) ? station->rssi - loss : SIM_NOISE_RSSI;
+            station->snr = (station->snr > loss) ? station->snr - loss : 0;
+            return true;
+        }
+    }
+    station->frequency = freq;
+    station->band = mode;
+    station->rssi = SIM_NOISE_RSSI;
+    station->snr = 0;
+    station->pi = 0;
+    station->pty = 0;
+    station->ps = station->rt = NULL;
+    return false;
+}
+
+/**
+ * @brief true if a frequency has a station above the seek (or valid channel) thresholds.
+ */
+bool SI4735Simulator::validChannel(uint16_t freq)
+{
+    SI4735SimStation station;
+
+    stationAt(freq, &station);
+    if (mode == SIM_BAND_FM)
+        return station.rssi >= getProperty(FM_SEEK_TUNE_RSSI_THRESHOLD) && station.snr >= getProperty(FM_SEEK_TUNE_SNR_THRESHOLD);
+    if (mode == SIM_BAND_AM)
+        return station.rssi >= getProperty(AM_SEEK_RSSI_THRESHOLD) && station.snr >= getProperty(AM_SEEK_SNR_THRESHOLD);
+    return station.rssi >= getProperty(NBFM_VALID_RSSI_THRESHOLD) && station.snr >= getProperty(NBFM_VALID_SNR_THRESHOLD);
+}
+
+/**
+ * @brief Antenna tuning capacitor reported by the tune status.
+ * @details In automatic mode the capacitor follows 1/f^2 (an LC circuit) in FM and MW. In SW it is always 1.
+ */
+uint16_t SI4735Simulator::antennaCapacitor()
+{
+    return (antennaCap != 0) ? antennaCap : resonance();
+}
+
+/**
+ * @brief Capacitor that tunes the antenna to the current frequency (the automatic value, 0 before the first tune).
+ */
+uint16_t SI4735Simulator::resonance()
+{
+    if (frequency == 0)
+        return 0;
+    if (mode == SIM_BAND_FM)
+        return (uint16_t)(3200000000UL / ((uint32_t)frequency * frequency));
+    if (mode == SIM_BAND_AM && frequency <= 1710)
+        return (uint16_t)(1500000000UL / ((uint32_t)frequency * frequency));
+    return 1;
+}
+
+/**
+ * @brief Signal loss (dB) of a manual antenna capacitor: 1 dB for each 3 % away from the automatic value, up to 40 dB.
+ * @details Only FM and MW use the capacitor.
+ */
+uint8_t SI4735Simulator::antennaLoss()
+{
+    uint16_t best = resonance();
+    uint32_t loss;
+
+    if (antennaCap == 0 || best == 0 || mode == SIM_BAND_NBFM || (mode == SIM_BAND_AM && frequency > 1710))
+        return 0;
+    loss = (uint32_t)((antennaCap > best) ? antennaCap - best : best - antennaCap) * 32 / best;
+    return (loss > 40) ? 40 : (uint8_t)loss;
+}
+
+/**
+ * @brief Next channel of a seek (seek band and spacing properties).
+ * @param limit set when the seek stops on the band limit (no wrap).
+ */
+uint16_t SI4735Simulator::nextChannel(uint16_t freq, bool *limit)
+{
+    uint16_t bottom = getProperty((mode == SIM_BAND_FM) ? FM_SEEK_BAND_BOTTOM : AM_SEEK_BAND_BOTTOM);
+    uint16_t top = getProperty((mode == SIM_BAND_FM) ? FM_SEEK_BAND_TOP : AM_SEEK_BAND_TOP);
+    uint16_t spacing = getProperty((mode == SIM_BAND_FM) ? FM_SEEK_FREQ_SPACING : AM_SEEK_FREQ_SPACING);
+    int32_t next = (int32_t)freq + (seekUp ? spacing : -spacing);
+
+    *limit = false;
+    if (next > top || next < bottom)
+    {
+        if (!seekWrap)
+        {
+            *limit = true;
+            return freq;
+        }
+        next = seekUp ? bottom : top;
+    }
+    return (uint16_t)next;
+}
+
+/**
+ * @brief FM_SEEK_START / AM_SEEK_START: finds the station now and reports it after the time spent on each channel.
+ */
+void SI4735Simulator::startSeek(uint8_t arg)
+{
+    uint16_t bottom = getProperty((mode == SIM_BAND_FM) ? FM_SEEK_BAND_BOTTOM : AM_SEEK_BAND_BOTTOM);
+    uint16_t top = getProperty((mode == SIM_BAND_FM) ? FM_SEEK_BAND_TOP : AM_SEEK_BAND_TOP);
+    uint16_t freq;
+    uint16_t channels = 0;
+
+    if (seeking && stcPending) // A new seek starts from the channel being checked
+        frequency = getFrequency();
+    seekUp = (arg & 0x08) != 0;
+    seekWrap = (arg & 0x04) != 0;
+    if (frequency < bottom || frequency > top)
+        frequency = bottom;
+    seekFrom = freq = frequency;
+    seekLimit = false;
+
+    for (;;)
+    {
+        freq = nextChannel(freq, &seekLimit);
+        if (seekLimit)
+            break;
+        channels++;
+        if (freq == seekFrom || channels > 4096) // Whole band checked: back to the start frequency
+        {
+            seekLimit = true;
+            break;
+        }
+        if (validChannel(freq))
+            break;
+    }
+
+    seekTo = freq;
+    seekChannels = channels;
+    seeking = true;
+    stcPending = true; // STCINT stays set until INTACK, as on the device
+    stcTime = clock.micros() + (uint64_t)((channels > 0) ? channels : 1) * timing.seekStep;
+}
+
+/**
+ * @brief Tune commands: the frequency changes now, STCINT goes up after the tune time.
+ */
+void SI4735Simulator::tune(uint16_t freq, uint16_t cap, uint32_t time)
+{
+    frequency = freq;
+    antennaCap = cap;
+    seeking = seekLimit = false;
+    stcPending = true; // STCINT stays set until INTACK, as on the device
+    stcTime = clock.micros() + time;
+}
+
+/**
+ * @brief FM/AM/NBFM_TUNE_STATUS response.
+ */
+void SI4735Simulator::tuneStatus(uint8_t arg)
+{
+    SI4735SimStation station;
+    uint16_t freq;
+    uint16_t cap;
+
+    if ((arg & 0x02) && seeking && stcPending) // CANCEL: stops on the channel being checked
+    {
+        seekTo = getFrequency();
+        seekLimit = false;
+        stcTime = clock.micros();
+        update();
+    }
+    if (arg & 0x01) // INTACK
+        stcInt = false;
+
+    freq = getFrequency();
+    stationAt(freq, &station);
+    cap = antennaCapacitor();
+    response[1] = ((seekLimit && !stcPending) ? 0x80 : 0) | (validChannel(freq) ? 0x01 : 0);
+    response[2] = freq >> 8;
+    response[3] = freq & 0xFF;
+    response[4] = station.rssi;
+    response[5] = station.snr;
+    if (mode == SIM_BAND_AM)
+    {
+        response[6] = cap >> 8;
+        response[7] = cap & 0xFF;
+    }
+    else
+    {
+        response[6] = 0; // MULT
+        response[7] = cap & 0xFF;
+    }
+    responseSize = 8;
+}
+
+/**
+ * @brief FM/AM/NBFM_RSQ_STATUS response.
+ */
+void SI4735Simulator::rsqStatus()
+{
+    SI4735SimStation station;
+    bool found = stationAt(getFrequency(), &station);
+
+    response[1] = 0;
+    response[2] = (validChannel(station.frequency) ? 0x01 : 0) | ((station.snr < 5) ? 0x08 : 0); // VALID, SMUTE
+    response[3] = (mode == SIM_BAND_FM && found && station.rssi >= 30) ? (0x80 | 100) : 0;      // PILOT, STBLEND
+    response[4] = station.rssi;
+    response[5] = station.snr;
+    response[6] = 0; // MULT
+    response[7] = 0; // FREQOFF
+    responseSize = 8;
+}
+
+/**
+ * @brief FM_RDS_STATUS response: reads (or only peeks with STATUSONLY) the oldest group of the FIFO.
+ */
+void SI4735Simulator::rdsStatus(uint8_t arg)
+{
+    uint16_t threshold = getProperty(FM_RDS_INT_FIFO_COUNT);
+
+    if (threshold == 0)
+        threshold = 1;
+    response[1] = ((rdsCount >= threshold) ? 0x01 : 0) | (rdsSyncFound ? 0x04 : 0);
+    response[2] = ((rdsSent > 0) ? 0x01 : 0) | (rdsGroupLost ? 0x04 : 0);
+    response[3] = rdsCount;
+    memset(response + 4, 0, 9);
+    if (rdsCount > 0)
+    {
+        uint16_t *block = rdsFifo[rdsHead];
+        response[1] |= 0x30; // New block A and B
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            response[4 + i * 2] = block[i] >> 8;
+            response[5 + i * 2] = block[i] & 0xFF;
+        }
+        if (!(arg & 0x04)) // STATUSONLY = 0 removes the group
+        {
+            rdsHead = (rdsHead + 1) % SIM_RDS_FIFO_SIZE;
+            rdsCount--;
+        }
+    }
+    if (arg & 0x02) // MTFIFO
+        rdsCount = 0;
+    if (arg & 0x01) // INTACK
+        rdsSyncFound = rdsGroupLost = false;
+    responseSize = 13;
+}
+
+/**
+ * @brief Runs the command written on the bus and schedules CTS.
+ */
+void SI4735Simulator::execute()
+{
+    uint8_t cmd = command[0];
+    uint8_t func = command[1] & 0x0F;
+    uint32_t latency = timing.command;
+    uint16_t freq = ((uint16_t)command[2] << 8) | command[3];
+    bool fm = (mode == SIM_BAND_FM);
+    bool am = (mode == SIM_BAND_AM);
+    bool nbfm = patchLoaded && (mode == SIM_BAND_FM || mode == SIM_BAND_NBFM);
+
+    commandCount++;
+    error = false;
+    responseSize = 1;
+
+    if (patchMode && cmd != PATCH_ARGS && cmd != PATCH_DATA) // The patch is complete
+    {
+        patchMode = false;
+        patchLoaded = (patchLines > 0);
+    }
+
+    if (overflow || (failCount > 0 && cmd == failCommand))
+    {
+        if (!overflow)
+            failCount--;
+        error = true;
+    }
+    else if (!powered && cmd != POWER_UP && cmd != GET_INT_STATUS)
+        error = true;
+    else
+    {
+        switch (cmd)
+        {
+        case POWER_UP:
+            if (func == 15) // Query library ID. The device is left powered down.
+            {
+                response[1] = partNumber;
+                response[2] = '6';
+                response[3] = '0';
+                response[4] = response[5] = 0;
+                response[6] = 'D';
+                response[7] = SIM_LIBRARY_ID;
+                responseSize = 8;
+                powered = false;
+                break;
+            }
+            if (!(powered && patchLoaded)) // Powering up again after a patch keeps it (setSSB, setNBFM)
+                patchLoaded = false;
+            patchMode = (command[1] & 0x20) != 0;
+            if (patchMode)
+                patchLines = 0;
+            powered = true;
+            mode = (func == POWER_UP_FM) ? SIM_BAND_FM : SIM_BAND_AM;
+            ctsInterrupt = (command[1] & 0xC0) == 0xC0; // CTSIEN and GPO2OEN
+            propertyCount = 0;
+            frequency = antennaCap = 0;
+            stcPending = stcInt = seeking = seekLimit = false;
+            agcDisabled = agcIndex = 0;
+            rdsCount = 0;
+            rdsSyncFound = rdsGroupLost = false;
+            latency = timing.powerUp;
+            break;
+        case POWER_DOWN:
+            powered = patchMode = patchLoaded = false;
+            stcPending = stcInt = seeking = false;
+            latency = timing.powerDown;
+            break;
+        case GET_REV:
+            response[1] = partNumber;
+            response[2] = '6';
+            response[3] = '0';
+            response[4] = response[5] = 0;
+            response[6] = '6';
+            response[7] = '0';
+            response[8] = 'D';
+            responseSize = 9;
+            break;
+        case SET_PROPERTY:
+            if (commandSize < 6)
+                error = true;
+            else
+                setProperty(((uint16_t)command[2] << 8) | command[3], ((uint16_t)command[4] << 8) | command[5]);
+            latency = timing.property;
+            break;
+        case GET_PROPERTY:
+        {
+            uint16_t value = getProperty(((uint16_t)command[2] << 8) | command[3]);
+            response[1] = 0;
+            response[2] = value >> 8;
+            response[3] = value & 0xFF;
+            responseSize = 4;
+            latency = timing.property;
+            break;
+        }
+        case GET_INT_STATUS:
+        case GPIO_CTL:
+        case GPIO_SET:
+            break;
+        case PATCH_ARGS:
+        case PATCH_DATA:
+            if (!patchMode)
+                error = true;
+            else
+                patchLines++;
+            latency = timing.patchLine;
+            break;
+        case FM_TUNE_FREQ:
+            if (!fm || freq < 6400 || freq > 10800)
+                error = true;
+            else
+                tune(freq, command[4], timing.tuneFm);
+            break;
+        case AM_TUNE_FREQ:
+            if (!am || freq < 149 || freq > 30000 || ((command[1] & 0xC0) && !patchLoaded)) // USBLSB needs the SSB patch
+                error = true;
+            else
+                tune(freq, ((uint16_t)command[4] << 8) | command[5], timing.tuneAm);
+            break;
+        case NBFM_TUNE_FREQ:
+            if (!nbfm)
+                error = true;
+            else
+            {
+                mode = SIM_BAND_NBFM;
+                tune(freq, 0, timing.tuneNbfm);
+            }
+            break;
+        case FM_SEEK_START:
+        case AM_SEEK_START:
+            if ((cmd == FM_SEEK_START) ? !fm : !am)
+                error = true;
+            else
+                startSeek(command[1]);
+            break;
+        case FM_TUNE_STATUS:
+        case AM_TUNE_STATUS:
+        case NBFM_TUNE_STATUS:
+            if ((cmd == FM_TUNE_STATUS && !fm) || (cmd == AM_TUNE_STATUS && !am) || (cmd == NBFM_TUNE_STATUS && !nbfm))
+                error = true;
+            else
+                tuneStatus(command[1]);
+            break;
+        case FM_RSQ_STATUS:
+        case AM_RSQ_STATUS:
+        case NBFM_RSQ_STATUS:
+            if ((cmd == FM_RSQ_STATUS && !fm) || (cmd == AM_RSQ_STATUS && !am) || (cmd == NBFM_RSQ_STATUS && !nbfm))
+                error = true;
+            else
+                rsqStatus();
+            break;
+        case FM_RDS_STATUS:
+            if (!fm)
+                error = true;
+            else
+                rdsStatus(command[1]);
+            break;
+        case FM_AGC_STATUS:
+        case AM_AGC_STATUS:
+        case NBFM_AGC_STATUS:
+        {
+            SI4735SimStation station;
+            uint8_t maxIndex = (mode == SIM_BAND_AM) ? 37 : 26;
+            stationAt(frequency, &station);
+            response[1] = agcDisabled;
+            response[2] = agcDisabled ? agcIndex : ((station.rssi / 3 < maxIndex) ? station.rssi / 3 : maxIndex);
+            responseSize = 3;
+            break;
+        }
+        case FM_AGC_OVERRIDE:
+        case AM_AGC_OVERRIDE:
+        case NBFM_AGC_OVERRIDE:
+            agcDisabled = command[1] & 0x01;
+            agcIndex = command[2];
+            break;
+        default:
+            error = true;
+        }
+    }
+
+    if (error)
+        responseSize = 1;
+    busyUntil = clock.micros() + latency;
+}
+
+/**
+ * @brief Time of a bus transfer: address byte plus data bytes, 9 bits each, plus start and stop.
+ */
+void SI4735Simulator::transfer(uint8_t bytes)
+{
+    if (timing.busSpeed == 0)
+        return;
+    uint64_t us = ((uint64_t)(bytes + 1) * 9 + 2) * 1000000 / timing.busSpeed;
+    busTime += us;
+    clock.advance(us);
+}
+
+/**
+ * @brief true if the bus runs faster than the device handles (timing maxBusSpeed).
+ */
+bool SI4735Simulator::overclocked()
+{
+    return timing.maxBusSpeed != 0 && timing.busSpeed > timing.maxBusSpeed;
+}
+
+uint8_t SI4735Simulator::status()
+{
+    uint8_t value = 0;
+    uint16_t threshold = getProperty(FM_RDS_INT_FIFO_COUNT);
+
+    if (clock.micros() >= busyUntil)
+        value |= 0x80; // CTS
+    if (error)
+        value |= 0x40; // ERR
+    if (rdsCount > 0 && rdsCount >= threshold)
+        value |= 0x04; // RDSINT
+    if (stcInt)
+        value |= 0x01; // STCINT
+    return value;
+}
+
+void SI4735Simulator::beginTransmission(int address)
+{
+    selected = (address == this->address);
+    commandSize = 0;
+    overflow = false;
+}
+
+size_t SI4735Simulator::write(uint8_t data)
+{
+    if (commandSize < sizeof(command))
+        command[commandSize++] = data;
+    else
+        overflow = true; // The Si47XX accepts up to 8 bytes per write
+    return 1;
+}
+
+size_t SI4735Simulator::write(const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        write(data[i]);
+    return size;
+}
+
+uint8_t SI4735Simulator::endTransmission()
+{
+    transfer(commandSize);
+    if (selected && overclocked())
+    {
+        selected = false;
+        busErrors++;
+    }
+    if (!selected)
+        return 2; // Address not acknowledged
+    selected = false;
+    if (commandSize == 0) // Address probe (getDeviceI2CAddress)
+        return 0;
+
+    update();
+    if (clock.micros() < busyUntil) // Written before CTS: ignored by the device
+    {
+        protocolErrors++;
+        return 0;
+    }
+    execute();
+    return 0;
+}
+
+uint8_t SI4735Simulator::requestFrom(int address, int quantity)
+{
+    bool ready;
+
+    readSize = readPosition = 0;
+    if (address != this->address || quantity <= 0)
+        return 0;
+    if (quantity > (int)sizeof(readBuffer))
+        quantity = sizeof(readBuffer);
+
+    transfer(quantity);
+    if (overclocked())
+    {
+        busErrors++;
+        memset(readBuffer, 0, quantity);
+        readSize = quantity;
+        return quantity;
+    }
+    update();
+    ready = clock.micros() >= busyUntil;
+    readBuffer[0] = status();
+    for (int i = 1; i < quantity; i++)
+        readBuffer[i] = (ready && i < responseSize) ? response[i] : 0;
+    readSize = quantity;
+    return quantity;
+}
+
+int SI4735Simulator::read()
+{
+    if (readPosition >= readSize)
+        return -1;
+    return readBuffer[readPosition++];
+}
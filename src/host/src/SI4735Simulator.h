@@ -0,0 +1,317 @@
+//
+// Simulated Si4735 / Si4732 device for host builds (tests and benchmarks without a radio).
+//
+
+#ifndef SI4735_CPP_SI4735SIMULATOR_H
+#define SI4735_CPP_SI4735SIMULATOR_H
+
+#include <si4735-cpp.h>
+
+#define SIM_BAND_FM 0   // Station on the FM band (frequency in 10 kHz units)
+#define SIM_BAND_AM 1   // Station on the AM/SW band (frequency in kHz). Also heard in SSB mode.
+#define SIM_BAND_NBFM 2 // Station heard with the NBFM patch
+
+#define SIM_MAX_STATIONS 64       // Stations of the synthetic band plan
+#define SIM_MAX_PROPERTIES 64     // Properties changed from their default value
+#define SIM_RDS_FIFO_SIZE 25      // Groups kept in the RDS FIFO (as the Si4735-D60)
+#define SIM_NOISE_RSSI 4          // RSSI (dBuV) reported where there is no station
+#define SIM_DEFAULT_BUS_SPEED 100000 // In Hz - I2C standard mode
+#define SIM_MAX_BUS_SPEED 400000     // In Hz - fastest I2C clock the simulated bus handles (fast mode)
+
+#define SIM_PART_NUMBER 35  // GET_REV PN: 35 = Si4735, 32 = Si4732
+#define SIM_LIBRARY_ID 0x0A // Library ID reported by POWER_UP with FUNC = 15
+
+/**
+ * @ingroup group05
+ *
+ * @brief Station of the synthetic band seen by SI4735Simulator
+ *
+ * @details Signal metrics are reported only on the exact frequency of the station, lower when a manual antenna capacitor is
+ * @details away from the resonance of the antenna (FM and MW). Stations with a PI code
+ * @details broadcast RDS: group 0A (program service name) and group 2A (radio text), one group every 87.6 ms.
+ */
+typedef struct
+{
+    uint16_t frequency; //!< Same unit as the tune commands of the band (10 kHz for FM, kHz for AM)
+    uint8_t band;       //!< SIM_BAND_FM, SIM_BAND_AM or SIM_BAND_NBFM
+    uint8_t rssi;       //!< dBuV
+    uint8_t snr;        //!< dB
+    uint16_t pi;        //!< RDS program identification (0 = no RDS)
+    uint8_t pty;        //!< RDS program type
+    const char *ps;     //!< RDS program service name (up to 8 characters) or NULL
+    const char *rt;     //!< RDS radio text (up to 64 characters) or NULL
+} SI4735SimStation;
+
+/**
+ * @ingroup group05
+ *
+ * @brief Timing model of SI4735Simulator (all times in uS)
+ *
+ * @details command, property, powerUp, powerDown and patchLine are the times from the end of the write to CTS.
+ * @details tune and seek complete (STCINT) after tuneFm/tuneAm/tuneNbfm, or seekStep for each channel visited.
+ * @details Every bus transfer also takes (bytes + 1) * 9 + 2 bit times at busSpeed.
+ * @details Above maxBusSpeed the transfers fail: writes are not acknowledged and reads return zeros (no CTS).
+ */
+typedef struct
+{
+    uint32_t command;   //!< Status queries, tune/seek start (CTS only), AGC, GPIO
+    uint32_t property;  //!< SET_PROPERTY and GET_PROPERTY
+    uint32_t powerUp;   //!< POWER_UP (crystal oscillator start up included)
+    uint32_t powerDown; //!< POWER_DOWN
+    uint32_t patchLine; //!< PATCH_ARGS and PATCH_DATA
+    uint32_t tuneFm;    //!< FM_TUNE_FREQ until STCINT
+    uint32_t tuneAm;    //!< AM_TUNE_FREQ (and SSB) until STCINT
+    uint32_t tuneNbfm;  //!< NBFM_TUNE_FREQ until STCINT
+    uint32_t seekStep;  //!< Time spent on each channel during a seek
+    uint32_t rdsGroup;  //!< Time between two RDS groups
+    uint32_t busSpeed;  //!< I2C clock in Hz (0 = transfers take no time)
+    uint32_t maxBusSpeed; //!< Fastest I2C clock that works, in Hz (0 = no limit)
+} SI4735SimTiming;
+
+/**
+ * @ingroup group05
+ *
+ * @brief Clock that only moves when someone waits on it.
+ *
+ * @details Lets the driver and SI4735Simulator run as fast as the host can while keeping the timing of a real device.
+ */
+class SI4735VirtualClock final : public Clock
+{
+  public:
+    void wait(unsigned long ms) { time += (uint64_t)ms * 1000; }
+    void waitMicroseconds(unsigned int us) { time += us; }
+    unsigned long now() { return (unsigned long)(time / 1000); }
+
+    /**
+     * @brief Current time in uS.
+     */
+    inline uint64_t micros() const { return time; }
+
+    /**
+     * @brief Moves the clock forward.
+     */
+    inline void advance(uint64_t us) { time += us; }
+
+  private:
+    uint64_t time = 0;
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief Cycle-approximate Si4735/Si4732 behind the I2C interface.
+ *
+ * @details Implements the command set used by SI4735Base: POWER_UP (normal, patch and library query), GET_REV, POWER_DOWN,
+ * @details SET/GET_PROPERTY, GET_INT_STATUS, patch download, tune, seek, tune status, RSQ, AGC (status and override),
+ * @details FM_RDS_STATUS and GPIO. CTS goes up after the time given by SI4735SimTiming and STCINT after the tune or seek time.
+ * @details Seek visits the channels of the band (seek band and spacing properties) and stops on the first station above the
+ * @details RSSI and SNR thresholds. Errors (ERR bit) are reported for unknown commands, out of range frequencies, commands sent
+ * @details while powered down, patch lines outside patch mode, SSB and NBFM commands without a patch, and on demand (failNext).
+ * @details Commands written before CTS are counted as protocol errors and ignored.
+ * @code
+ *   SI4735VirtualClock clock;
+ *   SI4735Simulator device(clock);
+ *   SI4735 rx(device, clock);
+ *
+ *   device.addStation({10390, SIM_BAND_FM, 45, 25, 0x1234, 10, "SIMULATE", "Radio text"});
+ *   rx.setup(0, POWER_UP_FM);
+ *   rx.setFM(8400, 10800, 10390, 10);
+ * @endcode
+ */
+class SI4735Simulator final : public I2C, public SI4735BusSpeed
+{
+  public:
+    SI4735Simulator(SI4735VirtualClock &clock, uint8_t address = SI473X_ADDR_SEN_LOW);
+
+    void beginTransmission(int address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission();
+    uint8_t requestFrom(int address, int quantity);
+    int read();
+
+    /**
+     * @brief Changes the I2C clock (timing busSpeed). See SI4735Base::setBusSpeedControl.
+     */
+    bool setSpeed(uint32_t hz)
+    {
+        timing.busSpeed = hz;
+        return true;
+    }
+
+    void reset();
+    bool addStation(const SI4735SimStation &station);
+    void failNext(uint8_t cmd, uint8_t times = 1);
+    uint16_t getProperty(uint16_t property);
+    uint16_t getFrequency();
+
+    /**
+     * @brief Removes every station of the band plan.
+     */
+    inline void clearStations() { stationCount = 0; }
+
+    /**
+     * @brief Timing model. Changes apply to the next command.
+     */
+    inline SI4735SimTiming &getTiming() { return timing; }
+
+    /**
+     * @brief Sets the GET_REV part number (SIM_PART_NUMBER = 35 for the Si4735, 32 for the Si4732).
+     */
+    inline void setPartNumber(uint8_t pn) { partNumber = pn; }
+
+    /**
+     * @brief Time (uS of the virtual clock) when CTS goes up.
+     */
+    inline uint64_t getReadyTime() { return busyUntil; }
+
+    /**
+     * @brief true if CTS interrupts were enabled at POWER_UP (CTSIEN and GPO2OEN).
+     */
+    inline bool isCtsInterruptEnabled() { return ctsInterrupt; }
+
+    /**
+     * @brief true if STCINT is set: a tune or seek completed and was not acknowledged (INTACK) yet.
+     */
+    inline bool isStcInterrupt()
+    {
+        update();
+        return stcInt;
+    }
+
+    inline bool isPowered() { return powered; }
+    inline bool isPatchLoaded() { return patchLoaded; }
+    inline uint16_t getPatchLines() { return patchLines; }
+    inline uint8_t getMode() { return mode; }
+    inline uint32_t getCommandCount() { return commandCount; }
+    inline uint32_t getProtocolErrors() { return protocolErrors; }
+    inline uint64_t getBusTime() { return busTime; }
+
+    /**
+     * @brief Transfers that failed because the bus ran above maxBusSpeed.
+     */
+    inline uint32_t getBusErrors() { return busErrors; }
+
+  protected:
+    SI4735VirtualClock &clock;
+    SI4735SimTiming timing;
+    uint8_t address;
+    uint8_t partNumber = SIM_PART_NUMBER;
+
+    SI4735SimStation stations[SIM_MAX_STATIONS];
+    uint8_t stationCount = 0;
+
+    uint16_t propertyNumber[SIM_MAX_PROPERTIES];
+    uint16_t propertyValue[SIM_MAX_PROPERTIES];
+    uint8_t propertyCount = 0;
+
+    // Bus
+    bool selected = false;      //!< Address of the current write matches
+    uint8_t command[8];         //!< Bytes of the current write
+    uint8_t commandSize = 0;
+    bool overflow = false;      //!< More than 8 bytes written
+    uint8_t response[16];       //!< Response of the last command (response[0] is replaced by the status)
+    uint8_t responseSize = 1;
+    uint8_t readBuffer[16];
+    uint8_t readSize = 0;
+    uint8_t readPosition = 0;
+    uint64_t busTime = 0;       //!< Time spent transferring bytes (uS)
+    uint32_t busErrors = 0;     //!< Transfers above maxBusSpeed
+
+    // Device
+    bool powered = false;
+    bool patchMode = false;     //!< Powered up with PATCH = 1; waiting for patch lines
+    bool patchLoaded = false;
+    uint16_t patchLines = 0;
+    bool ctsInterrupt = false;
+    uint8_t mode = SIM_BAND_FM;
+    bool error = false;         //!< ERR bit of the last command
+    uint64_t busyUntil = 0;     //!< CTS time
+    uint8_t failCommand = 0;
+    uint8_t failCount = 0;
+    uint32_t commandCount = 0;
+    uint32_t protocolErrors = 0;
+
+    // Tune and seek
+    uint16_t frequency = 0;
+    uint16_t antennaCap = 0;    //!< Manual capacitor (0 = automatic)
+    bool stcPending = false;    //!< Tune or seek in progress
+    bool stcInt = false;        //!< STCINT
+    uint64_t stcTime = 0;       //!< STCINT time
+    bool seeking = false;
+    uint16_t seekFrom = 0;
+    uint16_t seekTo = 0;
+    uint16_t seekChannels = 0;  //!< Channels to visit
+    bool seekUp = true;
+    bool seekWrap = true;
+    bool seekLimit = false;     //!< BLTF
+    uint8_t agcDisabled = 0;
+    uint8_t agcIndex = 0;
+
+    // RDS
+    uint16_t rdsFifo[SIM_RDS_FIFO_SIZE][4];
+    uint8_t rdsHead = 0;
+    uint8_t rdsCount = 0;
+    uint64_t rdsStart = 0;      //!< Time the current station started sending groups
+    uint32_t rdsSent = 0;       //!< Groups generated since rdsStart
+    bool rdsSyncFound = false;
+    bool rdsGroupLost = false;
+
+    void update();
+    void execute();
+    void transfer(uint8_t bytes);
+    bool overclocked();
+    uint8_t status();
+    bool stationAt(uint16_t freq, SI4735SimStation *station);
+    uint16_t antennaCapacitor();
+    uint16_t resonance();
+    uint8_t antennaLoss();
+    uint16_t nextChannel(uint16_t freq, bool *limit);
+    bool validChannel(uint16_t freq);
+    void tune(uint16_t freq, uint16_t cap, uint32_t time);
+    void startSeek(uint8_t arg);
+    void tuneStatus(uint8_t arg);
+    void rsqStatus();
+    void rdsStatus(uint8_t arg);
+    void makeRdsGroup(const SI4735SimStation &station, uint32_t index, uint16_t *block);
+    void setProperty(uint16_t property, uint16_t value);
+};
+
+/**
+ * @ingroup group05
+ *
+ * @brief GPO2/INT line of a SI4735Simulator.
+ *
+ * @details wait() moves the virtual clock to the moment CTS goes up (or to the timeout).
+ * @details The line works only if the device was powered up with CTSIEN and GPO2OEN.
+ * @code
+ *   SI4735SimulatorInterruptLine ctsLine(device, clock);
+ *   rx.setup(0, 1, POWER_UP_FM, SI473X_ANALOG_AUDIO, XOSCEN_CRYSTAL, 1);
+ *   rx.setInterruptLine(&ctsLine);
+ * @endcode
+ */
+class SI4735SimulatorInterruptLine : public SI4735InterruptLine
+{
+  public:
+    SI4735SimulatorInterruptLine(SI4735Simulator &device, SI4735VirtualClock &clock) : device(device), clock(clock) {}
+
+    bool wait(uint16_t timeout_us)
+    {
+        uint64_t ready = device.getReadyTime();
+
+        if (device.isCtsInterruptEnabled() && ready <= clock.micros() + timeout_us)
+        {
+            if (ready > clock.micros())
+                clock.advance(ready - clock.micros());
+            return true;
+        }
+        clock.advance(timeout_us);
+        return false;
+    }
+
+  private:
+    SI4735Simulator &device;
+    SI4735VirtualClock &clock;
+};
+
+#endif //SI4735_CPP_SI4735SIMULATOR_H
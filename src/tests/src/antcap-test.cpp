@@ -0,0 +1,193 @@
+//
+// Behavior tests of the antenna capacitor calibration and table (calibrateAntennaCapacitor, lookupAntennaCapacitor)
+// against SI4735Simulator, whose antenna resonates at 3.2e9 / f^2 on FM.
+//
+// Usage: si4735-antcap-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+#define TABLE_SIZE 8
+
+/**
+ * @brief SI4735 that shows the entry found by the last lookup.
+ */
+class AntCapReceiver : public SI4735
+{
+  public:
+    AntCapReceiver(I2C &i2c, Clock &clock) : SI4735(i2c, clock) {}
+
+    inline uint16_t getCachedEntry() { return antCapCached[antCapSlot()]; }
+};
+
+static uint16_t storedCount;
+
+static void storeTable(uint8_t, const si4735_antcap_entry *, uint16_t count)
+{
+    storedCount = count;
+}
+
+/**
+ * @brief Capacitor the device tuned with (FM tune status READANTCAP).
+ */
+template <class Radio>
+static uint8_t tunedCapacitor(Radio &radio)
+{
+    radio.rx.getStatus(0, 0);
+    return radio.rx.getStatusView().readAntCap();
+}
+
+/**
+ * @brief Segments that peak on the same capacitor share one entry; an entry of capacitor 0 closes the table.
+ */
+static bool testCalibrateMerge()
+{
+    SimRadio<AntCapReceiver> radio;
+    si4735_antcap_entry table[TABLE_SIZE];
+    bool ok = true;
+
+    // Segment centers: 100.5 and 101.5 MHz resonate at 31, 102.5 MHz at 30
+    radio.device.addStation({10050, SIM_BAND_FM, 40, 20, 0, 0, NULL, NULL});
+    radio.device.addStation({10150, SIM_BAND_FM, 40, 20, 0, 0, NULL, NULL});
+    radio.device.addStation({10250, SIM_BAND_FM, 40, 20, 0, 0, NULL, NULL});
+    radio.rx.setAntennaCapacitorStore(storeTable);
+    storedCount = 0;
+
+    EXPECT(radio.rx.calibrateAntennaCapacitor(10000, 10299, 100, table, TABLE_SIZE, 1, 20, 45) == 3);
+    EXPECT(table[0].frequency == 10000 && table[0].capacitor == 31);
+    EXPECT(table[0].rssi == 40 && table[0].snr == 20);
+    EXPECT(table[1].frequency == 10200 && table[1].capacitor == 30);
+    EXPECT(table[2].frequency == 10300 && table[2].capacitor == 0); // Terminator
+    EXPECT(storedCount == 3);
+
+    EXPECT(radio.rx.calibrateAntennaCapacitor(10000, 10299, 100, table, 1, 1, 20, 45) == 1); // No room for the terminator
+    EXPECT(radio.rx.calibrateAntennaCapacitor(10000, 10299, 0, table, TABLE_SIZE) == 0);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief The FAST bit, the capacitor in use and the listening frequency are the same after the calibration.
+ */
+static bool testCalibrateRestore()
+{
+    SimRadio<AntCapReceiver> radio;
+    si4735_antcap_entry table[TABLE_SIZE];
+    bool ok = true;
+
+    radio.device.addStation({10050, SIM_BAND_FM, 40, 20, 0, 0, NULL, NULL});
+    radio.rx.setTuneFrequencyFast(0);
+    radio.rx.setTuneFrequencyAntennaCapacitor(5); // Manual capacitor on 103.9 MHz
+    EXPECT(tunedCapacitor(radio) == 5);
+
+    EXPECT(radio.rx.calibrateAntennaCapacitor(10000, 10099, 100, table, TABLE_SIZE, 8, 1, 64) == 2);
+    EXPECT(table[0].capacitor == 31); // Coarse step 8, then refined in steps of 1
+    EXPECT(radio.rx.getTuneFrequecyFast() == 0);
+    EXPECT(radio.rx.getCurrentFrequency() == 10390);
+    EXPECT(radio.device.getFrequency() == 10390);
+    EXPECT(tunedCapacitor(radio) == 5); // After the terminator: the capacitor in use before
+    EXPECT(radio.rx.lookupAntennaCapacitor(9000) == 5);
+
+    radio.rx.setFrequency(10050);
+    EXPECT(tunedCapacitor(radio) == 31);
+    return ok;
+}
+
+/**
+ * @brief Linear search of the capacitor of freq (the reference for lookupAntennaCapacitor).
+ */
+static uint16_t referenceLookup(const si4735_antcap_entry *table, uint16_t count, uint16_t freq, uint16_t fallback)
+{
+    uint16_t capacitor = fallback;
+
+    for (uint16_t i = 0; i < count && table[i].frequency <= freq; i++)
+        capacitor = (table[i].capacitor != 0) ? table[i].capacitor : fallback;
+    return capacitor;
+}
+
+/**
+ * @brief Lookups match a linear search: below table[0], on an uncalibrated entry and after the terminator the fallback
+ * @brief (the capacitor in use when the table was attached) is returned.
+ */
+static bool testLookupTable()
+{
+    SimRadio<AntCapReceiver> radio;
+    static const si4735_antcap_entry table[5] = {
+        {8800, 40, 0, 0}, {9000, 0, 0, 0}, {9500, 35, 0, 0}, {10000, 32, 0, 0}, {10700, 0, 0, 0}};
+    uint16_t freq;
+    bool ok = true;
+
+    EXPECT(radio.rx.lookupAntennaCapacitor(9600) == 0); // No table: automatic
+    radio.rx.setTuneFrequencyAntennaCapacitor(7);
+    radio.rx.setAntennaCapacitorTable(table, 5);
+
+    EXPECT(radio.rx.lookupAntennaCapacitor(8750) == 7); // Below table[0]
+    EXPECT(radio.rx.lookupAntennaCapacitor(8800) == 40);
+    EXPECT(radio.rx.lookupAntennaCapacitor(9200) == 7);  // Capacitor 0: not calibrated
+    EXPECT(radio.rx.lookupAntennaCapacitor(10800) == 7); // After the terminator
+    for (freq = 8750; freq <= 10800; freq += 10)
+        EXPECT(radio.rx.lookupAntennaCapacitor(freq) == referenceLookup(table, 5, freq, 7));
+    for (freq = 10800; freq >= 8750; freq -= 70)
+        EXPECT(radio.rx.lookupAntennaCapacitor(freq) == referenceLookup(table, 5, freq, 7));
+
+    radio.rx.setFrequency(9600);
+    EXPECT(tunedCapacitor(radio) == 35);
+    radio.rx.setAntennaCapacitorTable(NULL, 0); // Detached: back to the fallback
+    EXPECT(radio.rx.lookupAntennaCapacitor(9600) == 7);
+    return ok;
+}
+
+/**
+ * @brief A lookup in the segment of the last one hits the cached entry; another segment is searched and cached.
+ */
+static bool testLookupCache()
+{
+    SimRadio<AntCapReceiver> radio;
+    static const si4735_antcap_entry table[4] = {{8800, 40, 0, 0}, {9500, 35, 0, 0}, {10000, 32, 0, 0}, {10700, 0, 0, 0}};
+    bool ok = true;
+
+    radio.rx.setAntennaCapacitorTable(table, 4);
+    EXPECT(radio.rx.getCachedEntry() == 0);
+    EXPECT(radio.rx.lookupAntennaCapacitor(9600) == 35);
+    EXPECT(radio.rx.getCachedEntry() == 1);
+    EXPECT(radio.rx.lookupAntennaCapacitor(9990) == 35); // Same segment: cached
+    EXPECT(radio.rx.getCachedEntry() == 1);
+    EXPECT(radio.rx.lookupAntennaCapacitor(10000) == 32); // Next segment: searched
+    EXPECT(radio.rx.getCachedEntry() == 2);
+    EXPECT(radio.rx.lookupAntennaCapacitor(8800) == 40);
+    EXPECT(radio.rx.getCachedEntry() == 0);
+    EXPECT(radio.rx.lookupAntennaCapacitor(8750) == 0); // Below table[0]: the cache is kept
+    EXPECT(radio.rx.getCachedEntry() == 0);
+    return ok;
+}
+
+/**
+ * @brief scanBand tunes each channel with the capacitor of the table.
+ */
+static bool testScanTable()
+{
+    SimRadio<AntCapReceiver> radio;
+    static const si4735_antcap_entry table[3] = {{9500, 35, 0, 0}, {10000, 32, 0, 0}, {10700, 0, 0, 0}};
+    si47x_scan_record band[2];
+    bool ok = true;
+
+    radio.rx.setAntennaCapacitorTable(table, 3);
+    radio.rx.setFrequency(10390);
+    EXPECT(tunedCapacitor(radio) == 32);
+    EXPECT(radio.rx.scanBand(9600, 9610, 10, band, 2) == 2);
+    EXPECT(tunedCapacitor(radio) == 35);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"calibrate-merge", testCalibrateMerge},
+        {"calibrate-restore", testCalibrateRestore},
+        {"lookup-table", testLookupTable},
+        {"lookup-cache", testLookupCache},
+        {"scan-table", testScanTable},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,195 @@
+//
+// Behavior tests of the I2C speed control (setBusSpeedControl, probeBusSpeed and the bulk transfers) against
+// SI4735Simulator, which fails the transfers above 400 kHz.
+//
+// Usage: si4735-busspeed-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+#define PROGMEM
+typedef uint8_t byte;
+#include <patch_init.h>
+
+#define MAX_SPEEDS 64 // Speed changes kept by a test
+
+/**
+ * @brief Bus speed control that keeps the speeds asked, can refuse one, and passes the others on to the simulator.
+ */
+class RecordingBusSpeed : public SI4735BusSpeed
+{
+  public:
+    uint32_t speeds[MAX_SPEEDS];
+    uint8_t count = 0;
+    uint32_t refused = 0; //!< Speed the transport cannot run at (0 = none)
+
+    explicit RecordingBusSpeed(SI4735BusSpeed &target) : target(target) {}
+
+    bool setSpeed(uint32_t hz)
+    {
+        if (count < MAX_SPEEDS)
+            speeds[count] = hz;
+        count++;
+        return hz != refused && target.setSpeed(hz);
+    }
+
+    inline uint32_t last() { return (count > 0) ? speeds[count - 1] : 0; }
+    inline void clear() { count = 0; }
+
+    /**
+     * @brief true if hz was asked since the last clear.
+     */
+    bool asked(uint32_t hz)
+    {
+        for (uint8_t i = 0; i < count && i < MAX_SPEEDS; i++)
+            if (speeds[i] == hz)
+                return true;
+        return false;
+    }
+
+  private:
+    SI4735BusSpeed &target;
+};
+
+/**
+ * @brief SI4735 that shows the CTS timeout.
+ */
+class BusReceiver : public SI4735
+{
+  public:
+    BusReceiver(I2C &i2c, Clock &clock) : SI4735(i2c, clock) {}
+
+    inline uint16_t getCtsTimeout() { return ctsTimeout; }
+};
+
+/**
+ * @brief The normal speed is applied when the control is set and when the speeds change; without a control nothing is.
+ */
+static bool testSpeedControl()
+{
+    SimRadio<> radio;
+    RecordingBusSpeed control(radio.device);
+    bool ok = true;
+
+    radio.rx.setI2CFastMode(); // No control yet
+    EXPECT(radio.rx.getBusSpeed() == 0);
+
+    radio.rx.setBusSpeedControl(&control);
+    EXPECT(control.count == 1 && control.last() == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getBulkBusSpeed() == I2C_SPEED_FAST);
+    EXPECT(radio.device.getTiming().busSpeed == I2C_SPEED_STANDARD);
+
+    radio.rx.setI2CStandardMode(); // Already at that speed
+    EXPECT(control.count == 1);
+    radio.rx.setI2CLowSpeedMode();
+    EXPECT(control.last() == I2C_SPEED_LOW && radio.rx.getBusSpeed() == I2C_SPEED_LOW);
+    EXPECT(radio.rx.getBulkBusSpeed() == I2C_SPEED_FAST);
+
+    control.refused = I2C_SPEED_FAST;
+    radio.rx.setI2CFastMode(); // The transport refuses it: the speed in use is kept
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_LOW);
+    radio.rx.setFrequency(9810);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    EXPECT(radio.device.getBusErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief The patch download runs at the bulk speed, and the speed in use before is restored.
+ */
+static bool testBulkRestore()
+{
+    SimRadio<> radio;
+    RecordingBusSpeed control(radio.device);
+    bool ok = true;
+
+    radio.rx.setBusSpeedControl(&control);
+    control.clear();
+    radio.rx.loadPatch(ssb_patch_content, sizeof ssb_patch_content, 2);
+    EXPECT(radio.device.getPatchLines() == sizeof ssb_patch_content / 8);
+    EXPECT(control.count == 2);
+    EXPECT(control.speeds[0] == I2C_SPEED_FAST && control.speeds[1] == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_STANDARD);
+
+    radio.rx.setBusSpeeds(I2C_SPEED_LOW, I2C_SPEED_FAST);
+    control.refused = I2C_SPEED_FAST; // No bulk speed: the download runs at the normal speed
+    control.clear();
+    radio.rx.loadPatch(ssb_patch_content, sizeof ssb_patch_content, 2);
+    EXPECT(radio.device.getPatchLines() == sizeof ssb_patch_content / 8);
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_LOW);
+    EXPECT(radio.device.getTiming().busSpeed == I2C_SPEED_LOW);
+    EXPECT(radio.device.getBusErrors() == 0);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief drainRdsFifo reads the FIFO at the bulk speed and restores the normal speed.
+ */
+static bool testDrainRds()
+{
+    SimRadio<> radio;
+    RecordingBusSpeed control(radio.device);
+    bool ok = true;
+
+    radio.rx.setBusSpeedControl(&control);
+    radio.rx.setRdsConfig(1, 2, 2, 2, 2);
+    radio.clock.wait(400); // A few groups in the FIFO
+    control.clear();
+    EXPECT(radio.rx.drainRdsFifo() > 0);
+    EXPECT(control.count == 2);
+    EXPECT(control.speeds[0] == I2C_SPEED_FAST && control.speeds[1] == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_STANDARD);
+    EXPECT(radio.device.getBusErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief probeBusSpeed falls back to the fastest speed that works, or returns 0 when none does; the normal speed and
+ * @brief the CTS timeout are restored either way.
+ */
+static bool testProbe()
+{
+    SimRadio<BusReceiver> radio;
+    RecordingBusSpeed control(radio.device);
+    static const uint32_t speeds[] = {1000000, 800000, 400000, 100000};
+    static const uint32_t tooFast[] = {1000000, 800000};
+    uint16_t timeout = radio.rx.getCtsTimeout();
+    bool ok = true;
+
+    EXPECT(radio.rx.probeBusSpeed(speeds, 4) == 0); // No control
+    radio.rx.setBusSpeedControl(&control, I2C_SPEED_STANDARD, I2C_SPEED_STANDARD);
+
+    control.clear();
+    control.refused = 1000000; // The transport cannot run at 1 MHz: not tried on the bus
+    EXPECT(radio.rx.probeBusSpeed(speeds, 4) == 400000);
+    EXPECT(control.asked(1000000) && control.asked(800000));
+    EXPECT(radio.rx.getBulkBusSpeed() == 400000);
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_STANDARD);
+    EXPECT(radio.device.getTiming().busSpeed == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getCtsTimeout() == timeout);
+    EXPECT(radio.device.getBusErrors() > 0); // 800 kHz failed on the bus
+
+    EXPECT(radio.rx.probeBusSpeed(tooFast, 2) == 0);
+    EXPECT(radio.rx.getBulkBusSpeed() == 400000); // Unchanged
+    EXPECT(radio.rx.getBusSpeed() == I2C_SPEED_STANDARD);
+    EXPECT(radio.rx.getCtsTimeout() == timeout);
+
+    radio.rx.setFrequency(9810); // The device still answers at the normal speed
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    EXPECT(radio.device.getFrequency() == 9810);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"speed-control", testSpeedControl},
+        {"bulk-restore", testBulkRestore},
+        {"drain-rds", testDrainRds},
+        {"probe", testProbe},
+    };
+
+    return runTests(argc, argv, tests);
+}
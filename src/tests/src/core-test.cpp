@@ -0,0 +1,106 @@
+//
+// Behavior tests of SI4735Core (si4735-core.h) against SI4735Simulator.
+//
+// Usage: si4735-core-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <si4735-core.h>
+
+typedef SI4735Core<SI4735Simulator, SI4735VirtualClock> Core;
+
+/**
+ * @brief Simulator with the stations of SimRadio and a powered up SI4735Core.
+ */
+struct CoreRadio
+{
+    SI4735VirtualClock clock;
+    SI4735Simulator device;
+    Core rx;
+
+    explicit CoreRadio(uint8_t func) : device(clock), rx(device, clock)
+    {
+        device.addStation({9810, SIM_BAND_FM, 38, 18, 0, 0, NULL, NULL});
+        device.addStation({10390, SIM_BAND_FM, 45, 25, 0x1234, 10, "SI4735", "Test station"});
+        device.addStation({810, SIM_BAND_AM, 50, 20, 0, 0, NULL, NULL});
+        device.addStation({9600, SIM_BAND_AM, 40, 15, 0, 0, NULL, NULL});
+        rx.radioPowerUp(func);
+    }
+};
+
+/**
+ * @brief Tune, RSQ and properties go through the shared protocol engine without protocol errors.
+ */
+static bool testCoreTune()
+{
+    CoreRadio radio(POWER_UP_FM);
+    uint16_t value = 0;
+    bool ok = true;
+
+    radio.rx.setFrequency(9810);
+    EXPECT(radio.device.getFrequency() == 9810);
+    radio.rx.getStatus(1, 0);
+    EXPECT(radio.rx.getFrequency() == 9810);
+    EXPECT(radio.rx.getStatusValid());
+
+    radio.rx.getCurrentReceivedSignalQuality();
+    EXPECT(radio.rx.getCurrentRSSI() == 38);
+
+    radio.rx.setProperty(RX_VOLUME, 20);
+    EXPECT(radio.rx.getProperty(RX_VOLUME, &value));
+    EXPECT(value == 20);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief FM seek stops on the next station; the tune prediction is calibrated like SI4735Base.
+ */
+static bool testCoreSeek()
+{
+    CoreRadio radio(POWER_UP_FM);
+    bool ok = true;
+
+    radio.rx.setFrequency(9810);
+    radio.rx.getStatus(1, 0);
+    radio.rx.seekStation(1, 1);
+    EXPECT(radio.rx.getFrequency() == 10390);
+    EXPECT(radio.device.getFrequency() == 10390);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief AM seek sends the AM seek arguments (five bytes, ANTCAPL on SW) and finds the station.
+ */
+static bool testCoreAmSeek()
+{
+    CoreRadio radio(POWER_UP_AM);
+    uint16_t bottom = 0;
+    bool ok = true;
+
+    radio.rx.setProperty(AM_SEEK_BAND_BOTTOM, 9000);
+    radio.rx.setProperty(AM_SEEK_BAND_TOP, 10000);
+    radio.rx.setProperty(AM_SEEK_FREQ_SPACING, 5);
+    EXPECT(radio.rx.getProperty(AM_SEEK_BAND_BOTTOM, &bottom) && bottom == 9000);
+
+    radio.rx.setFrequency(9400);
+    radio.rx.getStatus(1, 0);
+    radio.rx.seekStation(1, 1);
+    EXPECT(radio.rx.getFrequency() == 9600);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"core-tune", testCoreTune},
+        {"core-seek", testCoreSeek},
+        {"core-am-seek", testCoreAmSeek},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,137 @@
+//
+// Behavior tests of the C++20 coroutine facade (si4735-coro.h) against SI4735Simulator.
+//
+// Usage: si4735-coro-tests <case>   (see the table in main, or all)
+//
+
+#include <stdexcept>
+
+#include "test-support.h"
+#include <si4735-coro.h>
+
+static SI4735Task tuneTo(SI4735Scheduler &sched, SI4735 &rx, uint16_t freq, uint8_t *result)
+{
+    *result = co_await sched.tune(rx, freq);
+}
+
+static SI4735Task tuneAndFail(SI4735Scheduler &sched, SI4735 &rx, uint16_t freq)
+{
+    co_await sched.tune(rx, freq);
+    throw std::runtime_error("station not found");
+}
+
+static SI4735Task catchSubroutine(SI4735Scheduler &sched, SI4735 &rx, bool *caught, uint8_t *result)
+{
+    try
+    {
+        co_await tuneAndFail(sched, rx, 9810);
+    }
+    catch (const std::runtime_error &)
+    {
+        *caught = true;
+    }
+    *result = co_await sched.tune(rx, 10390);
+}
+
+/**
+ * @brief Two tasks tune two receivers on one scheduler.
+ */
+static bool testCoroTune()
+{
+    SimRadio<> a;
+    SimRadio<> b;
+    SI4735Scheduler sched(a.clock);
+    uint8_t resultA = ASYNC_BUSY;
+    uint8_t resultB = ASYNC_BUSY;
+    bool ok = true;
+
+    EXPECT(sched.spawn(tuneTo(sched, a.rx, 9810, &resultA)));
+    EXPECT(sched.spawn(tuneTo(sched, b.rx, 9810, &resultB)));
+    while (sched.pending() > 0)
+    {
+        if (!sched.step())
+        {
+            a.clock.advance(SI4735_CORO_IDLE);
+            b.clock.advance(SI4735_CORO_IDLE);
+        }
+    }
+    EXPECT(resultA == ASYNC_DONE);
+    EXPECT(resultB == ASYNC_DONE);
+    EXPECT(a.device.getFrequency() == 9810);
+    EXPECT(b.device.getFrequency() == 9810);
+    return ok;
+}
+
+/**
+ * @brief An exception that leaves a subroutine is rethrown by co_await in the caller, which can go on.
+ */
+static bool testSubroutineException()
+{
+    SimRadio<> radio;
+    SI4735Scheduler sched(radio.clock);
+    bool caught = false;
+    uint8_t result = ASYNC_BUSY;
+    bool ok = true;
+
+    EXPECT(sched.spawn(catchSubroutine(sched, radio.rx, &caught, &result)));
+    sched.run();
+    EXPECT(caught);
+    EXPECT(result == ASYNC_DONE);
+    EXPECT(radio.device.getFrequency() == 10390);
+    return ok;
+}
+
+/**
+ * @brief An exception that ends a top-level task is rethrown by run(); the other tasks still run afterwards.
+ */
+static bool testTaskException()
+{
+    SimRadio<> a;
+    SimRadio<> b;
+    SI4735Scheduler sched(a.clock);
+    uint8_t result = ASYNC_BUSY;
+    bool caught = false;
+    bool ok = true;
+
+    b.device.getTiming().tuneFm *= 20; // b finishes after a
+    EXPECT(sched.spawn(tuneAndFail(sched, a.rx, 9810)));
+    EXPECT(sched.spawn(tuneTo(sched, b.rx, 9810, &result)));
+    try
+    {
+        while (sched.pending() > 0)
+        {
+            if (!sched.step())
+            {
+                a.clock.advance(SI4735_CORO_IDLE);
+                b.clock.advance(SI4735_CORO_IDLE);
+            }
+        }
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+    EXPECT(caught);
+    EXPECT(a.device.getFrequency() == 9810);
+    EXPECT(sched.pending() == 1);
+    EXPECT(result == ASYNC_BUSY);
+
+    while (sched.pending() > 0)
+    {
+        if (!sched.step())
+            b.clock.advance(SI4735_CORO_IDLE);
+    }
+    EXPECT(result == ASYNC_DONE);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"coro-tune", testCoroTune},
+        {"subroutine-exception", testSubroutineException},
+        {"task-exception", testTaskException},
+    };
+
+    return runTests(argc, argv, tests);
+}
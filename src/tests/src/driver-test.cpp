@@ -0,0 +1,338 @@
+//
+// Behavior tests of SI4735Base against SI4735Simulator.
+//
+// Usage: si4735-driver-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+/**
+ * @brief A value the device rejects (ERR) is not cached: the next write of the same value goes to the device again.
+ */
+static bool testPropertyRejected()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.rx.setVolume(40);
+    radio.device.failNext(SET_PROPERTY);
+    radio.rx.setVolume(20);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_DEVICE);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 40);
+
+    uint32_t commands = radio.device.getCommandCount();
+    radio.rx.setVolume(20); // Not elided
+    EXPECT(radio.device.getCommandCount() == commands + 1);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 20);
+    EXPECT(radio.rx.getProperty(RX_VOLUME) == 20);
+    return ok;
+}
+
+/**
+ * @brief After a rejected write, getProperty asks the device instead of answering from the cache.
+ */
+static bool testPropertyRejectedRead()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.rx.setVolume(40);
+    radio.device.failNext(SET_PROPERTY);
+    radio.rx.setVolume(20);
+
+    uint32_t misses = radio.rx.getPropertyCacheMisses();
+    EXPECT(radio.rx.getProperty(RX_VOLUME) == 40);
+    EXPECT(radio.rx.getPropertyCacheMisses() == misses + 1);
+    return ok;
+}
+
+/**
+ * @brief An accepted value is cached: writing it again costs no command.
+ */
+static bool testPropertyAccepted()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.rx.setVolume(33);
+    uint32_t commands = radio.device.getCommandCount();
+    radio.rx.setVolume(33);
+    EXPECT(radio.device.getCommandCount() == commands);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    return ok;
+}
+
+/**
+ * @brief A SET_PROPERTY sent with sendCommand drops the cached value: setting the old value again reaches the device.
+ */
+static bool testPropertyRawWrite()
+{
+    SimRadio<> radio;
+    uint8_t args[5] = {0, 0x40, 0x00, 0x00, 0x3F}; // RX_VOLUME = 63
+    uint8_t status[1];
+    bool ok = true;
+
+    radio.rx.setVolume(40);
+    radio.rx.sendCommand<SET_PROPERTY>(args);
+    radio.rx.getCommandResponse(1, status);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 63);
+    radio.rx.setVolume(40);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 40);
+
+    EXPECT(radio.rx.transact<SET_PROPERTY>(args, status));
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 63);
+    radio.rx.setVolume(40);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 40);
+    return ok;
+}
+
+/**
+ * @brief beginSetProperty caches the value only when poll() sees the device accept it.
+ */
+static bool testAsyncPropertyRejected()
+{
+    SimRadio<> radio;
+    bool ok = true;
+    uint8_t state;
+
+    radio.rx.setVolume(40);
+    radio.device.failNext(SET_PROPERTY);
+    EXPECT(radio.rx.beginSetProperty(RX_VOLUME, 20));
+    while ((state = radio.rx.poll()) == ASYNC_BUSY)
+        radio.clock.advance(100);
+    EXPECT(state == ASYNC_ERROR);
+
+    uint32_t commands = radio.device.getCommandCount();
+    radio.rx.setVolume(20);
+    EXPECT(radio.device.getCommandCount() == commands + 1);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 20);
+
+    EXPECT(radio.rx.beginSetProperty(RX_VOLUME, 25));
+    while ((state = radio.rx.poll()) == ASYNC_BUSY)
+        radio.clock.advance(100);
+    EXPECT(state == ASYNC_DONE);
+    commands = radio.device.getCommandCount();
+    EXPECT(radio.rx.getProperty(RX_VOLUME) == 25);
+    EXPECT(radio.device.getCommandCount() == commands);
+    return ok;
+}
+
+/**
+ * @brief setAM and setFM restore the volume and AVC gain of the instance; setFM disables the FM debug feature.
+ */
+static bool testModeProperties()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.rx.setVolume(50);
+    radio.rx.setAvcAmMaxGain(60);
+    radio.rx.setAM(520, 1710, 810, 10);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 50);
+    EXPECT(radio.device.getProperty(AM_AUTOMATIC_VOLUME_CONTROL_MAX_GAIN) == 60 * 340);
+
+    radio.rx.setFM(8750, 10800, 10390, 10);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 50);
+    EXPECT(radio.device.getProperty(FM_DEBUG_CONTROL) == 0);
+    return ok;
+}
+
+/**
+ * @brief Runs poll() until the async command ends, advancing the clock 100 uS per call.
+ */
+template <class Radio>
+static uint8_t pollUntilDone(Radio &radio)
+{
+    uint8_t state;
+
+    while ((state = radio.rx.poll()) == ASYNC_BUSY)
+        radio.clock.advance(100);
+    return state;
+}
+
+/**
+ * @brief An async tune ends with ASYNC_DONE and the tuned frequency, and the next poll() keeps returning the result.
+ */
+static bool testAsyncTune()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    EXPECT(radio.rx.beginTune(9810));
+    EXPECT(!radio.rx.beginTune(10390)); // One command at a time
+    EXPECT(pollUntilDone(radio) == ASYNC_DONE);
+    EXPECT(radio.rx.getAsyncOperation() == ASYNC_OP_TUNE);
+    EXPECT(radio.rx.getCurrentFrequency() == 9810);
+    EXPECT(radio.device.getFrequency() == 9810);
+
+    uint32_t commands = radio.device.getCommandCount();
+    EXPECT(radio.rx.poll() == ASYNC_DONE);
+    EXPECT(radio.device.getCommandCount() == commands);
+    return ok;
+}
+
+/**
+ * @brief A tune the device rejects (ERR) ends with ASYNC_ERROR and SI4735_ERR_DEVICE.
+ */
+static bool testAsyncError()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.device.failNext(FM_TUNE_FREQ);
+    EXPECT(radio.rx.beginTune(9810));
+    EXPECT(pollUntilDone(radio) == ASYNC_ERROR);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_DEVICE);
+    EXPECT(radio.device.getFrequency() == 10390);
+
+    EXPECT(radio.rx.beginTune(9810)); // The next command runs normally
+    EXPECT(pollUntilDone(radio) == ASYNC_DONE);
+    EXPECT(radio.device.getFrequency() == 9810);
+    return ok;
+}
+
+/**
+ * @brief A tune that does not complete within MAX_ASYNC_TIME ends with ASYNC_ERROR and SI4735_ERR_TIMEOUT.
+ */
+static bool testAsyncTimeout()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.device.getTiming().tuneFm = (MAX_ASYNC_TIME + 500) * 1000;
+    uint64_t start = radio.clock.micros();
+    EXPECT(radio.rx.beginTune(9810));
+    EXPECT(pollUntilDone(radio) == ASYNC_ERROR);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_TIMEOUT);
+    EXPECT(radio.clock.micros() - start < (uint64_t)(MAX_ASYNC_TIME + 500) * 1000); // Before the device is done
+    return ok;
+}
+
+/**
+ * @brief cancelAsync stops a seek in progress: poll() returns ASYNC_CANCELLED on the channel where the device stopped.
+ */
+static bool testAsyncCancel()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    EXPECT(!radio.rx.cancelAsync()); // Nothing in flight
+    EXPECT(radio.rx.beginSeek(1));
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT(radio.rx.poll() == ASYNC_BUSY);
+        radio.clock.advance(1000);
+    }
+    EXPECT(radio.rx.cancelAsync());
+    EXPECT(pollUntilDone(radio) == ASYNC_CANCELLED);
+    EXPECT(radio.rx.getCurrentFrequency() == radio.device.getFrequency());
+    EXPECT(radio.device.getFrequency() != 10390);
+    EXPECT(radio.device.getFrequency() != 9810);
+
+    EXPECT(radio.rx.beginTune(9810)); // Ready for the next command
+    EXPECT(pollUntilDone(radio) == ASYNC_DONE);
+    EXPECT(!radio.rx.cancelAsync()); // Only seeks can be cancelled
+    return ok;
+}
+
+/**
+ * @brief getLastError reports an error until the next command succeeds, blocking or async.
+ */
+static bool testLastErrorCleared()
+{
+    SimRadio<> radio;
+    bool ok = true;
+
+    radio.device.failNext(FM_TUNE_FREQ);
+    EXPECT(radio.rx.beginTune(9810));
+    EXPECT(pollUntilDone(radio) == ASYNC_ERROR);
+    EXPECT(radio.rx.beginTune(9810));
+    EXPECT(pollUntilDone(radio) == ASYNC_DONE);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+
+    radio.device.failNext(SET_PROPERTY);
+    radio.rx.setVolume(20);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_DEVICE);
+    radio.rx.setFrequency(10390);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+
+    radio.rx.setRetryPolicy(0, 5);
+    radio.device.getTiming().property = 50000; // Longer than the CTS deadline
+    radio.rx.setVolume(30);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_TIMEOUT);
+    radio.clock.advance(50000);
+    radio.rx.setFrequency(9810);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    return ok;
+}
+
+/**
+ * @brief setFrequency ends with INTACK: STCINT is clear afterwards, so the next tune waits for its own STCINT.
+ */
+static bool testTuneAcknowledged()
+{
+    SimRadio<> radio;
+    uint32_t settle;
+    bool ok = true;
+
+    radio.rx.setTuneWait(TUNE_WAIT_STC);
+    radio.rx.setFrequency(9810);
+    settle = radio.rx.getTuneSettleTime();
+    EXPECT(settle > 0);
+    EXPECT(!radio.device.isStcInterrupt());
+    EXPECT(radio.rx.getStatusView().frequency() == 9810); // The tune status read with INTACK
+
+    radio.rx.setFrequency(10390);
+    EXPECT(radio.rx.getTuneSettleTime() == settle); // Not ended by the STCINT of the first tune
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+
+    radio.rx.setTuneWait(TUNE_WAIT_FIXED);
+    radio.rx.setFrequency(9810);
+    EXPECT(!radio.device.isStcInterrupt());
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief A tune longer than maxDelaySetFrequency reports SI4735_ERR_TIMEOUT, and scanBand leaves the channel out.
+ */
+static bool testTuneTimeout()
+{
+    SimRadio<> radio;
+    si47x_scan_record band[1];
+    bool ok = true;
+
+    radio.device.getTiming().tuneFm = (MAX_DELAY_AFTER_SET_FREQUENCY + 20) * 1000;
+    radio.rx.setFrequency(9810);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_TIMEOUT);
+    EXPECT(radio.rx.scanBand(9810, 9810, 10, band, 1) == 0);
+    EXPECT(radio.rx.getLastError() == SI4735_ERR_TIMEOUT);
+
+    radio.device.getTiming().tuneFm = 20000;
+    radio.clock.advance(20000);
+    radio.rx.setFrequency(10390);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    EXPECT(radio.rx.scanBand(9810, 9810, 10, band, 1) == 1);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"property-rejected", testPropertyRejected},
+        {"property-rejected-read", testPropertyRejectedRead},
+        {"property-accepted", testPropertyAccepted},
+        {"property-raw-write", testPropertyRawWrite},
+        {"async-property-rejected", testAsyncPropertyRejected},
+        {"mode-properties", testModeProperties},
+        {"async-tune", testAsyncTune},
+        {"async-error", testAsyncError},
+        {"async-timeout", testAsyncTimeout},
+        {"async-cancel", testAsyncCancel},
+        {"last-error-cleared", testLastErrorCleared},
+        {"tune-acknowledged", testTuneAcknowledged},
+        {"tune-timeout", testTuneTimeout},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,286 @@
+//
+// Behavior tests of I2CLinux (i2c-dev transport) through I2CLinuxFakeBackend and SI4735Simulator.
+//
+// Usage: si4735-i2c-linux-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <I2CLinux.h>
+
+#define MAX_RECORDED 4 // Messages kept of the last transfer
+
+/**
+ * @brief Fake backend that also keeps the messages of the last transfer (address, flags and the bytes written).
+ */
+class RecordingBackend : public I2CLinuxFakeBackend
+{
+  public:
+    struct Message
+    {
+        uint16_t addr;
+        uint16_t flags;
+        uint16_t len;
+        uint8_t data[16];
+    };
+
+    Message last[MAX_RECORDED];
+    uint32_t lastCount = 0;
+    uint32_t combined = 0; //!< Transfers with a write and a read message
+
+    explicit RecordingBackend(I2C &target) : I2CLinuxFakeBackend(target) {}
+
+    int transfer(int fd, struct i2c_msg *msgs, uint32_t count)
+    {
+        lastCount = count;
+        if (count == 2 && !(msgs[0].flags & I2C_M_RD) && (msgs[1].flags & I2C_M_RD))
+            combined++;
+        for (uint32_t i = 0; i < count && i < MAX_RECORDED; i++)
+        {
+            last[i].addr = msgs[i].addr;
+            last[i].flags = msgs[i].flags;
+            last[i].len = msgs[i].len;
+            if (!(msgs[i].flags & I2C_M_RD))
+                memcpy(last[i].data, msgs[i].buf, (msgs[i].len < 16) ? msgs[i].len : 16);
+        }
+        return I2CLinuxFakeBackend::transfer(fd, msgs, count);
+    }
+};
+
+/**
+ * @brief Simulated device behind I2CLinux, opened and powered up in FM.
+ */
+struct LinuxBus
+{
+    SI4735VirtualClock clock;
+    SI4735Simulator device;
+    RecordingBackend fake;
+    I2CLinux bus;
+
+    LinuxBus() : device(clock), fake(device), bus("/dev/i2c-test", fake) {}
+
+    /**
+     * @brief Waits for CTS (advancing the clock 100 uS per read).
+     */
+    void waitCts()
+    {
+        while (bus.requestFrom(SI473X_ADDR_SEN_LOW, 1) == 1 && !(bus.read() & 0x80))
+            clock.advance(100);
+    }
+};
+
+/**
+ * @brief A command is one ioctl with one write message; writeRead is one ioctl with a write and a read message.
+ */
+static bool testFraming()
+{
+    LinuxBus t;
+    uint8_t powerUp[3] = {POWER_UP, 0x10, SI473X_ANALOG_AUDIO};
+    uint8_t status[1] = {GET_INT_STATUS};
+    uint8_t resp[8];
+    bool ok = true;
+
+    EXPECT(t.bus.begin());
+    EXPECT(strcmp(t.fake.getPath(), "/dev/i2c-test") == 0);
+
+    t.bus.beginTransmission(SI473X_ADDR_SEN_LOW);
+    EXPECT(t.bus.write(powerUp, 3) == 3);
+    EXPECT(t.bus.endTransmission() == 0);
+    EXPECT(t.fake.getTransfers() == 1);
+    EXPECT(t.fake.lastCount == 1);
+    EXPECT(t.fake.last[0].addr == SI473X_ADDR_SEN_LOW);
+    EXPECT(t.fake.last[0].flags == 0);
+    EXPECT(t.fake.last[0].len == 3);
+    EXPECT(memcmp(t.fake.last[0].data, powerUp, 3) == 0);
+    EXPECT(t.device.isPowered());
+
+    t.clock.advance(t.device.getTiming().powerUp);
+    t.waitCts();
+    EXPECT(t.fake.lastCount == 1);
+    EXPECT(t.fake.last[0].flags == I2C_M_RD);
+    EXPECT(t.fake.last[0].len == 1);
+
+    uint32_t transfers = t.fake.getTransfers();
+    EXPECT(t.bus.writeRead(SI473X_ADDR_SEN_LOW, status, 1, resp, 8));
+    EXPECT(t.fake.getTransfers() == transfers + 1);
+    EXPECT(t.fake.lastCount == 2);
+    EXPECT(t.fake.last[0].addr == SI473X_ADDR_SEN_LOW && t.fake.last[1].addr == SI473X_ADDR_SEN_LOW);
+    EXPECT(t.fake.last[0].flags == 0 && t.fake.last[0].len == 1 && t.fake.last[0].data[0] == GET_INT_STATUS);
+    EXPECT(t.fake.last[1].flags == I2C_M_RD && t.fake.last[1].len == 8);
+    EXPECT(t.bus.getErrors() == 0);
+    EXPECT(t.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief Receiver session on I2CLinux; returns the ioctls it took.
+ */
+static uint32_t runSession(LinuxBus &t, SI4735 &rx)
+{
+    t.device.addStation({10390, SIM_BAND_FM, 45, 25, 0, 0, NULL, NULL});
+    t.bus.begin();
+    rx.setup(0, POWER_UP_FM);
+    rx.setFM(8750, 10800, 10390, 10);
+    rx.getStatus(0, 0);
+    rx.getCurrentReceivedSignalQuality();
+    rx.setVolume(20);
+    return t.fake.getTransfers();
+}
+
+/**
+ * @brief With default settings, SI4735 runs over I2CLinux with the combined transaction: fewer ioctls than without it,
+ * @brief at most two messages per ioctl and no protocol errors.
+ */
+static bool testDriver()
+{
+    LinuxBus plain, t;
+    SI4735 plainRx(plain.bus, plain.clock);
+    SI4735 rx(t.bus, t.clock);
+    uint32_t transfers, combined;
+    bool ok = true;
+
+    transfers = runSession(plain, plainRx);
+    EXPECT(plain.fake.combined == 0);
+
+    rx.setTransaction(&t.bus);
+    EXPECT(runSession(t, rx) < transfers);
+    EXPECT(t.fake.combined > 0);
+    EXPECT(rx.getCurrentFrequency() == 10390);
+    EXPECT(rx.getCurrentRSSI() == 45);
+    EXPECT(t.device.getProperty(RX_VOLUME) == 20);
+    EXPECT(t.fake.getLargestTransfer() == 2);
+    EXPECT(t.bus.getErrors() == 0);
+    EXPECT(t.device.getProtocolErrors() == 0);
+    EXPECT(rx.getLastError() == SI4735_OK);
+
+    transfers = t.fake.getTransfers();
+    combined = t.fake.combined;
+    rx.getCurrentReceivedSignalQuality(); // One ioctl for the command, one more if it was not answered right away
+    EXPECT(t.fake.combined == combined + 1);
+    EXPECT(t.fake.getTransfers() - transfers <= 2);
+    return ok;
+}
+
+/**
+ * @brief A failed ioctl is reported by every call (Wire codes, no bytes, false) and counted; a closed bus fails too.
+ */
+static bool testErrors()
+{
+    LinuxBus t;
+    uint8_t cmd[1] = {GET_INT_STATUS};
+    uint8_t resp[1];
+    uint8_t big[I2C_LINUX_BUFFER_SIZE + 1] = {0};
+    bool ok = true;
+
+    t.bus.beginTransmission(SI473X_ADDR_SEN_LOW); // Not open yet
+    t.bus.write(cmd, 1);
+    EXPECT(t.bus.endTransmission() == 4);
+    EXPECT(t.fake.getTransfers() == 0);
+
+    EXPECT(t.bus.begin());
+    t.fake.failNext(3);
+    t.bus.beginTransmission(SI473X_ADDR_SEN_LOW);
+    t.bus.write(cmd, 1);
+    EXPECT(t.bus.endTransmission() == 4);
+    EXPECT(t.bus.requestFrom(SI473X_ADDR_SEN_LOW, 1) == 0);
+    EXPECT(t.bus.read() == -1);
+    EXPECT(!t.bus.writeRead(SI473X_ADDR_SEN_LOW, cmd, 1, resp, 1));
+    EXPECT(t.bus.getErrors() == 3);
+
+    t.bus.beginTransmission(0x63); // No device at this address: the target does not acknowledge
+    t.bus.write(cmd, 1);
+    EXPECT(t.bus.endTransmission() == 4);
+    EXPECT(t.bus.getErrors() == 4);
+
+    t.bus.beginTransmission(SI473X_ADDR_SEN_LOW);
+    EXPECT(t.bus.write(big, sizeof(big)) == I2C_LINUX_BUFFER_SIZE);
+    EXPECT(t.bus.endTransmission() == 1); // Does not fit the buffer: nothing sent
+    EXPECT(t.bus.getErrors() == 4);
+
+    t.bus.end();
+    EXPECT(!t.bus.isOpen());
+    EXPECT(!t.bus.writeRead(SI473X_ADDR_SEN_LOW, cmd, 1, resp, 1));
+    return ok;
+}
+
+/**
+ * @brief submit sends the queued messages in one ioctl, with copies of the written bytes, and empties the queue.
+ */
+static bool testQueue()
+{
+    LinuxBus t;
+    uint8_t powerUp[3] = {POWER_UP, 0x10, SI473X_ANALOG_AUDIO};
+    uint8_t cmd[1] = {GET_INT_STATUS};
+    uint8_t resp[2];
+    bool ok = true;
+
+    EXPECT(t.bus.begin());
+    EXPECT(t.bus.submit()); // Empty queue: no ioctl
+    EXPECT(t.fake.getTransfers() == 0);
+
+    t.bus.beginTransmission(SI473X_ADDR_SEN_LOW);
+    t.bus.write(powerUp, 3);
+    t.bus.endTransmission();
+    t.clock.advance(t.device.getTiming().powerUp);
+    t.waitCts();
+
+    uint32_t transfers = t.fake.getTransfers();
+    EXPECT(t.bus.queueWrite(SI473X_ADDR_SEN_LOW, cmd, 1));
+    cmd[0] = 0xFF; // The queue holds its own copy
+    EXPECT(t.bus.queueRead(SI473X_ADDR_SEN_LOW, resp, 1));
+    EXPECT(t.bus.queueRead(SI473X_ADDR_SEN_LOW, resp + 1, 1));
+    EXPECT(t.bus.getQueued() == 3);
+    EXPECT(t.bus.submit());
+    EXPECT(t.fake.getTransfers() == transfers + 1);
+    EXPECT(t.fake.lastCount == 3);
+    EXPECT(t.fake.last[0].flags == 0 && t.fake.last[0].len == 1 && t.fake.last[0].data[0] == GET_INT_STATUS);
+    EXPECT(t.fake.last[1].flags == I2C_M_RD && t.fake.last[2].flags == I2C_M_RD);
+    EXPECT(!(resp[0] & 0x80)); // Read right after the command: the device is not clear to send yet
+    EXPECT(t.bus.getQueued() == 0);
+    EXPECT(t.bus.submit());
+    EXPECT(t.fake.getTransfers() == transfers + 1);
+    EXPECT(t.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief queueWrite and queueRead fail when the queue is full, by message count or by written bytes.
+ */
+static bool testQueueFull()
+{
+    LinuxBus t;
+    static uint8_t data[I2C_LINUX_QUEUE_SIZE];
+    uint8_t resp[I2C_LINUX_MAX_MSGS];
+    bool ok = true;
+
+    EXPECT(t.bus.begin());
+    for (uint8_t i = 0; i < I2C_LINUX_MAX_MSGS; i++)
+        EXPECT(t.bus.queueRead(SI473X_ADDR_SEN_LOW, resp + i, 1));
+    EXPECT(!t.bus.queueRead(SI473X_ADDR_SEN_LOW, resp, 1));
+    EXPECT(!t.bus.queueWrite(SI473X_ADDR_SEN_LOW, data, 1));
+    EXPECT(t.bus.getQueued() == I2C_LINUX_MAX_MSGS);
+    EXPECT(t.bus.submit());
+    EXPECT(t.fake.getTransfers() == 1);
+    EXPECT(t.fake.getLargestTransfer() == I2C_LINUX_MAX_MSGS);
+
+    EXPECT(t.bus.queueWrite(0x63, data, I2C_LINUX_QUEUE_SIZE - 1)); // No device there: nothing is played
+    EXPECT(!t.bus.queueWrite(0x63, data, 2));
+    EXPECT(t.bus.queueWrite(0x63, data, 1));
+    EXPECT(t.bus.getQueued() == 2);
+    EXPECT(!t.bus.submit()); // Not acknowledged; the queue is emptied anyway
+    EXPECT(t.bus.getQueued() == 0);
+    EXPECT(t.bus.queueWrite(0x63, data, I2C_LINUX_QUEUE_SIZE));
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"framing", testFraming},
+        {"driver", testDriver},
+        {"errors", testErrors},
+        {"queue", testQueue},
+        {"queue-full", testQueueFull},
+    };
+
+    return runTests(argc, argv, tests);
+}
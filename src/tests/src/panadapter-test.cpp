@@ -0,0 +1,108 @@
+//
+// Behavior tests of the panadapter (si4735-panadapter.h) against SI4735Simulator.
+//
+// Usage: si4735-panadapter-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <si4735-panadapter.h>
+
+/**
+ * @brief A frame covers span channels on each side of the listening frequency, which is tuned again after the sweep.
+ */
+static bool testSweepFrame()
+{
+    SimRadio<> radio;
+    SI4735Panadapter pan(radio.rx, radio.clock);
+    si4735_spectrum_frame frame = {};
+    bool ok = true;
+
+    pan.configure(3, 10);
+    EXPECT(!pan.read(&frame));
+    EXPECT(pan.sweep());
+    EXPECT(radio.rx.getCurrentFrequency() == 10390);
+    EXPECT(radio.device.getFrequency() == 10390);
+    EXPECT(pan.getPending() == 1);
+
+    EXPECT(pan.read(&frame));
+    EXPECT(frame.center == 10390 && frame.first == 10360 && frame.step == 10);
+    EXPECT(frame.bins == 7);
+    EXPECT(frame.rssi[3] == 45);
+    EXPECT(frame.rssi[0] < frame.rssi[3] && frame.rssi[6] < frame.rssi[3]);
+    EXPECT(!pan.read(&frame));
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief When the consumer falls behind, new frames are dropped and counted; the published frames come out in order.
+ */
+static bool testRingDrop()
+{
+    SimRadio<> radio;
+    SI4735Panadapter pan(radio.rx, radio.clock);
+    si4735_spectrum_frame frame = {};
+    bool ok = true;
+
+    pan.configure(1, 10);
+    for (uint8_t i = 0; i < SI4735_PANADAPTER_FRAMES; i++)
+        EXPECT(pan.sweep());
+    EXPECT(!pan.sweep()); // Ring full
+    EXPECT(pan.getDropped() == 1);
+    EXPECT(pan.getPending() == SI4735_PANADAPTER_FRAMES);
+    EXPECT(radio.device.getFrequency() == 10390);
+
+    for (uint32_t i = 1; i <= SI4735_PANADAPTER_FRAMES; i++)
+    {
+        EXPECT(pan.read(&frame));
+        EXPECT(frame.sequence == i);
+    }
+    EXPECT(!pan.read(&frame));
+
+    EXPECT(pan.sweep());
+    EXPECT(pan.read(&frame));
+    EXPECT(frame.sequence == SI4735_PANADAPTER_FRAMES + 2); // The gap shows the dropped frame
+    EXPECT(pan.getDropped() == 1);
+    return ok;
+}
+
+/**
+ * @brief Bins stop at the band limit, and a channel that could not be read keeps its bin (0 dBuV).
+ */
+static bool testBandEdge()
+{
+    SimRadio<> radio;
+    SI4735Panadapter pan(radio.rx, radio.clock);
+    si4735_spectrum_frame frame = {};
+    bool ok = true;
+
+    radio.rx.setFrequency(8760);
+    pan.configure(3, 10);
+    EXPECT(pan.sweep());
+    EXPECT(pan.read(&frame));
+    EXPECT(frame.first == 8750 && frame.bins == 5); // 87.5 to 87.9 MHz
+    EXPECT(radio.device.getFrequency() == 8760);
+
+    radio.rx.setFrequency(9800);
+    pan.configure(2, 10);
+    radio.device.failNext(FM_RSQ_STATUS, 1); // 97.8 MHz
+    EXPECT(pan.sweep());
+    EXPECT(pan.read(&frame));
+    EXPECT(frame.first == 9780 && frame.bins == 5);
+    EXPECT(frame.rssi[0] == 0);
+    EXPECT(frame.rssi[1] > 0);
+    EXPECT(frame.rssi[3] == 38);
+    EXPECT(radio.device.getFrequency() == 9800);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"sweep-frame", testSweepFrame},
+        {"ring-drop", testRingDrop},
+        {"band-edge", testBandEdge},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,151 @@
+//
+// Performance budget tests: upper bounds on the I2C transactions and on the modeled time of the canonical operations.
+//
+// Usage: si4735-perf-tests <case>   (tune, seek, rds, property, patch or all)
+//
+// The driver runs against SI4735Simulator with a virtual clock, so the numbers are exact and repeatable.
+// A change that adds a wait, a CTS poll or a command makes the operation exceed its budget and the test fail.
+// When an operation gets cheaper on purpose, lower its budget in the same change.
+//
+
+#include "test-support.h"
+
+#define PROGMEM
+typedef uint8_t byte;
+#include <patch_init.h>
+
+/**
+ * @brief Budget of an operation.
+ */
+typedef struct
+{
+    uint32_t transactions; //!< Bus transactions (writes and reads)
+    uint32_t modeled;      //!< Virtual time in uS (bus transfers, CTS polls and waits)
+} PerfBudget;
+
+// The time budgets leave less than 1 ms above the current cost, so a stray clock.wait(1) is caught.
+static const PerfBudget TUNE_BUDGET = {12, 24000};        // setFrequency on FM (ends with INTACK)
+static const PerfBudget SEEK_BUDGET = {171, 1182000};     // seekStationDown from 103.9 to 98.1 MHz (58 channels)
+static const PerfBudget RDS_BUDGET = {3, 2400};           // getRdsStatus with one group in the FIFO
+static const PerfBudget PROPERTY_BUDGET = {3, 1500};      // setVolume (confirmed: CTS and ERR)
+static const PerfBudget PATCH_BUDGET = {3043, 1590500};   // loadPatch of patch_init.h
+
+/**
+ * @brief I2C decorator that counts the transactions sent to the device.
+ */
+class CountingI2C : public I2C
+{
+  public:
+    explicit CountingI2C(I2C &target) : target(target) {}
+
+    void beginTransmission(int address) { target.beginTransmission(address); }
+    size_t write(uint8_t data) { return target.write(data); }
+    size_t write(const uint8_t *data, size_t size) { return target.write(data, size); }
+    uint8_t endTransmission()
+    {
+        transactions++;
+        return target.endTransmission();
+    }
+    uint8_t requestFrom(int address, int quantity)
+    {
+        transactions++;
+        return target.requestFrom(address, quantity);
+    }
+    int read() { return target.read(); }
+
+    uint32_t transactions = 0;
+
+  private:
+    I2C &target;
+};
+
+typedef SimRadio<SI4735, CountingI2C> Bench;
+
+/**
+ * @brief Cost of the operations run on a bench from the construction on.
+ */
+class PerfRun
+{
+  public:
+    explicit PerfRun(Bench &bench) : bench(bench), transactions(bench.bus.transactions), time(bench.clock.micros()) {}
+
+    /**
+     * @brief Compares the cost with the budget and prints it.
+     */
+    bool check(const char *name, const PerfBudget &budget)
+    {
+        uint32_t usedTransactions = bench.bus.transactions - transactions;
+        uint32_t usedTime = (uint32_t)(bench.clock.micros() - time);
+        uint32_t errors = bench.device.getProtocolErrors();
+
+        printf("  %-9s transactions %5u (budget %5u)  modeled %8u us (budget %8u us)  protocol errors %u\n", name,
+               usedTransactions, budget.transactions, usedTime, budget.modeled, errors);
+        return usedTransactions <= budget.transactions && usedTime <= budget.modeled && errors == 0;
+    }
+
+  private:
+    Bench &bench;
+    uint32_t transactions;
+    uint64_t time;
+};
+
+static bool testTune()
+{
+    Bench bench;
+    PerfRun run(bench);
+
+    bench.rx.setFrequency(9810);
+    return run.check("tune", TUNE_BUDGET) && bench.rx.getFrequency() == 9810;
+}
+
+static bool testSeek()
+{
+    Bench bench;
+    PerfRun run(bench);
+
+    bench.rx.seekStationDown();
+    return run.check("seek", SEEK_BUDGET) && bench.rx.getFrequency() == 9810;
+}
+
+static bool testRds()
+{
+    Bench bench;
+
+    bench.rx.setRdsConfig(1, 2, 2, 2, 2);
+    bench.clock.wait(90); // One group in the FIFO
+
+    PerfRun run(bench);
+    bench.rx.getRdsStatus();
+    return run.check("rds", RDS_BUDGET) && bench.rx.getRdsReceived();
+}
+
+static bool testProperty()
+{
+    Bench bench;
+    PerfRun run(bench);
+
+    bench.rx.setVolume(40);
+    return run.check("property", PROPERTY_BUDGET) && bench.device.getProperty(RX_VOLUME) == 40;
+}
+
+static bool testPatch()
+{
+    Bench bench;
+    PerfRun run(bench);
+
+    bench.rx.loadPatch(ssb_patch_content, sizeof ssb_patch_content, 2);
+    return run.check("patch", PATCH_BUDGET) && bench.device.getPatchLines() == sizeof ssb_patch_content / 8;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"tune", testTune},
+        {"seek", testSeek},
+        {"rds", testRds},
+        {"property", testProperty},
+        {"patch", testPatch},
+    };
+
+    return runTests(argc, argv, tests);
+}
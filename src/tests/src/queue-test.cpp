@@ -0,0 +1,193 @@
+//
+// Behavior tests of the command queue (si4735-queue.h) against SI4735Simulator.
+//
+// Usage: si4735-queue-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <si4735-queue.h>
+
+#define MAX_ENDED 16 // Callbacks kept by a test
+
+/**
+ * @brief Requests ended by the queue, in callback order.
+ */
+struct Ended
+{
+    uint8_t request[MAX_ENDED];
+    uint8_t result[MAX_ENDED];
+    uint8_t count = 0;
+
+    static void callback(void *context, uint8_t request, uint8_t result)
+    {
+        Ended *ended = (Ended *)context;
+
+        if (ended->count < MAX_ENDED)
+        {
+            ended->request[ended->count] = request;
+            ended->result[ended->count] = result;
+        }
+        ended->count++;
+    }
+};
+
+/**
+ * @brief Services the queue until it is idle (advancing the clock 100 uS per call).
+ * @return false if the queue was still busy after a second of virtual time.
+ */
+template <class Radio>
+static bool drain(Radio &radio, SI4735CommandQueue &queue)
+{
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        if (queue.service() == QUEUE_IDLE)
+            return true;
+        radio.clock.advance(100);
+    }
+    return false;
+}
+
+/**
+ * @brief A user request submitted during a seek cancels the seek (ASYNC_CANCELLED) and runs right after it.
+ */
+static bool testSeekPreempted()
+{
+    SimRadio<> radio;
+    Ended ended;
+    SI4735CommandQueue queue(radio.rx, Ended::callback, &ended);
+    bool ok = true;
+
+    EXPECT(queue.submit(QUEUE_SEEK, SEEK_UP));
+    EXPECT(queue.service() == QUEUE_BUSY);
+    EXPECT(queue.getActive() == QUEUE_SEEK);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        radio.clock.advance(radio.device.getTiming().seekStep);
+        EXPECT(queue.service() == QUEUE_BUSY);
+    }
+    EXPECT(ended.count == 0); // Still seeking
+
+    EXPECT(queue.submit(QUEUE_TUNE, 9810));
+    EXPECT(drain(radio, queue));
+    EXPECT(ended.count == 2);
+    EXPECT(ended.request[0] == QUEUE_SEEK && ended.result[0] == ASYNC_CANCELLED);
+    EXPECT(ended.request[1] == QUEUE_TUNE && ended.result[1] == ASYNC_DONE);
+    EXPECT(queue.getPreemptions() == 1);
+    EXPECT(radio.device.getFrequency() == 9810);
+    return ok;
+}
+
+/**
+ * @brief Two pending volume requests collapse: the older one is cancelled and only the newest value is sent.
+ */
+static bool testVolumeCollapsed()
+{
+    SimRadio<> radio;
+    Ended ended;
+    SI4735CommandQueue queue(radio.rx, Ended::callback, &ended);
+    uint32_t commands;
+    bool ok = true;
+
+    EXPECT(drain(radio, queue));
+    commands = radio.device.getCommandCount();
+    EXPECT(queue.submit(QUEUE_VOLUME, 10));
+    EXPECT(queue.submit(QUEUE_VOLUME, 40));
+    EXPECT(drain(radio, queue));
+    EXPECT(ended.count == 2);
+    EXPECT(ended.request[0] == QUEUE_VOLUME && ended.result[0] == ASYNC_CANCELLED);
+    EXPECT(ended.request[1] == QUEUE_VOLUME && ended.result[1] == ASYNC_DONE);
+    EXPECT(queue.getReplaced() == 1);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 40);
+    EXPECT(radio.device.getCommandCount() == commands + 1); // One SET_PROPERTY
+    return ok;
+}
+
+/**
+ * @brief Command queue whose slots can be held, as by a submit() in progress on another thread.
+ */
+class HeldQueue : public SI4735CommandQueue
+{
+  public:
+    HeldQueue(SI4735Base &rx, SI4735QueueCallback callback, void *context) : SI4735CommandQueue(rx, callback, context) {}
+
+    inline void hold(uint8_t i) { __atomic_store_n(&slots[i].state, (uint8_t)QUEUE_SLOT_CLAIMED, __ATOMIC_RELEASE); }
+    inline void release(uint8_t i) { __atomic_store_n(&slots[i].state, (uint8_t)QUEUE_SLOT_FREE, __ATOMIC_RELEASE); }
+};
+
+/**
+ * @brief Of three requests of the same kind, the newest runs, even from a lower slot than the older two.
+ */
+static bool testNewestWins()
+{
+    SimRadio<> radio;
+    Ended ended;
+    HeldQueue queue(radio.rx, Ended::callback, &ended);
+    bool ok = true;
+
+    queue.hold(0);
+    EXPECT(queue.submit(QUEUE_VOLUME, 10)); // Slot 1
+    EXPECT(queue.submit(QUEUE_VOLUME, 20)); // Slot 2
+    queue.release(0);
+    EXPECT(queue.submit(QUEUE_VOLUME, 30)); // Slot 0
+    EXPECT(drain(radio, queue));
+    EXPECT(ended.count == 3);
+    EXPECT(ended.result[0] == ASYNC_CANCELLED && ended.result[1] == ASYNC_CANCELLED);
+    EXPECT(ended.request[2] == QUEUE_VOLUME && ended.result[2] == ASYNC_DONE);
+    EXPECT(queue.getReplaced() == 2);
+    EXPECT(radio.device.getProperty(RX_VOLUME) == 30);
+    return ok;
+}
+
+/**
+ * @brief A background RSQ read submitted first runs after the user requests, which keep their order.
+ */
+static bool testBackgroundWaits()
+{
+    SimRadio<> radio;
+    Ended ended;
+    SI4735CommandQueue queue(radio.rx, Ended::callback, &ended);
+    bool ok = true;
+
+    EXPECT(queue.submit(QUEUE_RSQ));
+    EXPECT(queue.submit(QUEUE_VOLUME, 30));
+    EXPECT(queue.submit(QUEUE_TUNE, 9810));
+    EXPECT(drain(radio, queue));
+    EXPECT(ended.count == 3);
+    EXPECT(ended.request[0] == QUEUE_VOLUME && ended.result[0] == ASYNC_DONE);
+    EXPECT(ended.request[1] == QUEUE_TUNE && ended.result[1] == ASYNC_DONE);
+    EXPECT(ended.request[2] == QUEUE_RSQ && ended.result[2] == ASYNC_DONE);
+    EXPECT(radio.rx.getCurrentRSSI() == 38); // Measured on the new channel
+    return ok;
+}
+
+/**
+ * @brief submit() fails when every slot is pending and succeeds again once service() takes a request.
+ */
+static bool testQueueFull()
+{
+    SimRadio<> radio;
+    Ended ended;
+    SI4735CommandQueue queue(radio.rx, Ended::callback, &ended);
+    bool ok = true;
+
+    for (uint16_t i = 0; i < SI4735_QUEUE_SIZE; i++)
+        EXPECT(queue.submit(QUEUE_PROPERTY, i, RX_VOLUME + 0x100 * i)); // Different properties: never merged
+    EXPECT(!queue.submit(QUEUE_RSQ));
+    EXPECT(queue.service() == QUEUE_BUSY);
+    EXPECT(queue.submit(QUEUE_RSQ));
+    EXPECT(!queue.submit(QUEUE_RSQ));
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"seek-preempted", testSeekPreempted},
+        {"volume-collapsed", testVolumeCollapsed},
+        {"newest-wins", testNewestWins},
+        {"background-waits", testBackgroundWaits},
+        {"queue-full", testQueueFull},
+    };
+
+    return runTests(argc, argv, tests);
+}
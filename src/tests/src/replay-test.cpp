@@ -0,0 +1,183 @@
+//
+// Behavior tests of the record/replay transport (I2CRecorder, I2CReplay) against SI4735Simulator.
+//
+// Usage: si4735-replay-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <I2CRecorder.h>
+
+/**
+ * @brief Writes a command frame on a transport.
+ */
+static uint8_t writeFrame(I2C &bus, const uint8_t *frame, uint8_t size)
+{
+    bus.beginTransmission(SI473X_ADDR_SEN_LOW);
+    bus.write(frame, size);
+    return bus.endTransmission();
+}
+
+/**
+ * @brief Reads one status byte from a transport (-1 if nothing was served).
+ */
+static int readStatus(I2C &bus, uint8_t quantity = 1)
+{
+    if (bus.requestFrom(SI473X_ADDR_SEN_LOW, quantity) == 0)
+        return -1;
+    return bus.read();
+}
+
+/**
+ * @brief Receiver session on a recorder; the recording is left in a temporary file, at its start.
+ */
+static FILE *recordSession(uint16_t frequency)
+{
+    SimRadio<> radio;
+    FILE *file = tmpfile();
+    I2CRecorder recorder(radio.device, radio.clock, file);
+    SI4735 rx(recorder, radio.clock);
+
+    rx.setup(0, POWER_UP_FM);
+    rx.setFM(8750, 10800, 10390, 10);
+    rx.setFrequency(frequency);
+    rx.getStatus(0, 0);
+    recorder.flush();
+    fseek(file, 0, SEEK_SET);
+    return file;
+}
+
+/**
+ * @brief The same calls on the replay get the recorded responses back without a mismatch.
+ */
+static bool testReplaySession()
+{
+    FILE *file = recordSession(9810);
+    SI4735VirtualClock clock;
+    I2CReplay replay;
+    SI4735 rx(replay, clock);
+    bool ok = true;
+
+    EXPECT(replay.load(file));
+    fclose(file);
+    rx.setup(0, POWER_UP_FM);
+    rx.setFM(8750, 10800, 10390, 10);
+    rx.setFrequency(9810);
+    rx.getStatus(0, 0);
+    EXPECT(rx.getStatusView().frequency() == 9810);
+    EXPECT(replay.getRecords() > 0);
+    EXPECT(replay.getMismatches() == 0);
+    EXPECT(rx.getLastError() == SI4735_OK);
+    return ok;
+}
+
+/**
+ * @brief A different command is counted as a mismatch; the replay goes on with the recorded responses.
+ */
+static bool testReplayMismatch()
+{
+    FILE *file = recordSession(9810);
+    SI4735VirtualClock clock;
+    I2CReplay replay;
+    SI4735 rx(replay, clock);
+    bool ok = true;
+
+    EXPECT(replay.load(file));
+    fclose(file);
+    rx.setup(0, POWER_UP_FM);
+    rx.setFM(8750, 10800, 10390, 10);
+    EXPECT(replay.getMismatches() == 0);
+    rx.setFrequency(10390); // Recorded: 98.1 MHz
+    EXPECT(replay.getMismatches() == 1);
+    rx.getStatus(0, 0);
+    EXPECT(rx.getStatusView().frequency() == 9810); // The recorded tune status
+    EXPECT(replay.getMismatches() == 1);
+
+    replay.rewind();
+    EXPECT(replay.getMismatches() == 0 && replay.getRecords() == 0);
+    return ok;
+}
+
+/**
+ * @brief Status polls need not match: recorded polls not made are skipped, extra polls get the last response again.
+ */
+static bool testReplayPolls()
+{
+    SimRadio<> radio;
+    FILE *file = tmpfile();
+    I2CRecorder recorder(radio.device, radio.clock, file);
+    uint8_t tune[4] = {FM_TUNE_FREQ, 0, 9810 >> 8, 9810 & 0xFF};
+    uint8_t status[1] = {GET_INT_STATUS};
+    int recorded[2];
+    I2CReplay replay;
+    bool ok = true;
+
+    EXPECT(writeFrame(recorder, tune, 4) == 0);
+    recorded[0] = readStatus(recorder); // Three polls of the tune command
+    readStatus(recorder);
+    readStatus(recorder);
+    EXPECT(writeFrame(recorder, status, 1) == 0);
+    recorded[1] = readStatus(recorder);
+    recorder.flush();
+    EXPECT(recorder.getRecords() == 6);
+    EXPECT(recorder.getFileSize() == (uint32_t)ftell(file));
+    fseek(file, 0, SEEK_SET);
+    EXPECT(replay.load(file));
+    fclose(file);
+
+    EXPECT(writeFrame(replay, tune, 4) == 0);
+    EXPECT(readStatus(replay) == recorded[0]); // One poll instead of three
+    EXPECT(writeFrame(replay, status, 1) == 0);
+    EXPECT(replay.getSkippedReads() == 2);
+    EXPECT(readStatus(replay) == recorded[1]);
+    EXPECT(replay.isDone());
+    EXPECT(readStatus(replay) == recorded[1]); // Two polls more than recorded
+    EXPECT(readStatus(replay) == recorded[1]);
+    EXPECT(replay.getExtraReads() == 2);
+    EXPECT(replay.getMismatches() == 0);
+
+    EXPECT(writeFrame(replay, status, 1) == 4); // Past the end of the recording
+    EXPECT(replay.getMismatches() == 1);
+    return ok;
+}
+
+/**
+ * @brief A read of another size than recorded is a mismatch; a file that is not a recording is not loaded.
+ */
+static bool testReplayFormat()
+{
+    SimRadio<> radio;
+    FILE *file = tmpfile();
+    I2CRecorder recorder(radio.device, radio.clock, file);
+    uint8_t status[1] = {GET_INT_STATUS};
+    I2CReplay replay;
+    bool ok = true;
+
+    writeFrame(recorder, status, 1);
+    readStatus(recorder, 1);
+    recorder.flush();
+    fseek(file, 0, SEEK_SET);
+    EXPECT(replay.load(file));
+    writeFrame(replay, status, 1);
+    EXPECT(replay.requestFrom(SI473X_ADDR_SEN_LOW, 8) == 1); // Only the recorded byte is served
+    EXPECT(replay.getMismatches() == 1);
+
+    fseek(file, 0, SEEK_SET);
+    fputc('X', file);
+    fseek(file, 0, SEEK_SET);
+    EXPECT(!replay.load(file));
+    fclose(file);
+    EXPECT(!replay.load("/nonexistent/recording.si47"));
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"replay-session", testReplaySession},
+        {"replay-mismatch", testReplayMismatch},
+        {"replay-polls", testReplayPolls},
+        {"replay-format", testReplayFormat},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,92 @@
+//
+// Behavior tests of the band scan (scanBand) against SI4735Simulator.
+//
+// Usage: si4735-scan-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+#define SCAN_RECORDS 8
+
+/**
+ * @brief One record per channel, in order, with the RSQ of the station on it; FAST is restored.
+ */
+static bool testScanRecords()
+{
+    SimRadio<> radio;
+    si47x_scan_record band[SCAN_RECORDS];
+    bool ok = true;
+
+    radio.rx.setTuneFrequencyFast(0);
+    EXPECT(radio.rx.scanBand(9790, 9830, 10, band, SCAN_RECORDS) == 5);
+    for (uint16_t i = 0; i < 5; i++)
+        EXPECT(band[i].frequency == 9790 + 10 * i);
+    EXPECT(band[2].rssi == 38 && band[2].snr == 18);
+    EXPECT(band[0].rssi < band[2].rssi); // Band noise only
+    EXPECT(radio.rx.getTuneFrequecyFast() == 0);
+    EXPECT(radio.rx.getCurrentFrequency() == 9830); // Stays on the last channel
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+
+    radio.rx.setTuneFrequencyFast(1);
+    EXPECT(radio.rx.scanBand(9790, 9830, 10, band, SCAN_RECORDS) == 5);
+    EXPECT(radio.rx.getTuneFrequecyFast() == 1);
+    EXPECT(radio.device.getProtocolErrors() == 0);
+    return ok;
+}
+
+/**
+ * @brief The scan stops when out is full; the records after size are not written.
+ */
+static bool testScanSize()
+{
+    SimRadio<> radio;
+    si47x_scan_record band[SCAN_RECORDS];
+    bool ok = true;
+
+    memset(band, 0xFF, sizeof band);
+    EXPECT(radio.rx.scanBand(8750, 10800, 10, band, 3) == 3);
+    EXPECT(band[2].frequency == 8770);
+    EXPECT(band[3].frequency == 0xFFFF);
+    EXPECT(radio.rx.getCurrentFrequency() == 8770);
+    EXPECT(radio.rx.scanBand(8750, 10800, 0, band, 3) == 0);
+    return ok;
+}
+
+/**
+ * @brief Only the RSQ reads that succeed are averaged; a channel with no successful read is left out.
+ */
+static bool testScanFailures()
+{
+    SimRadio<> radio;
+    si47x_scan_record band[SCAN_RECORDS];
+    uint32_t commands;
+    bool ok = true;
+
+    commands = radio.device.getCommandCount();
+    EXPECT(radio.rx.scanBand(9810, 9810, 10, band, SCAN_RECORDS, 0, 4) == 1);
+    EXPECT(band[0].rssi == 38 && band[0].snr == 18);
+    EXPECT(radio.device.getCommandCount() - commands >= 5); // The tune and four RSQ reads
+
+    radio.device.failNext(FM_RSQ_STATUS, 3);
+    EXPECT(radio.rx.scanBand(9810, 9810, 10, band, SCAN_RECORDS, 0, 4) == 1);
+    EXPECT(band[0].rssi == 38 && band[0].snr == 18);
+
+    radio.device.failNext(FM_RSQ_STATUS, 2);
+    memset(band, 0, sizeof band);
+    EXPECT(radio.rx.scanBand(9800, 9820, 10, band, SCAN_RECORDS, 0, 2) == 2); // 98.0 MHz fails twice
+    EXPECT(band[0].frequency == 9810 && band[0].rssi == 38);
+    EXPECT(band[1].frequency == 9820);
+    EXPECT(radio.rx.getLastError() == SI4735_OK);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"scan-records", testScanRecords},
+        {"scan-size", testScanSize},
+        {"scan-failures", testScanFailures},
+    };
+
+    return runTests(argc, argv, tests);
+}
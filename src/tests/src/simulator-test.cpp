@@ -0,0 +1,197 @@
+//
+// Behavior tests of the SI4735Simulator tune and seek model (STCINT, seek timing, BLTF, CANCEL).
+//
+// The commands are written on the simulated bus directly, so these cases check the device model and not the driver.
+//
+// Usage: si4735-simulator-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+/**
+ * @brief Writes a command frame on the simulated bus.
+ */
+static void writeFrame(SI4735Simulator &device, uint8_t cmd, uint8_t arg1 = 0, uint8_t arg2 = 0, uint8_t arg3 = 0)
+{
+    uint8_t frame[4] = {cmd, arg1, arg2, arg3};
+
+    device.beginTransmission(SI473X_ADDR_SEN_LOW);
+    device.write(frame, 4);
+    device.endTransmission();
+}
+
+/**
+ * @brief Waits for CTS (advancing the clock 100 uS per read) and reads the response.
+ * @return the status byte.
+ */
+template <class Radio>
+static uint8_t readResponse(Radio &radio, uint8_t *resp, uint8_t size)
+{
+    for (;;)
+    {
+        radio.device.requestFrom(SI473X_ADDR_SEN_LOW, size);
+        for (uint8_t i = 0; i < size; i++)
+            resp[i] = radio.device.read();
+        if (resp[0] & 0x80)
+            return resp[0];
+        radio.clock.advance(100);
+    }
+}
+
+/**
+ * @brief Sends FM_TUNE_STATUS and returns the response (8 bytes).
+ */
+template <class Radio>
+static void tuneStatus(Radio &radio, uint8_t arg, uint8_t *resp)
+{
+    writeFrame(radio.device, FM_TUNE_STATUS, arg);
+    readResponse(radio, resp, 8);
+}
+
+/**
+ * @brief Status byte read once, without waiting for CTS.
+ */
+static uint8_t statusByte(SI4735Simulator &device)
+{
+    device.requestFrom(SI473X_ADDR_SEN_LOW, 1);
+    return device.read();
+}
+
+/**
+ * @brief Waits for CTS after the command written last.
+ */
+template <class Radio>
+static void waitCts(Radio &radio)
+{
+    uint8_t status;
+    readResponse(radio, &status, 1);
+}
+
+/**
+ * @brief STCINT goes up after the tune time, stays up until INTACK, and the frequency changes right away.
+ */
+static bool testStcAfterTune()
+{
+    SimRadio<> radio;
+    uint8_t resp[8];
+    bool ok = true;
+
+    writeFrame(radio.device, FM_TUNE_FREQ, 0, 9810 >> 8, 9810 & 0xFF);
+    uint64_t start = radio.clock.micros(); // The command runs at the end of the write
+    waitCts(radio);
+    EXPECT(!(statusByte(radio.device) & 0x01));
+    EXPECT(radio.device.getFrequency() == 9810);
+
+    radio.clock.advance(radio.device.getTiming().tuneFm - (radio.clock.micros() - start) - 1000); // Reads take bus time too
+    EXPECT(!(statusByte(radio.device) & 0x01));
+    radio.clock.advance(2000);
+    EXPECT(statusByte(radio.device) & 0x01);
+    EXPECT(statusByte(radio.device) & 0x01); // Reading the status does not clear it
+
+    tuneStatus(radio, 0x00, resp);
+    EXPECT(resp[0] & 0x01);
+    EXPECT(resp[1] & 0x01); // Valid channel
+    EXPECT((((uint16_t)resp[2] << 8) | resp[3]) == 9810);
+    tuneStatus(radio, 0x01, resp); // INTACK
+    EXPECT(!(statusByte(radio.device) & 0x01));
+    return ok;
+}
+
+/**
+ * @brief A seek takes seekStep per channel visited, wraps at the band limit and stops on the next station.
+ */
+static bool testSeekWrap()
+{
+    SimRadio<> radio;
+    uint32_t step = radio.device.getTiming().seekStep;
+    uint16_t top = radio.device.getProperty(FM_SEEK_BAND_TOP);
+    uint16_t bottom = radio.device.getProperty(FM_SEEK_BAND_BOTTOM);
+    uint16_t spacing = radio.device.getProperty(FM_SEEK_FREQ_SPACING);
+    uint32_t channels = (top - 10390) / spacing + 1 + (9810 - bottom) / spacing; // Up to the top, wrap, up to 98.1
+    uint8_t resp[8];
+    bool ok = true;
+
+    writeFrame(radio.device, FM_SEEK_START, 0x0C); // SEEKUP, WRAP
+    uint64_t start = radio.clock.micros();
+    waitCts(radio);
+    EXPECT(radio.device.getFrequency() == 10390);
+
+    radio.clock.advance(step * 3);
+    EXPECT(radio.device.getFrequency() == 10390 + 3 * spacing); // Channel being checked
+
+    radio.clock.advance(start + (uint64_t)(channels - 1) * step - radio.clock.micros());
+    EXPECT(!(statusByte(radio.device) & 0x01));
+    radio.clock.advance(step);
+    EXPECT(statusByte(radio.device) & 0x01);
+
+    tuneStatus(radio, 0x01, resp);
+    EXPECT((((uint16_t)resp[2] << 8) | resp[3]) == 9810);
+    EXPECT(!(resp[1] & 0x80)); // BLTF
+    EXPECT(resp[1] & 0x01);    // Valid channel
+    return ok;
+}
+
+/**
+ * @brief Without WRAP, a seek with no station ahead stops on the band limit with BLTF set.
+ */
+static bool testSeekHalt()
+{
+    SimRadio<> radio;
+    uint32_t step = radio.device.getTiming().seekStep;
+    uint16_t top = radio.device.getProperty(FM_SEEK_BAND_TOP);
+    uint16_t spacing = radio.device.getProperty(FM_SEEK_FREQ_SPACING);
+    uint8_t resp[8];
+    bool ok = true;
+
+    writeFrame(radio.device, FM_SEEK_START, 0x08); // SEEKUP
+    waitCts(radio);
+    radio.clock.advance((uint64_t)((top - 10390) / spacing) * step);
+    EXPECT(statusByte(radio.device) & 0x01);
+
+    tuneStatus(radio, 0x01, resp);
+    EXPECT((((uint16_t)resp[2] << 8) | resp[3]) == top);
+    EXPECT(resp[1] & 0x80); // BLTF
+    EXPECT(!(resp[1] & 0x01));
+    return ok;
+}
+
+/**
+ * @brief CANCEL stops a seek on the channel being checked and sets STCINT right away.
+ */
+static bool testSeekCancel()
+{
+    SimRadio<> radio;
+    uint32_t step = radio.device.getTiming().seekStep;
+    uint16_t spacing = radio.device.getProperty(FM_SEEK_FREQ_SPACING);
+    uint8_t resp[8];
+    bool ok = true;
+
+    writeFrame(radio.device, FM_SEEK_START, 0x04); // Down, WRAP
+    waitCts(radio);
+    radio.clock.advance(step * 5);
+    EXPECT(!(statusByte(radio.device) & 0x01));
+
+    tuneStatus(radio, 0x02, resp); // CANCEL
+    EXPECT((((uint16_t)resp[2] << 8) | resp[3]) == 10390 - 5 * spacing);
+    EXPECT(!(resp[1] & 0x80));
+    EXPECT(statusByte(radio.device) & 0x01);
+    EXPECT(radio.device.getFrequency() == 10390 - 5 * spacing);
+
+    radio.clock.advance(step * 100); // The seek does not go on
+    EXPECT(radio.device.getFrequency() == 10390 - 5 * spacing);
+    tuneStatus(radio, 0x01, resp);
+    EXPECT(!(statusByte(radio.device) & 0x01));
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"stc-after-tune", testStcAfterTune},
+        {"seek-wrap", testSeekWrap},
+        {"seek-halt", testSeekHalt},
+        {"seek-cancel", testSeekCancel},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,91 @@
+//
+// Shared pieces of the behavior tests: expectations, a simulated radio and the case runner.
+//
+// Each test program takes the name of a case (or "all") on the command line, like si4735-perf-tests.
+//
+
+#ifndef SI4735_TESTS_TEST_SUPPORT_H
+#define SI4735_TESTS_TEST_SUPPORT_H
+
+#include <cstdio>
+#include <cstring>
+
+#include <si4735.h>
+#include <SI4735Simulator.h>
+
+/**
+ * @brief Checks a condition inside a test case; a failure prints the line and clears the local "ok".
+ */
+#define EXPECT(condition) (ok = expectThat((condition), #condition, __LINE__) && ok)
+
+static inline bool expectThat(bool condition, const char *text, int line)
+{
+    if (!condition)
+        printf("  line %d: expected %s\n", line, text);
+    return condition;
+}
+
+/**
+ * @brief Simulated radio powered up in FM on 103.9 MHz, with a few FM and AM stations.
+ * @details Receiver is SI4735 or a subclass that opens protected members to the test.
+ * @details Bus is the transport the receiver talks through: the device itself, or an I2C decorator built on it
+ * @details (constructor taking the device) that watches the bus.
+ */
+template <class Receiver = SI4735, class Bus = SI4735Simulator &>
+class SimRadio
+{
+  public:
+    SI4735VirtualClock clock;
+    SI4735Simulator device;
+    Bus bus;
+    Receiver rx;
+
+    SimRadio() : device(clock), bus(device), rx(bus, clock)
+    {
+        device.addStation({9810, SIM_BAND_FM, 38, 18, 0, 0, NULL, NULL});
+        device.addStation({10390, SIM_BAND_FM, 45, 25, 0x1234, 10, "SI4735", "Test station"});
+        device.addStation({810, SIM_BAND_AM, 50, 20, 0, 0, NULL, NULL});
+        rx.setup(0, POWER_UP_FM);
+        rx.setFM(8750, 10800, 10390, 10);
+    }
+};
+
+/**
+ * @brief Test case of a test program.
+ */
+typedef struct
+{
+    const char *name;
+    bool (*test)();
+} TestCase;
+
+/**
+ * @brief Runs the case named in argv[1] (all of them without an argument or with "all") and prints the results.
+ * @return process exit code: 0 if every case passed, 1 if one failed, 2 for an unknown case.
+ */
+template <size_t N>
+static int runTests(int argc, char **argv, const TestCase (&tests)[N])
+{
+    const char *selected = (argc > 1) ? argv[1] : "all";
+    bool found = false;
+    bool ok = true;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        if (strcmp(selected, "all") != 0 && strcmp(selected, tests[i].name) != 0)
+            continue;
+        found = true;
+        bool passed = tests[i].test();
+        printf("%-24s %s\n", tests[i].name, passed ? "ok" : "FAILED");
+        if (!passed)
+            ok = false;
+    }
+    if (!found)
+    {
+        fprintf(stderr, "unknown test case: %s\n", selected);
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
+
+#endif // SI4735_TESTS_TEST_SUPPORT_H
@@ -0,0 +1,232 @@
+//
+// Behavior tests of the operation timeline (SI4735_TRACE_* spans and SI4735ChromeTrace) against SI4735Simulator.
+// Built with SI4735_INSTRUMENTATION together with its own copy of the library sources (see CMakeLists.txt).
+//
+// Usage: si4735-trace-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+#include <SI4735ChromeTrace.h>
+
+#ifndef SI4735_INSTRUMENTATION
+#error "trace-test.cpp needs SI4735_INSTRUMENTATION"
+#endif
+
+#define MAX_DEPTH 16   // Spans open at the same time
+#define MAX_NAME 32    // Span name, with the terminator
+#define MAX_LINE 256   // One trace event
+
+/**
+ * @brief Span names and nesting read back from a trace.
+ */
+struct TraceShape
+{
+    char stack[MAX_DEPTH][MAX_NAME];
+    uint16_t depth = 0;
+    uint32_t begins = 0;
+    uint32_t ends = 0;
+    bool unbalanced = false; //!< An end without a begin, or too many spans open
+    bool closed = false;     //!< The JSON document ends with "]}"
+
+    uint32_t operations = 0; //!< Spans at depth 0
+    uint32_t i2cInside = 0;  //!< i2c spans inside an operation
+    uint32_t i2cOutside = 0; //!< i2c spans with no operation open
+    uint32_t i2cParents = 0; //!< Spans begun while an i2c span was open (must be none)
+    uint32_t stcInside = 0;  //!< stc spans directly inside watched
+
+    const char *watched = NULL; //!< Operation whose spans are counted in inWatched
+    uint32_t watchedCount = 0;
+    uint32_t inWatched = 0;
+
+    void begin(const char *name)
+    {
+        begins++;
+        if (depth >= MAX_DEPTH)
+        {
+            unbalanced = true;
+            return;
+        }
+        if (depth > 0 && strncmp(stack[depth - 1], "i2c", 3) == 0)
+            i2cParents++;
+        if (depth == 0)
+        {
+            operations++;
+            if (watched != NULL && strcmp(name, watched) == 0)
+                watchedCount++;
+        }
+        else if (watched != NULL && strcmp(stack[0], watched) == 0)
+        {
+            inWatched++;
+            if (depth == 1 && strcmp(name, "stc") == 0)
+                stcInside++;
+        }
+        if (strncmp(name, "i2c", 3) == 0)
+        {
+            if (depth == 0)
+                i2cOutside++;
+            else
+                i2cInside++;
+        }
+        snprintf(stack[depth++], MAX_NAME, "%s", name);
+    }
+
+    void end()
+    {
+        ends++;
+        if (depth == 0)
+            unbalanced = true;
+        else
+            depth--;
+    }
+
+    /**
+     * @brief Reads the events of a trace file, one per line, and follows their nesting.
+     */
+    void parse(FILE *in)
+    {
+        char line[MAX_LINE];
+        char name[MAX_NAME];
+
+        rewind(in);
+        while (fgets(line, sizeof line, in) != NULL)
+        {
+            const char *phase = strstr(line, "\"ph\":\"");
+            const char *field = strstr(line, "\"name\":\"");
+
+            if (strncmp(line, "]}", 2) == 0)
+                closed = true;
+            if (phase == NULL)
+                continue;
+            if (phase[6] == 'E')
+                end();
+            else if (phase[6] == 'B' && field != NULL && sscanf(field + 8, "%31[^\"]", name) == 1)
+                begin(name);
+        }
+    }
+};
+
+/**
+ * @brief Radio on SimRadio's stations whose transport writes a Chrome trace to a temporary file.
+ */
+class TracedRadio
+{
+  public:
+    SI4735VirtualClock clock;
+    SI4735Simulator device;
+    FILE *out;
+    SI4735ChromeTrace trace;
+    SI4735 rx;
+
+    TracedRadio() : device(clock), out(tmpfile()), trace(device, out, &clock), rx(trace, clock)
+    {
+        device.addStation({9810, SIM_BAND_FM, 38, 18, 0, 0, NULL, NULL});
+        device.addStation({10390, SIM_BAND_FM, 45, 25, 0x1234, 10, "SI4735", "Test station"});
+        rx.setup(0, POWER_UP_FM);
+        rx.setFM(8750, 10800, 10390, 10);
+    }
+
+    ~TracedRadio()
+    {
+        trace.finish();
+        fclose(out);
+    }
+};
+
+/**
+ * @brief setFrequency and seekStation are operation spans with the STCINT wait and their bus transfers nested inside.
+ */
+static bool testOperationSpans()
+{
+    TracedRadio radio;
+    TraceShape shape;
+    bool ok = true;
+
+    radio.rx.setTracer(&radio.trace);
+    radio.rx.setFrequency(9810);
+    radio.rx.seekStation(1, 1);
+    EXPECT(radio.rx.getCurrentFrequency() == 10390);
+    radio.trace.finish();
+
+    shape.watched = "setFrequency";
+    shape.parse(radio.out);
+    EXPECT(shape.closed);
+    EXPECT(!shape.unbalanced && shape.depth == 0);
+    EXPECT(shape.begins == shape.ends);
+    EXPECT(shape.begins == radio.trace.getEvents() / 2);
+    EXPECT(shape.watchedCount == 1);
+    EXPECT(shape.stcInside == 1);
+    EXPECT(shape.inWatched > 2); // The FM_TUNE_FREQ write, its reads and the STCINT wait
+    EXPECT(shape.i2cParents == 0);
+    EXPECT(shape.i2cOutside > 0); // setup and setFM ran before the tracer was set
+
+    shape = TraceShape();
+    shape.watched = "seekStation";
+    shape.parse(radio.out);
+    EXPECT(shape.watchedCount == 1);
+    EXPECT(shape.stcInside == 1);
+    EXPECT(shape.inWatched > 2);
+    return ok;
+}
+
+/**
+ * @brief Every bus transfer made by an operation is a span inside it; without a tracer only the transfers are written.
+ */
+static bool testI2cSpans()
+{
+    TracedRadio radio;
+    TraceShape shape;
+    uint32_t events;
+    bool ok = true;
+
+    radio.rx.setFrequency(9810); // Not traced: i2c spans only
+    events = radio.trace.getEvents();
+    radio.rx.setTracer(&radio.trace);
+    radio.rx.setFrequency(10390);
+    radio.rx.setTracer(NULL);
+    radio.rx.setFrequency(9810);
+    radio.trace.finish();
+    radio.rx.setFrequency(10390); // After finish: dropped
+    EXPECT(radio.trace.getEvents() > events);
+
+    shape.parse(radio.out);
+    EXPECT(shape.closed);
+    EXPECT(!shape.unbalanced && shape.depth == 0);
+    EXPECT(shape.operations == shape.i2cOutside + 1); // One setFrequency span, every other top span is a transfer
+    EXPECT(shape.i2cInside > 0);
+    EXPECT(shape.i2cParents == 0);
+    EXPECT(shape.begins == radio.trace.getEvents() / 2);
+    return ok;
+}
+
+/**
+ * @brief finish ends the spans still open and closes the document once.
+ */
+static bool testFinishOpen()
+{
+    TracedRadio radio;
+    TraceShape shape;
+    bool ok = true;
+
+    radio.trace.begin("outer", TRACE_OPERATION, 0);
+    radio.trace.begin("inner", TRACE_SLEEP, 0x20);
+    radio.trace.finish();
+    radio.trace.end(); // Nothing open any more
+    radio.trace.finish();
+
+    shape.parse(radio.out);
+    EXPECT(shape.closed);
+    EXPECT(!shape.unbalanced && shape.depth == 0);
+    EXPECT(shape.begins == shape.ends);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"operation-spans", testOperationSpans},
+        {"i2c-spans", testI2cSpans},
+        {"finish-open", testFinishOpen},
+    };
+
+    return runTests(argc, argv, tests);
+}
@@ -0,0 +1,140 @@
+//
+// Behavior tests of the response views (si47x_rds_view) and of the RDS getters that decode through them.
+//
+// Usage: si4735-view-tests <case>   (see the table in main, or all)
+//
+
+#include "test-support.h"
+
+/**
+ * @brief SI4735 whose RDS status can be loaded with a response built by the test.
+ */
+class RdsReceiver : public SI4735
+{
+  public:
+    RdsReceiver(I2C &i2c, Clock &clock) : SI4735(i2c, clock) {}
+
+    inline void load(const uint8_t *response) { memcpy(currentRdsStatus.raw, response, sizeof currentRdsStatus.raw); }
+};
+
+/**
+ * @brief FM_RDS_STATUS response carrying a group 4A (clock time and date) with PI piCode.
+ * @details Block B: group type, version, TP, PTY and the 2 most significant bits of the MJD. Block C: the 15 other MJD
+ * @details bits and the most significant bit of the hour. Block D: hour, minute, offset sense and offset.
+ */
+static void buildGroup4A(uint8_t *raw, uint16_t piCode, uint32_t mjd, uint8_t hour, uint8_t minute, uint8_t sense, uint8_t offset)
+{
+    uint16_t blockB = (4 << 12) | (1 << 10) | (10 << 5) | (uint16_t)(mjd >> 15); // TP = 1, PTY = 10
+    uint16_t blockC = (uint16_t)((mjd & 0x7FFF) << 1) | (hour >> 4);
+    uint16_t blockD = (uint16_t)((hour & 0x0F) << 12) | (minute << 6) | (sense << 5) | offset;
+
+    raw[0] = 0x84; // CTS and RDSINT
+    raw[1] = 0x31; // New block A and B, received
+    raw[2] = 0x01; // Synchronized
+    raw[3] = 2;
+    raw[4] = piCode >> 8;
+    raw[5] = piCode & 0xFF;
+    raw[6] = blockB >> 8;
+    raw[7] = blockB & 0xFF;
+    raw[8] = blockC >> 8;
+    raw[9] = blockC & 0xFF;
+    raw[10] = blockD >> 8;
+    raw[11] = blockD & 0xFF;
+    raw[12] = 0x1B; // Errors: A = 0, B = 1, C = 2, D = 3
+}
+
+/**
+ * @brief The view decodes a group 4A response byte by byte: both bytes of block A, block B and the date and time fields.
+ */
+static bool testGroup4A()
+{
+    // PI 0xC201; 2024-03-15 (MJD 60384) 14:35 UTC, offset -1:30
+    static const uint8_t raw[13] = {0x84, 0x31, 0x01, 0x02, 0xC2, 0x01, 0x45, 0x41, 0xD7, 0xC0, 0xE8, 0xE3, 0x1B};
+    uint8_t built[13];
+    si47x_rds_view view(raw);
+    bool ok = true;
+
+    EXPECT(view.received() && view.newBlockA() && view.newBlockB() && !view.syncFound());
+    EXPECT(view.sync() && !view.groupLost() && view.fifoUsed() == 2);
+    EXPECT(view.blockA() == 0xC201); // The whole PI code, not only BLOCKAL
+    EXPECT(view.blockB() == 0x4541 && view.blockC() == 0xD7C0 && view.blockD() == 0xE8E3);
+    EXPECT(view.blockErrors(0) == 0 && view.blockErrors(1) == 1 && view.blockErrors(2) == 2 && view.blockErrors(3) == 3);
+
+    EXPECT(view.groupType() == 4 && view.versionCode() == 0);
+    EXPECT(view.trafficProgramCode() == 1 && view.programType() == 10);
+    EXPECT(view.mjd() == 60384);
+    EXPECT(view.hour() == 14 && view.minute() == 35);
+    EXPECT(view.offsetSense() == 1 && view.offset() == 3);
+
+    buildGroup4A(built, 0xC201, 60384, 14, 35, 1, 3);
+    EXPECT(memcmp(built, raw, sizeof raw) == 0);
+    return ok;
+}
+
+/**
+ * @brief Fields that cross a block boundary: the MJD bit 16 (block B) and the hour bit 4 (block C).
+ */
+static bool testBoundaryBits()
+{
+    uint8_t raw[13];
+    bool ok = true;
+
+    buildGroup4A(raw, 0x1234, 0x1ABCD, 23, 59, 0, 31);
+    si47x_rds_view view(raw);
+    EXPECT(view.mjd() == 0x1ABCD);
+    EXPECT(view.hour() == 23 && view.minute() == 59);
+    EXPECT(view.offsetSense() == 0 && view.offset() == 31);
+    EXPECT(view.programType() == 10 && view.groupType() == 4);
+
+    buildGroup4A(raw, 0x1234, 0x08000, 16, 0, 0, 0); // Only MJD bit 15 and hour bit 4
+    EXPECT(view.mjd() == 0x08000 && view.hour() == 16 && view.minute() == 0);
+    return ok;
+}
+
+/**
+ * @brief getRdsPI returns both bytes of block A (0 without a new block A); getRdsDateTime converts the group 4A to local
+ * @brief time and date.
+ */
+static bool testRdsGetters()
+{
+    SimRadio<RdsReceiver> radio;
+    uint8_t raw[13];
+    uint16_t year, month, day, hour, minute;
+    bool ok = true;
+
+    radio.rx.setRdsConfig(1, 2, 2, 2, 2);
+    radio.clock.wait(90); // One group in the FIFO
+    radio.rx.getRdsStatus();
+    EXPECT(radio.rx.getRdsReceived());
+    EXPECT(radio.rx.getRdsPI() == 0x1234); // PI of the station on 103.9 MHz
+
+    buildGroup4A(raw, 0xC201, 60384, 14, 35, 1, 3);
+    radio.rx.load(raw);
+    EXPECT(radio.rx.getRdsPI() == 0xC201);
+    EXPECT(radio.rx.getRdsGroupType() == 4);
+    EXPECT(radio.rx.getRdsDateTime(&year, &month, &day, &hour, &minute));
+    EXPECT(year == 2024 && month == 3 && day == 15);
+    EXPECT(hour == 13 && minute == 5); // 14:35 UTC - 1:30
+
+    buildGroup4A(raw, 0xC201, 60384, 23, 30, 0, 2); // 23:30 UTC + 1:00: next day
+    radio.rx.load(raw);
+    EXPECT(radio.rx.getRdsDateTime(&year, &month, &day, &hour, &minute));
+    EXPECT(year == 2024 && month == 3 && day == 16);
+    EXPECT(hour == 0 && minute == 30);
+
+    raw[1] = 0x21; // No new block A
+    radio.rx.load(raw);
+    EXPECT(radio.rx.getRdsPI() == 0);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    static const TestCase tests[] = {
+        {"rds-group-4a", testGroup4A},
+        {"rds-boundary-bits", testBoundaryBits},
+        {"rds-getters", testRdsGetters},
+    };
+
+    return runTests(argc, argv, tests);
+}